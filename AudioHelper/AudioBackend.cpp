@@ -0,0 +1,159 @@
+/**
+ * @file AudioBackend.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 20:14:32
+ * @brief 音频后端：设备枚举与默认设备切换，设备列表缓存到收到变化通知为止
+ */
+
+#include "AudioBackend.h"
+
+QAtomicPointer<AudioBackend> AudioBackend::sInstance;
+
+AudioBackend::AudioBackend(QObject *parent)
+    : QObject(parent)
+    , mDevicesValid(false)
+    , mDefaultValid(false)
+{
+}
+
+AudioBackend *AudioBackend::instance()
+{
+    AudioBackend *backend = sInstance.loadAcquire();
+    if (backend != nullptr)
+        return backend;
+
+    // 局部静态变量的初始化是线程安全的；后端有意不析构，退出时各线程的COM可能已经释放
+    static AudioBackend *platform = createPlatformBackend();
+    return platform;
+}
+
+void AudioBackend::setInstance(AudioBackend *backend)
+{
+    sInstance.storeRelease(backend);
+}
+
+AudioDeviceList AudioBackend::outputDevices()
+{
+    QMutexLocker locker(&mMutex);
+    if (!mDevicesValid)
+    {
+        AudioDeviceList devices;
+        if (!enumerateDevices(&devices))
+            return devices;
+        mDevices = devices;
+        mDevicesValid = true;
+    }
+    return mDevices;
+}
+
+QString AudioBackend::defaultOutputDevice()
+{
+    QMutexLocker locker(&mMutex);
+    if (!mDefaultValid)
+    {
+        QString deviceId;
+        if (!queryDefaultDevice(&deviceId))
+            return QString();
+        mDefaultDevice = deviceId;
+        mDefaultValid = true;
+    }
+    return mDefaultDevice;
+}
+
+bool AudioBackend::setDefaultOutputDevice(const QString &deviceId)
+{
+    if (!applyDefaultDevice(deviceId))
+        return false;
+
+    QMutexLocker locker(&mMutex);
+    mDefaultDevice = deviceId;
+    mDefaultValid = true;
+    return true;
+}
+
+void AudioBackend::invalidateDevices()
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mDevicesValid = false;
+    }
+    emit devicesChanged();
+}
+
+void AudioBackend::updateDefaultDevice(const QString &deviceId)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mDefaultDevice = deviceId;
+        mDefaultValid = !deviceId.isEmpty();
+    }
+    emit defaultDeviceChanged(deviceId);
+}
+
+
+FakeAudioBackend::FakeAudioBackend(const AudioDeviceList &devices, QObject *parent)
+    : AudioBackend(parent)
+    , mFakeDevices(devices)
+    , mFailing(false)
+    , mEnumerateCount(0)
+    , mQueryCount(0)
+{
+    if (!devices.isEmpty())
+        mFakeDefault = devices.first();
+}
+
+void FakeAudioBackend::setDevices(const AudioDeviceList &devices)
+{
+    mFakeDevices = devices;
+    invalidateDevices();
+}
+
+void FakeAudioBackend::setSystemDefault(const QString &deviceId)
+{
+    mFakeDefault = deviceId;
+    updateDefaultDevice(deviceId);
+}
+
+void FakeAudioBackend::setFailing(bool failing)
+{
+    mFailing = failing;
+}
+
+int FakeAudioBackend::enumerateCount() const
+{
+    return mEnumerateCount;
+}
+
+int FakeAudioBackend::queryCount() const
+{
+    return mQueryCount;
+}
+
+QStringList FakeAudioBackend::appliedDevices() const
+{
+    return mAppliedDevices;
+}
+
+bool FakeAudioBackend::enumerateDevices(AudioDeviceList *audioDeviceList)
+{
+    mEnumerateCount++;
+    *audioDeviceList = mFakeDevices;
+    return true;
+}
+
+bool FakeAudioBackend::queryDefaultDevice(QString *deviceId)
+{
+    mQueryCount++;
+    *deviceId = mFakeDefault;
+    return !mFakeDefault.isEmpty();
+}
+
+bool FakeAudioBackend::applyDefaultDevice(const QString &deviceId)
+{
+    if (mFailing || !mFakeDevices.values().contains(deviceId))
+        return false;
+
+    mAppliedDevices.append(deviceId);
+    mFakeDefault = deviceId;
+    return true;
+}
@@ -0,0 +1,92 @@
+#ifndef AUDIOBACKEND_H
+#define AUDIOBACKEND_H
+
+/**
+ * @file AudioBackend.h
+ * @author Asteri5m
+ * @date 2026-10-16 20:14:32
+ * @brief 音频后端：设备枚举与默认设备切换，设备列表缓存到收到变化通知为止；Windows 实现见 WinAudioBackend.h
+ */
+
+#include <QObject>
+#include <QMap>
+#include <QMutex>
+#include <QStringList>
+#include <QAtomicPointer>
+
+//音频设备---key:friendname,value:deviceId
+typedef QMap<QString, QString> AudioDeviceList;
+
+// 后端基类只维护缓存，具体的枚举与切换由派生类实现
+class AudioBackend : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AudioBackend(QObject *parent = nullptr);
+
+    // 全局使用的后端，未注入时首次调用创建平台默认实现，可在任意线程调用
+    static AudioBackend *instance();
+    // 注入替代的后端（如测试用的假后端），传入nullptr恢复平台实现；不转移所有权，须在使用前调用
+    static void setInstance(AudioBackend *backend);
+
+    AudioDeviceList outputDevices();
+    QString defaultOutputDevice();
+    bool setDefaultOutputDevice(const QString &deviceId);
+
+    // 由设备变化通知调用，可在任意线程
+    void invalidateDevices();
+    void updateDefaultDevice(const QString &deviceId);
+
+signals:
+    void devicesChanged();
+    void defaultDeviceChanged(const QString &deviceId);
+
+protected:
+    virtual bool enumerateDevices(AudioDeviceList *audioDeviceList) = 0;
+    virtual bool queryDefaultDevice(QString *deviceId) = 0;
+    virtual bool applyDefaultDevice(const QString &deviceId) = 0;
+
+private:
+    QMutex mMutex;
+    AudioDeviceList mDevices;
+    QString mDefaultDevice;
+    bool mDevicesValid;
+    bool mDefaultValid;
+
+    static QAtomicPointer<AudioBackend> sInstance;
+
+    // 平台默认实现，由平台后端的源文件定义
+    static AudioBackend *createPlatformBackend();
+};
+
+// 内存中的假后端，用于脱离真实设备验证缓存与切换逻辑
+class FakeAudioBackend : public AudioBackend
+{
+    Q_OBJECT
+public:
+    explicit FakeAudioBackend(const AudioDeviceList &devices = AudioDeviceList(), QObject *parent = nullptr);
+
+    // 模拟设备插拔与系统侧的默认设备变化，会像真实通知一样使缓存失效
+    void setDevices(const AudioDeviceList &devices);
+    void setSystemDefault(const QString &deviceId);
+    void setFailing(bool failing);
+
+    int enumerateCount() const;
+    int queryCount() const;
+    QStringList appliedDevices() const;
+
+protected:
+    bool enumerateDevices(AudioDeviceList *audioDeviceList) override;
+    bool queryDefaultDevice(QString *deviceId) override;
+    bool applyDefaultDevice(const QString &deviceId) override;
+
+private:
+    AudioDeviceList mFakeDevices;
+    QString mFakeDefault;
+    bool mFailing;
+    int mEnumerateCount;
+    int mQueryCount;
+    QStringList mAppliedDevices;
+};
+
+#endif // AUDIOBACKEND_H
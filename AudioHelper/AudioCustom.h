@@ -13,6 +13,7 @@
 #include <QLabel>
 #include <QResizeEvent>
 #include <QPainter>
+#include "AudioTypes.h"
 
 #define TAG_DEFAULT_WIDTH 120
 
@@ -166,31 +167,6 @@ inline QMap<QString, TagLabel::Theme> TagTheme =  {
     };
 
 
-struct TaskInfo {
-    QString name;
-    QString path;
-    qint64 survivalTime;
-};
-
-struct AudioDeviceInfo {
-    QString name;
-    QString id;
-};
-
-struct TypeInfo
-{
-    QString type;
-    QString tag;
-};
-
-struct RelatedItem {
-    uint id;            // 数据库id
-    TaskInfo taskInfo;
-    TypeInfo typeInfo;
-    AudioDeviceInfo audioDeviceInfo;
-};
-
-typedef QList<RelatedItem> RelatedList;
 
 #include <QStyledItemDelegate>
 #include <QPainter>
@@ -6,188 +6,328 @@
  */
 
 #include "AudioDatabase.h"
-#include "CustomWidget.h"
+#include "Metrics.h"
+#include "Storage.h"
+#include <QDir>
 
-AudioDatabase::AudioDatabase(QObject *parent)
-    : QObject(parent)
+static MetricHistogram &queryLatency()
 {
-    QDir dir("data");
-    if (!dir.exists()) dir.mkpath(".");
-    QString dbName("AudioHelper.db");
-    if (QSqlDatabase::contains(dbName))
-        mdb = QSqlDatabase::database(dbName);
-    else
-    {
-        mdb = QSqlDatabase::addDatabase("QSQLITE", dbName);
-        mdb.setDatabaseName(dir.filePath(dbName));
-    }
+    static MetricHistogram &histogram = Metrics::histogram("audio_db_query_us", "AudioDatabase query latency in microseconds");
+    return histogram;
+}
 
-    if (!mdb.open()) {
-        qCritical() << "Could not connect to database.";
-        return;
-    }
+static const char *INSERT_ITEM_SQL = "INSERT INTO audio_related (taskName, taskPath, type, tag, deviceName, deviceId) "
+                                    "VALUES (:taskName, :taskPath, :type, :tag, :deviceName, :deviceId)";
+static const char *UPDATE_ITEM_SQL = "UPDATE audio_related SET "
+                                    "taskName = :taskName, "
+                                    "taskPath = :taskPath, "
+                                    "type = :type, "
+                                    "tag = :tag, "
+                                    "deviceName = :deviceName, "
+                                    "deviceId = :deviceId "
+                                    "WHERE id = :id";
+// 按位置读取的列顺序
+static const char *SELECT_ITEMS_SQL = "SELECT id, taskName, taskPath, type, tag, deviceName, deviceId FROM audio_related";
+
+// type/tag 在库中以整数保存，0 表示空值或未知
+static const QStringList &typeNames()
+{
+    static const QStringList names = {QString(), "进程", "窗口", "文件夹", "文件"};
+    return names;
+}
 
+static const QStringList &tagNames()
+{
+    static const QStringList names = {QString(), "游戏", "影音"};
+    return names;
+}
+
+static int toCode(const QStringList &names, const QString &text)
+{
+    return text.isEmpty() ? 0 : qMax(0, names.indexOf(text));
+}
+
+static QString fromCode(const QStringList &names, int code)
+{
+    return names.value(code);
+}
+
+// 结构版本，只能在末尾追加
+static const QList<QStringList> &migrations()
+{
+    static const QList<QStringList> steps = {
+        // 1: 关联任务（type/tag 为整数编码）与配置表，按路径查重、按设备查找建立索引
+        {
+            "CREATE TABLE IF NOT EXISTS audio_related ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "taskName TEXT, "
+            "taskPath TEXT, "
+            "type INTEGER NOT NULL DEFAULT 0, "
+            "tag INTEGER NOT NULL DEFAULT 0, "
+            "deviceName TEXT, "
+            "deviceId TEXT)",
+            "CREATE INDEX IF NOT EXISTS idx_audio_related_taskPath ON audio_related (taskPath)",
+            "CREATE INDEX IF NOT EXISTS idx_audio_related_deviceId ON audio_related (deviceId)",
+            "CREATE TABLE IF NOT EXISTS audio_config ("
+            "key TEXT PRIMARY KEY,"
+            "value TEXT)",
+        },
+    };
+    return steps;
+}
+
+// 早期版本使用独立的 data/AudioHelper.db，type/tag 可能是文字（旧结构）或整数
+static const QStringList &legacyImports()
+{
+    static const QStringList imports = {
+        "INSERT INTO audio_related (id, taskName, taskPath, type, tag, deviceName, deviceId) "
+        "SELECT id, taskName, taskPath, "
+        "CASE type WHEN '进程' THEN 1 WHEN '窗口' THEN 2 WHEN '文件夹' THEN 3 WHEN '文件' THEN 4 "
+        "ELSE COALESCE(CAST(type AS INTEGER), 0) END, "
+        "CASE tag WHEN '游戏' THEN 1 WHEN '影音' THEN 2 ELSE COALESCE(CAST(tag AS INTEGER), 0) END, "
+        "deviceName, deviceId FROM legacy.RelatedItems",
+        "INSERT OR REPLACE INTO audio_config (key, value) SELECT key, value FROM legacy.config",
+    };
+    return imports;
+}
+
+AudioDatabase::AudioDatabase(QObject *parent)
+    : QObject(parent)
+    , mConfigStore(nullptr)
+{
     createTable();
+    mConfigStore = new ConfigStore("audio_config");
 }
 
 AudioDatabase::~AudioDatabase()
 {
-    mdb.close();
+    // 先提交未写回的配置，语句在数据库线程上释放，排在之前投递的写入之后
+    delete mConfigStore;
+    Storage::instance().execute([this](QSqlDatabase &) {
+        qDeleteAll(mStatements);
+        mStatements.clear();
+    });
 }
 
 bool AudioDatabase::createTable()
 {
-    QSqlQuery query(mdb);
-    QString createTableQuery = "CREATE TABLE IF NOT EXISTS RelatedItems ("
-                               "id INTEGER PRIMARY KEY AUTOINCREMENT, "
-                               "taskName TEXT, "
-                               "taskPath TEXT, "
-                               "type TEXT, "
-                               "tag TEXT, "
-                               "deviceName TEXT, "
-                               "deviceId TEXT)";
-    if (!query.exec(createTableQuery)) {
-        qCritical() << "create table (RelatedItems) failed:" << query.lastError().text()
-                    << ",Error code:" << query.lastError().nativeErrorCode();
-        return false;
-    }
+    return Storage::instance().migrate("audio", migrations(), QDir("data").filePath("AudioHelper.db"), legacyImports());
+}
 
-    createTableQuery = "CREATE TABLE IF NOT EXISTS config ("
-                       "key TEXT PRIMARY KEY,"
-                       "value TEXT)";
+// 以下带 QSqlDatabase 参数的函数只在数据库线程调用
+QSqlQuery *AudioDatabase::statement(QSqlDatabase &db, const QString &sql)
+{
+    QSqlQuery *query = mStatements.value(sql, nullptr);
+    if (query != nullptr)
+        return query;
 
-    if (!query.exec(createTableQuery)) {
-        qCritical() << "create table (config) failed:" << query.lastError().text()
-                    << ",Error code:" << query.lastError().nativeErrorCode();
-        return false;
+    query = new QSqlQuery(db);
+    // 结果都只顺序读取一遍，驱动不必缓存已读的行；需在 prepare 前设置
+    query->setForwardOnly(true);
+    if (!query->prepare(sql)) {
+        setLastError(query->lastError().text());
+        qWarning() << "Failed to prepare statement:" << query->lastError().text();
+        delete query;
+        return nullptr;
     }
+    mStatements.insert(sql, query);
+    return query;
+}
+
+void AudioDatabase::bindItem(QSqlQuery *query, const RelatedItem &item)
+{
+    query->bindValue(":taskName", item.taskInfo.name);
+    query->bindValue(":taskPath", item.taskInfo.path);
+    query->bindValue(":type", toCode(typeNames(), item.typeInfo.type));
+    query->bindValue(":tag", toCode(tagNames(), item.typeInfo.tag));
+    query->bindValue(":deviceName", item.audioDeviceInfo.name);
+    query->bindValue(":deviceId", item.audioDeviceInfo.id);
+}
+
+bool AudioDatabase::execItem(QSqlQuery *query, const char *action)
+{
+    if (query->exec())
+        return true;
 
-    return true;
+    setLastError(query->lastError().text());
+    qWarning() << "Failed to" << action << "item: " << query->lastError().text()
+               << "Error code:" << query->lastError().nativeErrorCode();
+    return false;
+}
+
+bool AudioDatabase::commit(QSqlDatabase &db)
+{
+    if (db.commit())
+        return true;
+
+    setLastError(db.lastError().text());
+    db.rollback();
+    return false;
+}
+
+void AudioDatabase::setLastError(const QString &error)
+{
+    QMutexLocker locker(&mErrorMutex);
+    mLastError = error;
 }
 
 bool AudioDatabase::insertItem(RelatedItem &item)
 {
-    QSqlQuery query(mdb);
-    query.prepare("INSERT INTO RelatedItems (taskName, taskPath, type, tag, deviceName, deviceId) "
-                  "VALUES (:taskName, :taskPath, :type, :tag, :deviceName, :deviceId)");
-    query.bindValue(":taskName", item.taskInfo.name);
-    query.bindValue(":taskPath", item.taskInfo.path);
-    query.bindValue(":type", item.typeInfo.type);
-    query.bindValue(":tag", item.typeInfo.tag);
-    query.bindValue(":deviceName", item.audioDeviceInfo.name);
-    query.bindValue(":deviceId", item.audioDeviceInfo.id);
-
-    if (!query.exec()) {
-        qWarning() << "Failed to insert item: " << query.lastError().text()
-                   << "Error code:" << query.lastError().nativeErrorCode();
-        return false;
-    }
+    // 需要立即取得自增ID，等待数据库线程完成
+    return Storage::instance().call<bool>([this, &item](QSqlDatabase &db) {
+        MetricTimer timer(queryLatency());
+        QSqlQuery *query = statement(db, INSERT_ITEM_SQL);
+        if (query == nullptr)
+            return false;
 
-    // 获取数据库自增ID并将其返回给 RelatedItem
-    item.id = query.lastInsertId().toUInt();
+        bindItem(query, item);
+        if (!execItem(query, "insert"))
+            return false;
 
-    return true;
+        // 获取数据库自增ID并将其返回给 RelatedItem
+        item.id = query->lastInsertId().toUInt();
+        return true;
+    });
 }
 
 bool AudioDatabase::updateItem(const RelatedItem &item)
 {
-    QSqlQuery query(mdb);
-    query.prepare("UPDATE RelatedItems SET "
-                  "taskName = :taskName, "
-                  "taskPath = :taskPath, "
-                  "type = :type, "
-                  "tag = :tag, "
-                  "deviceName = :deviceName, "
-                  "deviceId = :deviceId "
-                  "WHERE id = :id");
-    query.bindValue(":taskName", item.taskInfo.name);
-    query.bindValue(":taskPath", item.taskInfo.path);
-    query.bindValue(":type", item.typeInfo.type);
-    query.bindValue(":tag", item.typeInfo.tag);
-    query.bindValue(":deviceName", item.audioDeviceInfo.name);
-    query.bindValue(":deviceId", item.audioDeviceInfo.id);
-    query.bindValue(":id", item.id);
-
-    return query.exec();
+    // 单行操作由界面直接触发，等待结果，失败时界面保持原样
+    return Storage::instance().call<bool>([this, &item](QSqlDatabase &db) {
+        MetricTimer timer(queryLatency());
+        QSqlQuery *query = statement(db, UPDATE_ITEM_SQL);
+        if (query == nullptr)
+            return false;
+
+        bindItem(query, item);
+        query->bindValue(":id", item.id);
+        return execItem(query, "update");
+    });
+}
+
+bool AudioDatabase::insertItems(RelatedList *items)
+{
+    return Storage::instance().call<bool>([this, items](QSqlDatabase &db) {
+        MetricTimer timer(queryLatency());
+        QSqlQuery *query = statement(db, INSERT_ITEM_SQL);
+        if (query == nullptr || !db.transaction())
+            return false;
+
+        QList<uint> ids;
+        ids.reserve(items->size());
+        for (const RelatedItem &item : std::as_const(*items))
+        {
+            bindItem(query, item);
+            if (!execItem(query, "insert")) {
+                db.rollback();
+                return false;
+            }
+            ids.append(query->lastInsertId().toUInt());
+        }
+
+        if (!commit(db))
+            return false;
+
+        // 提交成功后才回填ID，失败时列表保持原样
+        for (int i = 0; i < ids.size(); ++i)
+            (*items)[i].id = ids.at(i);
+        return true;
+    });
+}
+
+bool AudioDatabase::updateItems(const RelatedList &items)
+{
+    return Storage::instance().call<bool>([this, &items](QSqlDatabase &db) {
+        MetricTimer timer(queryLatency());
+        QSqlQuery *query = statement(db, UPDATE_ITEM_SQL);
+        if (query == nullptr || !db.transaction())
+            return false;
+
+        for (const RelatedItem &item : items)
+        {
+            bindItem(query, item);
+            query->bindValue(":id", item.id);
+            if (!execItem(query, "update")) {
+                db.rollback();
+                return false;
+            }
+        }
+        return commit(db);
+    });
 }
 
 bool AudioDatabase::deleteItem(int id)
 {
-    QSqlQuery query(mdb);
-    query.prepare("DELETE FROM RelatedItems WHERE id = :id");
-    query.bindValue(":id", id);
+    return Storage::instance().call<bool>([this, id](QSqlDatabase &db) {
+        MetricTimer timer(queryLatency());
+        QSqlQuery *query = statement(db, "DELETE FROM audio_related WHERE id = :id");
+        if (query == nullptr)
+            return false;
 
-    return query.exec();
+        query->bindValue(":id", id);
+        return execItem(query, "delete");
+    });
 }
 
 void AudioDatabase::queryItems(const QString &key, const QString &value, RelatedList* relatedList)
 {
-    QSqlQuery query(mdb);
+    // 列名不能绑定参数，只接受已知的列，避免拼接任意文本
+    static const QStringList filterColumns = {"taskName", "taskPath", "deviceName", "deviceId"};
 
     // 根据是否有查询条件来决定 SQL 语句
-    if (key.isEmpty() || value.isEmpty()) {
-        query.prepare("SELECT * FROM RelatedItems");
-    } else {
-        query.prepare("SELECT * FROM RelatedItems WHERE " + key + " = :value");
-        query.bindValue(":value", value);
-    }
-
-    if (!query.exec()) {
-        qWarning() << "Error: " << query.lastError().text()
-                   << ",Error code:" << query.lastError().nativeErrorCode();
+    bool filtered = !key.isEmpty() && !value.isEmpty();
+    if (filtered && !filterColumns.contains(key)) {
+        setLastError("Unsupported query column: " + key);
+        qWarning() << "Unsupported query column:" << key;
         return;
     }
 
-    while (query.next()) {
-        RelatedItem item;
-        item.taskInfo.name = query.value("taskName").toString();
-        item.taskInfo.path = query.value("taskPath").toString();
-        item.typeInfo.type = query.value("type").toString();
-        item.typeInfo.tag = query.value("tag").toString();
-        item.audioDeviceInfo.name = query.value("deviceName").toString();
-        item.audioDeviceInfo.id = query.value("deviceId").toString();
-        item.id = query.value("id").toUInt();
-        relatedList->append(item);
-    }
-    return;
+    QString sql = filtered ? QString(SELECT_ITEMS_SQL) + " WHERE " + key + " = :value" : QString(SELECT_ITEMS_SQL);
+    Storage::instance().execute([&](QSqlDatabase &db) {
+        MetricTimer timer(queryLatency());
+        QSqlQuery *query = statement(db, sql);
+        if (query == nullptr)
+            return;
+        if (filtered)
+            query->bindValue(":value", value);
+
+        if (!query->exec()) {
+            setLastError(query->lastError().text());
+            qWarning() << "Error: " << query->lastError().text()
+                       << ",Error code:" << query->lastError().nativeErrorCode();
+            return;
+        }
+
+        while (query->next()) {
+            RelatedItem item;
+            item.id = query->value(0).toUInt();
+            item.taskInfo.name = query->value(1).toString();
+            item.taskInfo.path = query->value(2).toString();
+            item.typeInfo.type = fromCode(typeNames(), query->value(3).toInt());
+            item.typeInfo.tag = fromCode(tagNames(), query->value(4).toInt());
+            item.audioDeviceInfo.name = query->value(5).toString();
+            item.audioDeviceInfo.id = query->value(6).toString();
+            relatedList->append(item);
+        }
+        // 语句会被复用，读完后释放结果集，避免长期持有读事务
+        query->finish();
+    });
 }
 
 bool AudioDatabase::saveConfig(const QString &key, const QString &value)
 {
-    QSqlQuery query(mdb);
-    query.prepare("INSERT OR REPLACE INTO config (key, value) VALUES (:key, :value)");
-    query.bindValue(":key", key);
-    query.bindValue(":value", value);
-
-    return query.exec();
+    return mConfigStore->setValue(key, value);
 }
 
 QString AudioDatabase::queryConfig(const QString &key, const QString &defaultValue)
 {
-    QSqlQuery query(mdb);
-    query.prepare("SELECT value FROM config WHERE key = :key");
-    query.bindValue(":key", key);
-
-    if (!query.exec()) {
-        qCritical() << "Load config failed:" << query.lastError().text()
-                    << ",Error code:" << query.lastError().nativeErrorCode();
-        return defaultValue;
-    }
-
-    if (!query.next()) {
-        qDebug() << "Load config failed: select result is null of " + key;
-        if (!defaultValue.isNull())
-            saveConfig(key, defaultValue);
-        return defaultValue;
-    }
-
-    return query.value(0).toString();
+    return mConfigStore->value(key, defaultValue);
 }
 
 
 
 QString AudioDatabase::lastError()
 {
-    QSqlQuery query(mdb);
-    return query.lastError().text();
+    QMutexLocker locker(&mErrorMutex);
+    return mLastError;
 }
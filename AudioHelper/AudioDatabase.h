@@ -13,9 +13,13 @@
 #include <QSqlError>
 #include <QVariant>
 #include <QList>
+#include <QHash>
+#include <QMutex>
 #include <QDebug>
-#include "AudioCustom.h"
+#include "AudioTypes.h"
+#include "ConfigStore.h"
 
+// 数据位于统一存储（Storage）中，所有语句都在数据库线程上执行
 class AudioDatabase : public QObject
 {
     Q_OBJECT
@@ -27,8 +31,12 @@ public:
 
     // 关联任务数据
     bool insertItem(RelatedItem &item);
+    // 单条修改与删除投递后立即返回，失败只记录日志
     bool updateItem(const RelatedItem &item);
     bool deleteItem(int id);
+    // 批量写入在同一个事务中完成，任一条失败则整体回滚
+    bool insertItems(RelatedList *items);
+    bool updateItems(const RelatedList &items);
     void queryItems(const QString &key, const QString &value, RelatedList *relatedList);
 
     // 应用配置数据
@@ -39,7 +47,17 @@ public:
     QString lastError();
 
 private:
-    QSqlDatabase mdb;
+    // 按SQL文本缓存预编译语句，连接存续期间只 prepare 一次
+    QSqlQuery *statement(QSqlDatabase &db, const QString &sql);
+    void bindItem(QSqlQuery *query, const RelatedItem &item);
+    bool execItem(QSqlQuery *query, const char *action);
+    bool commit(QSqlDatabase &db);
+    void setLastError(const QString &error);
+
+    ConfigStore *mConfigStore;
+    QHash<QString, QSqlQuery *> mStatements;    // 只在数据库线程访问
+    QMutex mErrorMutex;
+    QString mLastError;
 };
 
 #endif // AUDIODATABASE_H
@@ -9,6 +9,7 @@
 #include "AudioHelper.h"
 #include "AudioDatabase.h"
 #include "TrayManager.h"
+#include "WinTaskEventSource.h"
 
 AudioHelper::AudioHelper(QObject *parent)
     : ToolModel{ parent }
@@ -51,6 +52,9 @@ AudioHelper::AudioHelper(QObject *parent)
     mServer->setNotify(mConfig->value("切换时通知") == "true");
     mServer->setMode(mModeMap->value(mConfig->value("任务模式")));
     mServer->setScene(mSceneMap->value(mConfig->value("场景识别")));
+    // 事件驱动，启动失败时服务会回退到定时轮询
+    mServer->setEventSource(new WinTaskEventSource);
+    mServer->updateRelateds();
     mServer->start();
 }
 
@@ -72,6 +76,8 @@ void AudioHelper::showWindow()
         connect(mToolWidget, SIGNAL(closed()), this, SLOT(toolWindowClosed()));
         connect(mToolWidget, SIGNAL(windowEvent(QString,QString)), this, SLOT(toolWindowEvent(QString,QString)));
         connect(mToolWidget, SIGNAL(configChanged(QString,QString)), this, SLOT(saveConfig(QString,QString)));
+        // 在界面线程复制规则，避免服务线程读取到正在修改的列表
+        connect(mToolWidget, SIGNAL(relatedChanged()), mServer, SLOT(updateRelateds()), Qt::DirectConnection);
     }
     mToolWidget->show();
     mToolWidget->activateWindow();
@@ -154,6 +160,13 @@ void AudioHelper::checkRelateds()
     for (auto it = deviceList.constBegin(); it != deviceList.constEnd(); ++it) {
         idToName[it.value()] = it.key();
     }
+    // 需要同步到数据库的关联项，校验结束后在一个事务中写入
+    struct PendingUpdate {
+        int index;
+        AudioDeviceInfo previous;
+        int ignoreLevel;    // 写入失败时原设备的忽略等级
+    };
+    QList<PendingUpdate> pending;
 
     for (auto item = mRelatedList->begin(); item != mRelatedList->end(); ++item)
     {
@@ -172,14 +185,8 @@ void AudioHelper::checkRelateds()
         if (idList.contains(audioDeviceInfo->id))
         {
             qDebug() <<"任务:" << item->taskInfo.name << ", 设备名称存在变更:" << audioDeviceInfo->name << "->" << idToName.value(audioDeviceInfo->id);
+            pending.append({int(item - mRelatedList->begin()), *audioDeviceInfo, 3});
             audioDeviceInfo->name = idToName.value(audioDeviceInfo->id);
-            if (!mDatabase->updateItem(*item))
-            {
-                qCritical() << "Failed to update item:" << mDatabase->lastError();
-                audioDeviceInfo->id = audioDeviceInfo->id;
-                // 添加 id 到忽略列表
-                mIgnoreMap->insert(audioDeviceInfo->id, 3);
-            }
             continue;
         }
 
@@ -187,15 +194,8 @@ void AudioHelper::checkRelateds()
         if (nameList.contains(audioDeviceInfo->name))
         {
             qDebug() <<"任务:" << item->taskInfo.name << ", 设备ID存在变更:" << audioDeviceInfo->name;
-            QString oldId = audioDeviceInfo->id;
+            pending.append({int(item - mRelatedList->begin()), *audioDeviceInfo, 3});
             audioDeviceInfo->id = deviceList.value(audioDeviceInfo->name);
-            if (!mDatabase->updateItem(*item))
-            {
-                qCritical() << "Failed to update item:" << mDatabase->lastError();
-                audioDeviceInfo->id = oldId;
-                // 添加 old id 到忽略列表
-                mIgnoreMap->insert(audioDeviceInfo->id, 3);
-            }
             continue;
         }
 
@@ -233,17 +233,29 @@ void AudioHelper::checkRelateds()
         }
 
         QString oldId = audioDeviceInfo->id;
+        pending.append({int(item - mRelatedList->begin()), *audioDeviceInfo, 10});
         audioDeviceInfo->name = newName;
         audioDeviceInfo->id   = newId;
-        if (!mDatabase->updateItem(*item))
-        {
-            qCritical() << "Failed to update item:" << mDatabase->lastError();
-            // 添加 id 到忽略列表
-            mIgnoreMap->insert(audioDeviceInfo->id, 10);
+        changeDevice[oldId] = newId;
+    }
 
-            continue;
+    if (!pending.isEmpty())
+    {
+        RelatedList changed;
+        changed.reserve(pending.size());
+        for (const PendingUpdate &update : std::as_const(pending))
+            changed.append(mRelatedList->at(update.index));
+
+        if (!mDatabase->updateItems(changed))
+        {
+            qCritical() << "Failed to update items:" << mDatabase->lastError();
+            // 事务已回滚，内存中的关联项同样恢复，并把原设备加入忽略列表
+            for (const PendingUpdate &update : std::as_const(pending))
+            {
+                (*mRelatedList)[update.index].audioDeviceInfo = update.previous;
+                mIgnoreMap->insert(update.previous.id, update.ignoreLevel);
+            }
         }
-        changeDevice[oldId] = newId;
     }
     qInfo() << "设备情况校验完成";
 }
@@ -7,38 +7,58 @@
 #include "AudioHelperServer.h"
 #include "AudioDatabase.h"
 #include "TrayManager.h"
+#include "LogCategory.h"
+#include "Metrics.h"
+#include "Trace.h"
 #include <QFileInfo>
 #include <QFileIconProvider>
+#include <QDateTime>
 
+// 目标需要稳定的时长，避免快速切换焦点时反复切换设备
+static const qint64 SWITCH_DWELL_MSEC = 300;
+// 两次切换之间的最小间隔
+static const qint64 SWITCH_INTERVAL_MSEC = 1500;
 
 AudioHelperServer::AudioHelperServer(RelatedList *relatedList, IgnoreMap *ignoreMap, QObject *parent)
     : QObject{parent}
     , mRelatedList(relatedList)
+    , mRelatedsDirty(false)
     , mIgnoreMap(ignoreMap)
     , mMode(Mode::Smart)
     , mScene(Scene::Normal)
     , mNotify(true)
     , mState(false)
+    , mEventMode(false)
     , mTimer(new QTimer)
+    , mSwitchTimer(new QTimer(this))
     , mThread(new QThread)
+    , mEventSource(nullptr)
+    , mTracker(new TaskEventTracker(this))
     , mAudioManager(new AudioManager)
-    , mTargetList(new WeightList)
+    , mPendingSince(0)
+    , mLastSwitch(0)
 {
     moveToThread(mThread);
     connect(mTimer, SIGNAL(timeout()), this, SLOT(server()));
+    connect(mTracker, SIGNAL(rescore()), this, SLOT(server()));
+    connect(mSwitchTimer, SIGNAL(timeout()), this, SLOT(server()));
+    connect(AudioBackend::instance(), SIGNAL(defaultDeviceChanged(QString)), this, SLOT(onDefaultDeviceChanged(QString)));
     mThread->start();
 
     // 服务的轮训的间隔默认为半秒
     mTimer->setInterval(500);
+
+    mSwitchTimer->setSingleShot(true);
 }
 
 AudioHelperServer::~AudioHelperServer()
 {
+    stop();
     mThread->quit();
     mThread->wait();
+    delete mEventSource;
     delete mTimer;
     delete mAudioManager;
-    delete mTargetList;
 }
 
 void AudioHelperServer::setMode(const Mode mode)
@@ -78,14 +98,32 @@ bool AudioHelperServer::state() const
 
 void AudioHelperServer::start()
 {
-    mTimer->start();
     mState = true;
+
+    // 优先使用事件源，启动失败时回退到定时轮询
+    if (mEventSource != nullptr)
+    {
+        bool started = false;
+        Qt::ConnectionType type = QThread::currentThread() == mThread ? Qt::DirectConnection : Qt::BlockingQueuedConnection;
+        QMetaObject::invokeMethod(this, "startEvents", type, Q_RETURN_ARG(bool, started));
+        if (started)
+            return;
+        qWarning() << "任务事件源启动失败，使用定时轮询";
+    }
+
+    mTimer->start();
 }
 
 void AudioHelperServer::stop()
 {
     mTimer->stop();
     mState = false;
+
+    if (mEventSource != nullptr)
+    {
+        Qt::ConnectionType type = QThread::currentThread() == mThread ? Qt::DirectConnection : Qt::BlockingQueuedConnection;
+        QMetaObject::invokeMethod(this, "stopEvents", type);
+    }
 }
 
 void AudioHelperServer::setTimer(const uint msec)
@@ -93,89 +131,211 @@ void AudioHelperServer::setTimer(const uint msec)
     mTimer->setInterval(msec);
 }
 
-void AudioHelperServer::server()
+// 关联项变化后在界面线程调用：复制一份规则，由服务线程在下一次评分前重建索引
+void AudioHelperServer::updateRelateds()
 {
-    if(!audioServerMutex.try_lock())
-        return;
+    {
+        QMutexLocker locker(&mMutex);
+        mPendingRelateds = *mRelatedList;
+        mRelatedsDirty = true;
+    }
 
-    mTargetList->clear();
-
-    // 计算初始的权重
-    switch (mMode) {
-    case Mode::Smart:
-        calculateWindowsWeight();
-        calculateProcessWeight();
-        break;
-    case Mode::Process:
-        calculateProcessWeight();
-        break;
-    case Mode::Windows:
-        calculateWindowsWeight();
-        break;
-    default:
-        audioServerMutex.unlock();
+    if (mState)
+        QMetaObject::invokeMethod(this, "server", Qt::QueuedConnection);
+}
+
+void AudioHelperServer::setEventSource(TaskEventSource *eventSource)
+{
+    if (mState)
+        stop();
+
+    delete mEventSource;
+    mEventSource = eventSource;
+    if (mEventSource == nullptr)
         return;
+
+    // 事件源与服务在同一线程，事件直接送达
+    mEventSource->setParent(nullptr);
+    mEventSource->moveToThread(mThread);
+    connect(mEventSource, SIGNAL(taskEvent(TaskEvent)), mTracker, SLOT(handleEvent(TaskEvent)));
+}
+
+bool AudioHelperServer::startEvents()
+{
+    // 启动时事件源会同步推送一次全量状态
+    if (!mEventSource->start())
+    {
+        stopEvents();
+        return false;
     }
 
-    // 计算特殊场景加权
-    calculateSceneWeight();
+    mEventMode = true;
+    mTracker->requestRescore();
+    qCDebug(lcAudioServer) << "Server running in event mode, processes:" << mTracker->processTasks().size() << ", windows:" << mTracker->windowTasks().size();
+    return true;
+}
 
-    uint targetId = -1;
-    CHAR targetWeight = 0;
-    BOOL isDir = false;
+void AudioHelperServer::stopEvents()
+{
+    mEventSource->stop();
+    mSwitchTimer->stop();
+    mTracker->clear();
+    mProcessSnapshot.clear();
+    mEventMode = false;
+}
 
-    for(auto it = mTargetList->begin(); it != mTargetList->end(); it++)
-    {
-        uint key = *it;
-        CHAR value = mTargetList->value(key);
-        const RelatedItem *related = getRelated(key);
+// 用户或其它程序修改了默认设备，按当前任务重新评估；定时模式下一次轮询即会处理
+void AudioHelperServer::onDefaultDeviceChanged(const QString &deviceId)
+{
+    qCDebug(lcAudioServer) << "Default audio device changed:" << deviceId;
+    if (mState && mEventMode)
+        mTracker->requestRescore();
+}
 
-        // 跳过排除项
-        if (mIgnoreMap->value(related->audioDeviceInfo.id, 0) >= 3)
-            continue;
+void AudioHelperServer::applyProcessDelta(const ProcessDelta &delta)
+{
+    QMap<quintptr, TaskRecord> &processTasks = mTracker->processTasks();
+    for (const ProcessEntry &entry : delta.removed)
+        processTasks.remove(entry.pid);
 
-        if (value > targetWeight)
-        {
-            targetId = key;
-            targetWeight = value;
-            isDir = related->typeInfo.type == "文件夹";
-        }
+    for (const ProcessEntry &entry : delta.added)
+        processTasks.insert(entry.pid, {entry.pid, entry.taskInfo, entry.creationTime, PathHandle()});
+}
+
+bool AudioHelperServer::refreshProcessTasks()
+{
+    TRACE_SCOPE("AudioHelperServer::refreshProcessTasks");
+    // 定时模式下由快照比对得到增量，与事件模式共用同一份进程状态
+    if (mEventMode)
+        return true;
+
+    ProcessDelta delta;
+    if (!mProcessSnapshot.refresh(&delta))
+        return false;
+    applyProcessDelta(delta);
+    return !mTracker->processTasks().isEmpty();
+}
+
+bool AudioHelperServer::refreshWindowsTasks()
+{
+    TRACE_SCOPE("AudioHelperServer::refreshWindowsTasks");
+    if (mEventMode)
+        return true;
+
+    // 定时模式没有窗口事件，每轮重新枚举；路径句柄由引擎按路径找回
+    mWindowBuffer.clear();
+    TaskMonitor::getWindowsList(&mWindowBuffer);
+    QList<TaskRecord> &windowTasks = mTracker->windowTasks();
+    windowTasks.clear();
+    for (const TaskInfo &taskInfo : std::as_const(mWindowBuffer))
+        windowTasks.append({0, taskInfo, 0, PathHandle()});
+    return !windowTasks.isEmpty();
+}
+
+void AudioHelperServer::server()
+{
+    static MetricHistogram &tickTime = Metrics::histogram("audio_server_tick_us", "AudioHelperServer::server duration in microseconds");
+    static MetricCounter &switchTotal = Metrics::counter("audio_switch_total", "Successful default device switches");
+    static MetricCounter &failedTotal = Metrics::counter("audio_switch_failed_total", "Failed default device switches");
+    static MetricHistogram &switchLatency = Metrics::histogram("audio_switch_latency_ms", "Time from a new target to the completed switch in milliseconds");
 
-        // 降低文件夹的优先级但不降低权重
-        if (value == targetWeight && isDir && related->typeInfo.type != "文件夹")
+    if (!mState || !audioServerMutex.try_lock())
+        return;
+
+    MetricTimer tickTimer(tickTime);
+    TRACE_SCOPE("AudioHelperServer::server");
+
+    // 规则只在变化后重建一次索引
+    {
+        QMutexLocker locker(&mMutex);
+        if (mRelatedsDirty)
         {
-            targetId = key;
-            targetWeight = value;
-            isDir = false;
+            mEngine.setRules(mPendingRelateds);
+            mPendingRelateds.clear();
+            mRelatedsDirty = false;
+            qCDebug(lcAudioServer) << "Rebuild related index:" << mEngine.rules().size();
         }
     }
 
+    bool windows = mMode == Mode::Smart || mMode == Mode::Windows;
+    bool processes = mMode == Mode::Smart || mMode == Mode::Process;
+    if (!windows && !processes)
+    {
+        audioServerMutex.unlock();
+        return;
+    }
+
+    // 定时模式下先刷新任务状态，事件模式由事件维护
+    if (windows && !refreshWindowsTasks())
+    {
+        qWarning() << "获取窗口信息失败！";
+        stop();
+        audioServerMutex.unlock();
+        return;
+    }
+    if (processes && !refreshProcessTasks())
+    {
+        qWarning() << "获取进程信息失败！";
+        stop();
+        audioServerMutex.unlock();
+        return;
+    }
+
+    // 评分本身与定时器、托盘等无关
+    ScoreOptions options{windows, processes, sceneTag(), QDateTime::currentMSecsSinceEpoch(), mIgnoreMap};
+    ScoreResult result;
+    {
+        TRACE_SCOPE("scoreTasks");
+        result = scoreTasks(mEngine, options, mTracker->windowTasks(), mTracker->processTasks());
+    }
+    CHAR targetWeight = result.weight;
+
+    // 补偿期结束时没有任何事件，需要自行安排一次重新评分
+    if (mEventMode)
+        mTracker->scheduleExpire(result.nextExpire);
+
     // 未匹配到任何目标
-    if (targetId < 0 || targetWeight == 0)
+    if (result.slot < 0)
     {
+        mPendingDevice.clear();
         audioServerMutex.unlock();
         return;
     }
 
-    // 根据id进行检索目标项
-    const RelatedItem *target = getRelated(targetId);
+    const RelatedItem *target = &mEngine.rules().at(result.slot);
 
     // 进行切换---设备目标一致的情况下不进行切换
     if (target->audioDeviceInfo.id == mAudioManager->getCurrentAudioOutDevice())
+    {
+        mPendingDevice.clear();
+        audioServerMutex.unlock();
+        return;
+    }
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (!switchReady(target->audioDeviceInfo.id, now))
     {
         audioServerMutex.unlock();
         return;
     }
 
-    qInfo() << QString("任务触发: id:%1, weight:%2, name:%3, device:%4")
-                   .arg(targetId)
+    qCInfo(lcAudioServer) << QString("任务触发: id:%1, weight:%2, name:%3, device:%4")
+                   .arg(target->id)
                    .arg((short)targetWeight)
                    .arg(target->taskInfo.name)
                    .arg(target->audioDeviceInfo.name)
                    .toUtf8().constData();
 
-    if (mAudioManager->setAudioOutDevice(target->audioDeviceInfo.id))
+    bool switched = mAudioManager->setAudioOutDevice(target->audioDeviceInfo.id);
+    mLastSwitch = QDateTime::currentMSecsSinceEpoch();
+    qint64 latency = mLastSwitch - mPendingSince;
+    mPendingDevice.clear();
+
+    if (switched)
     {
+        switchTotal.add();
+        switchLatency.record(latency);
+        qCDebug(lcAudioServer) << "Switch latency:" << latency << "ms, count:" << switchTotal.value();
         if (mNotify)
         {
             QFileIconProvider iconProvider;
@@ -188,6 +348,7 @@ void AudioHelperServer::server()
     }
     else
     {
+        failedTotal.add();
         qWarning() << "任务执行执行失败了...";
         // 3次试错机会
         (*mIgnoreMap)[target->audioDeviceInfo.id] += mIgnoreMap->value(target->audioDeviceInfo.id, 0) + 1;
@@ -196,137 +357,38 @@ void AudioHelperServer::server()
     audioServerMutex.unlock();
 }
 
-void AudioHelperServer::calculateProcessWeight()
+// 防抖与迟滞：新目标需稳定 SWITCH_DWELL_MSEC，且距上次切换至少 SWITCH_INTERVAL_MSEC
+bool AudioHelperServer::switchReady(const QString &deviceId, qint64 now)
 {
-    TaskInfoList taskInfoList;
-    TaskMonitor::getProcessList(&taskInfoList);
-    if (taskInfoList.isEmpty())
+    if (deviceId != mPendingDevice)
     {
-        qWarning() << "获取进程信息失败！";
-        stop();
-        return;
+        mPendingDevice = deviceId;
+        mPendingSince = now;
     }
 
-    calculateWeight(&taskInfoList, 1);
-
-    // 对应刚打开的游戏，初始化需要一段时间，
-    // 但是此时没有窗口，无法得到加权，导致部分程序初始化了错误的音频设备，
-    // 并且该程序无法切换音频设备，那么此时就需要"预处理"，提取准备好音频设备
-    QVector<uint> targetBuffer;
-    for (auto it = taskInfoList.rbegin(); it != taskInfoList.rend(); ++it) {
-        TaskInfo task = *it;
-
-        // 仅补偿10s内打开的进程
-        if (task.survivalTime > 10000)
-            continue;
-
-        QVector<uint> idList = searchRelateds(task.path);
-        if (idList.isEmpty())
-            continue;
-
-        foreach (uint id, idList) {
-            if (targetBuffer.contains(id))
-                continue;
-
-            if (mTargetList->contains(id))
-                (*mTargetList)[id] += 2;
-            else
-                mTargetList->insert(id, 2);
-
-            targetBuffer.append(id);
-        }
-    }
-
-}
+    qint64 wait = qMax(mPendingSince + SWITCH_DWELL_MSEC, mLastSwitch + SWITCH_INTERVAL_MSEC) - now;
+    if (wait <= 0)
+        return true;
 
-void AudioHelperServer::calculateWindowsWeight()
-{
-    QMutexLocker locker(&mMutex);
-    TaskInfoList taskInfoList;
-    TaskMonitor::getWindowsList(&taskInfoList);
-    if (taskInfoList.isEmpty())
-    {
-        qWarning() << "获取窗口信息失败！";
-        stop();
-        return;
-    }
+    // 到期后重新评分，届时目标若已变化，本次切换自然作废
+    mSwitchTimer->start(int(wait));
 
-    calculateWeight(&taskInfoList, 2);
+    static MetricCounter &deferredTotal = Metrics::counter("audio_switch_deferred_total", "Switches postponed by the dwell or interval limit");
+    deferredTotal.add();
+    return false;
 }
 
-void AudioHelperServer::calculateWeight(TaskInfoList* taskInfoList, char weight)
+QString AudioHelperServer::sceneTag() const
 {
-    QVector<QString> taskBuffer;
-    QVector<uint> targetBuffer;
-    for (auto it = taskInfoList->rbegin(); it != taskInfoList->rend(); ++it) {
-        TaskInfo task = *it;
-
-        // 避免多进程任务的重复加权
-        if (taskBuffer.contains(task.path))
-            continue;
-
-        QVector<uint> idList = searchRelateds(task.path);
-        if (idList.isEmpty())
-            continue;
-
-        foreach (uint id, idList) {
-            if (targetBuffer.contains(id))
-                continue;
-
-            if (mTargetList->contains(id))
-                (*mTargetList)[id] += weight;
-            else
-                mTargetList->insert(id, weight);
-
-            targetBuffer.append(id);
-        }
-        taskBuffer.append(task.path);
-    }
-}
-
+    static const QString audiovisual("影音");
+    static const QString entertainment("游戏");
 
-void AudioHelperServer::calculateSceneWeight()
-{
-    QString scene;
     switch (mScene) {
-    case Scene::Normal:
-        return;        // 普通模式不需要进行场景加权
     case Scene::Audiovisual:
-        scene = "影音";
-        break;
+        return audiovisual;
     case Scene::Entertainment:
-        scene = "游戏";
-        break;
+        return entertainment;
     default:
-        return;
-    }
-
-    for(auto it = mTargetList->begin(); it != mTargetList->end(); it++)
-    {
-        uint key = *it;
-        const RelatedItem *related = getRelated(key);
-        if (related->typeInfo.tag == scene)
-            (*mTargetList)[key] += 1;
-    }
-}
-
-QVector<uint> AudioHelperServer::searchRelateds(const QString path) const
-{
-    QVector<uint> reslut;
-    for (auto item = mRelatedList->constBegin(); item != mRelatedList->constEnd(); ++item)
-    {
-        if (path.startsWith(item->taskInfo.path))
-            reslut.append(item->id);
-    }
-    return reslut;
-}
-
-const RelatedItem *AudioHelperServer::getRelated(const uint id) const
-{
-    for (auto item = mRelatedList->constBegin(); item != mRelatedList->constEnd(); ++item)
-    {
-        if (item->id == id)
-            return &(*item);
+        return QString();       // 普通模式不需要进行场景加权
     }
-    return nullptr;
 }
@@ -14,17 +14,14 @@
 #include <QMutex>
 
 #include "TaskMonitor.h"
+#include "TaskEventSource.h"
+#include "TaskEventTracker.h"
+#include "WeightEngine.h"
 #include "AudioManager.h"
 #include "Custom.h"
 
 inline QMutex audioServerMutex;
 
-// key:RelatedItem->id, value:Weight
-typedef OrderedMap<UINT, CHAR> WeightList;
-
-// key: device->id, value: times. ignore Related when value > 3
-typedef QMap<QString, byte> IgnoreMap;
-
 class AudioHelperServer : public QObject
 {
     Q_OBJECT
@@ -56,33 +53,48 @@ public:
     bool state() const;
 
     void setTimer(const uint msec);
+    void setEventSource(TaskEventSource *eventSource);
 
 public slots:
     void start();
     void stop();
+    void updateRelateds();
 
 private slots:
     void server();
+    bool startEvents();
+    void stopEvents();
+    void onDefaultDeviceChanged(const QString &deviceId);
 
 private:
     Mode mMode;
     Scene mScene;
     bool mNotify;
     bool mState;
+    bool mEventMode;
     QTimer *mTimer;
+    QTimer *mSwitchTimer;
     QThread *mThread;
+    TaskEventSource *mEventSource;
+    TaskEventTracker *mTracker;
+    ProcessSnapshot mProcessSnapshot;
     AudioManager *mAudioManager;
     RelatedList *mRelatedList;
-    WeightList *mTargetList;
+    RelatedList mPendingRelateds;
+    bool mRelatedsDirty;
+    WeightEngine mEngine;
     IgnoreMap *mIgnoreMap;
+    TaskInfoList mWindowBuffer;
     QMutex mMutex;
-
-    void calculateProcessWeight();
-    void calculateWindowsWeight();
-    void calculateSceneWeight();
-    void calculateWeight(TaskInfoList *taskInfoList, char weight);
-    QVector<uint> searchRelateds(const QString path) const;
-    const RelatedItem *getRelated(const uint id) const;
+    QString mPendingDevice;
+    qint64 mPendingSince;
+    qint64 mLastSwitch;
+
+    QString sceneTag() const;
+    bool refreshProcessTasks();
+    void applyProcessDelta(const ProcessDelta &delta);
+    bool refreshWindowsTasks();
+    bool switchReady(const QString &deviceId, qint64 now);
 };
 
 #endif // AUDIOHELPERSERVER_H
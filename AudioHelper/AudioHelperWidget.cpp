@@ -330,6 +330,7 @@ void AudioHelperWidget::addRelatedItem()
     }
 
     mRelatedList->append(relatedItem);
+    emit relatedChanged();
 
     // 创建顶层节点
     QTreeWidgetItem *item = new QTreeWidgetItem(mTaskTab);
@@ -370,6 +371,7 @@ void AudioHelperWidget::delRelatedItem()
 
     // 删除数据和界面
     mRelatedList->removeAt(row);
+    emit relatedChanged();
     delete mTaskTab->takeTopLevelItem(row);  // 释放 QTreeWidgetItem
     mTaskTab->clearSelection();
     mTaskTab->setCurrentItem(nullptr);
@@ -391,15 +393,17 @@ void AudioHelperWidget::changeRelatedItem()
     AudioDeviceInfo* deviceInfo = choiceDialog.selectedOption();
     qInfo() << "任务" << item->text(0) << "更改关联项: " << deviceInfo->name;
 
-    // 更新数据
+    // 更新数据：先写入数据库，成功后再修改内存中的列表
     int row = mTaskTab->indexOfTopLevelItem(item);
-    RelatedItem &relatedItem = (*mRelatedList)[row];
+    RelatedItem relatedItem = mRelatedList->at(row);
     relatedItem.audioDeviceInfo = *deviceInfo;
 
     if (!mDatabase->updateItem(relatedItem)) {
         qCritical() << "Failed to update item:" << mDatabase->lastError();
         return;
     }
+    (*mRelatedList)[row] = relatedItem;
+    emit relatedChanged();
 
     // 修改 UI 显示为新的值
     item->setText(2, relatedItem.audioDeviceInfo.name);
@@ -415,7 +419,7 @@ void AudioHelperWidget::setSceneTag(bool isAdd)
         return;
 
     int current_row = mTaskTab->indexOfTopLevelItem(item);
-    RelatedItem &relatedItem = (*mRelatedList)[current_row];
+    RelatedItem relatedItem = mRelatedList->at(current_row);
 
     if (isAdd) {
         TagSwitchDialog tagSwitchDialog(this);
@@ -428,11 +432,13 @@ void AudioHelperWidget::setSceneTag(bool isAdd)
         relatedItem.typeInfo.tag = "";
     }
 
-    // 保存到数据库
+    // 保存到数据库，成功后再修改内存中的列表
     if (!mDatabase->updateItem(relatedItem)) {
         qCritical() << "Failed to update item:" << mDatabase->lastError();
         return;
     }
+    (*mRelatedList)[current_row] = relatedItem;
+    emit relatedChanged();
 
     // 删除旧的 widget
     QWidget *oldWidget = mTaskTab->itemWidget(item, 1);
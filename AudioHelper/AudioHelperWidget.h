@@ -25,6 +25,7 @@ public:
 
 signals:
     void configChanged(const QString &key, const QString &value);
+    void relatedChanged();
 
 private slots:
     void onTaskTabItemClicked(QTreeWidgetItem *item, int);
@@ -9,9 +9,7 @@
  */
 
 #include <QMap>
-
-//音频设备---key:friendname,value:deviceId
-typedef QMap<QString, QString> AudioDeviceList;
+#include "AudioBackend.h"
 
 class AudioManager
 {
@@ -21,9 +19,6 @@ public:
     static QString getDefaultAudioOutDevice();
     bool setAudioOutDevice(const QString &deviceId);
     QString getCurrentAudioOutDevice();
-
-private:
-    QString mCurrentOutDeviceId;
 };
 
 #endif // AUDIOMANAGER_H
@@ -0,0 +1,40 @@
+#ifndef AUDIOTYPES_H
+#define AUDIOTYPES_H
+
+/**
+ * @file AudioTypes.h
+ * @author Asteri5m
+ * @date 2026-10-16 21:03:51
+ * @brief AudioHelper的基础数据类型，只依赖QtCore，便于脱离界面使用
+ */
+
+#include <QString>
+#include <QList>
+
+struct TaskInfo {
+    QString name;
+    QString path;
+    qint64 survivalTime;
+};
+
+struct AudioDeviceInfo {
+    QString name;
+    QString id;
+};
+
+struct TypeInfo
+{
+    QString type;
+    QString tag;
+};
+
+struct RelatedItem {
+    uint id;            // 数据库id
+    TaskInfo taskInfo;
+    TypeInfo typeInfo;
+    AudioDeviceInfo audioDeviceInfo;
+};
+
+typedef QList<RelatedItem> RelatedList;
+
+#endif // AUDIOTYPES_H
@@ -0,0 +1,290 @@
+/**
+ * @file ExeInfoCache.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 18:02:44
+ * @brief 可执行文件信息缓存：友好名称与图标，内存LRU + 磁盘两级，后台线程池解析
+ */
+
+#include "ExeInfoCache.h"
+#include "Trace.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QThread>
+#include <QSaveFile>
+#include <QDebug>
+#include <algorithm>
+
+#include <Windows.h>
+#include <shellapi.h>
+
+static const int MEMORY_CACHE_SIZE = 256;
+static const int DISK_CACHE_SIZE = 1024;                // 磁盘层保留最近使用的条目数
+static const quint32 CACHE_MAGIC = 0x4C444549;          // "LDEI"
+static const quint32 CACHE_VERSION = 1;
+static const char *CACHE_FILE = "ExeInfo.cache";
+
+ExeInfoCache::ExeInfoCache(QObject *parent)
+    : QObject(parent)
+    , mStamp(0)
+    , mDiskLoaded(false)
+    , mDiskDirty(false)
+{
+    mMemory.setMaxCost(MEMORY_CACHE_SIZE);
+
+    // 解析以磁盘IO为主，少量线程即可，避免与前台争抢
+    mThreadPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+}
+
+ExeInfoCache::~ExeInfoCache()
+{
+    mThreadPool.waitForDone();
+    saveDisk();
+}
+
+ExeInfoCache &ExeInfoCache::instance()
+{
+    static ExeInfoCache instance;
+    return instance;
+}
+
+bool ExeInfoCache::find(const QString &path, ExeInfo *info)
+{
+    // 以 (路径, 修改时间, 大小) 作为键，文件更新后自动失效
+    QFileInfo fileInfo(path);
+    qint64 modified = fileInfo.lastModified().toMSecsSinceEpoch();
+    qint64 size = fileInfo.size();
+
+    QMutexLocker locker(&mMutex);
+    MemoryEntry *entry = mMemory.object(path);
+    if (entry != nullptr && entry->modified == modified && entry->size == size)
+    {
+        if (info != nullptr)
+            *info = entry->info;
+        return true;
+    }
+
+    loadDisk();
+    auto it = mDisk.find(path);
+    if (it == mDisk.end() || it->modified != modified || it->size != size)
+        return false;
+
+    // 从磁盘层提升到内存层
+    ExeInfo loaded;
+    QDataStream stream(it->data);
+    stream >> loaded.name >> loaded.icon;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    it->stamp = ++mStamp;
+    mMemory.insert(path, new MemoryEntry{modified, size, loaded});
+    if (info != nullptr)
+        *info = loaded;
+    return true;
+}
+
+void ExeInfoCache::request(const QString &path)
+{
+    if (find(path, nullptr))
+        return;
+
+    QMutexLocker locker(&mMutex);
+    if (mPending.contains(path))
+        return;
+    mPending.insert(path);
+    mThreadPool.start([this, path]() { resolve(path); });
+}
+
+QString ExeInfoCache::friendName(const QString &path)
+{
+    ExeInfo info;
+    if (find(path, &info) && !info.name.isEmpty())
+        return info.name;
+    return QFileInfo(path).baseName();
+}
+
+ExeInfo ExeInfoCache::load(const QString &path)
+{
+    return {readDescription(path), readIcon(path)};
+}
+
+void ExeInfoCache::resolve(const QString &path)
+{
+    ExeInfo info = load(path);
+
+    QFileInfo fileInfo(path);
+    qint64 modified = fileInfo.lastModified().toMSecsSinceEpoch();
+    qint64 size = fileInfo.size();
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << info.name << info.icon;
+
+    bool idle;
+    {
+        QMutexLocker locker(&mMutex);
+        mMemory.insert(path, new MemoryEntry{modified, size, info});
+        mDisk.insert(path, {modified, size, data, ++mStamp});
+        mDiskDirty = true;
+        mPending.remove(path);
+        idle = mPending.isEmpty();
+    }
+
+    emit resolved(path);
+
+    // 一批请求全部完成后再落盘
+    if (idle)
+        saveDisk();
+}
+
+// 调用方需持有 mMutex
+void ExeInfoCache::loadDisk()
+{
+    if (mDiskLoaded)
+        return;
+    mDiskLoaded = true;
+
+    QFile file(QDir("data").filePath(CACHE_FILE));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    quint32 magic, version;
+    qint32 count;
+    stream >> magic >> version >> count;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION)
+    {
+        qDebug() << "Discard exe info cache, version:" << version;
+        return;
+    }
+
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        QString path;
+        DiskEntry entry{0, 0, QByteArray(), 0};
+        stream >> path >> entry.modified >> entry.size >> entry.data;
+        if (stream.status() != QDataStream::Ok)
+            break;
+
+        // 文件按使用顺序由旧到新保存，序号依次递增
+        entry.stamp = ++mStamp;
+        mDisk.insert(path, entry);
+    }
+    qDebug() << "Load exe info cache:" << mDisk.size();
+}
+
+void ExeInfoCache::saveDisk()
+{
+    QList<QPair<QString, DiskEntry>> disk;
+    {
+        QMutexLocker locker(&mMutex);
+        if (!mDiskDirty)
+            return;
+        mDiskDirty = false;
+
+        // 按最近使用的顺序排列，超出上限的部分从最久未使用的一端淘汰
+        QList<QPair<quint64, QString>> order;
+        order.reserve(mDisk.size());
+        for (auto it = mDisk.cbegin(); it != mDisk.cend(); ++it)
+            order.append(qMakePair(it->stamp, it.key()));
+        std::sort(order.begin(), order.end());
+
+        int excess = qMax(0, int(order.size()) - DISK_CACHE_SIZE);
+        for (int i = 0; i < excess; ++i)
+            mDisk.remove(order.at(i).second);
+
+        disk.reserve(order.size() - excess);
+        for (int i = excess; i < order.size(); ++i)
+            disk.append(qMakePair(order.at(i).second, mDisk.value(order.at(i).second)));
+    }
+
+    // 多个线程可能同时完成一批请求，写文件需要串行
+    static QMutex saveMutex;
+    QMutexLocker locker(&saveMutex);
+
+    QDir dir("data");
+    if (!dir.exists()) dir.mkpath(".");
+    QSaveFile file(dir.filePath(CACHE_FILE));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Could not write exe info cache:" << file.errorString();
+        return;
+    }
+
+    // 由旧到新写入，加载时按文件顺序重新编号即可恢复使用顺序
+    QDataStream stream(&file);
+    stream << CACHE_MAGIC << CACHE_VERSION << qint32(disk.size());
+    for (const auto &item : std::as_const(disk))
+        stream << item.first << item.second.modified << item.second.size << item.second.data;
+
+    if (!file.commit())
+        qWarning() << "Could not write exe info cache:" << file.errorString();
+}
+
+// 获取friendname
+QString ExeInfoCache::readDescription(const QString &path)
+{
+    TRACE_SCOPE("ExeInfoCache::readDescription");
+    DWORD handle = 0;
+    DWORD size = GetFileVersionInfoSize((LPCWSTR)path.utf16(), &handle);
+    if (size == 0) {
+        return QString();
+    }
+
+    QByteArray buffer(size, 0);
+    if (!GetFileVersionInfo((LPCWSTR)path.utf16(), handle, size, buffer.data())) {
+        return QString();
+    }
+
+    VS_FIXEDFILEINFO* fileInfo = nullptr;
+    UINT fileInfoSize = 0;
+    if (!VerQueryValue(buffer.data(), L"\\", (LPVOID*)&fileInfo, &fileInfoSize)) {
+        return QString();
+    }
+
+    // 获取语言和代码页
+    struct LANGANDCODEPAGE {
+        WORD wLanguage;
+        WORD wCodePage;
+    } *translate;
+    UINT translateSize = 0;
+    if (!VerQueryValue(buffer.data(), L"\\VarFileInfo\\Translation", (LPVOID*)&translate, &translateSize)) {
+        return QString();
+    }
+
+    // 构建查询路径
+    QString queryString = QString("\\StringFileInfo\\%1%2\\FileDescription")
+                              .arg(QString::number(translate->wLanguage, 16), 4, QLatin1Char('0'))
+                              .arg(QString::number(translate->wCodePage, 16), 4, QLatin1Char('0'));
+
+    // 查询文件描述
+    LPVOID description = nullptr;
+    UINT sizeDescription = 0;
+    if (!VerQueryValue(buffer.data(), (LPCWSTR)queryString.utf16(), &description, &sizeDescription)) {
+        return QString();
+    }
+
+    return QString::fromWCharArray((WCHAR*)description);
+}
+
+// 直接取系统图标并栅格化为 QImage，避免在非界面线程创建 QPixmap
+QImage ExeInfoCache::readIcon(const QString &path)
+{
+    TRACE_SCOPE("ExeInfoCache::readIcon");
+    // SHGetFileInfo 依赖 COM，线程池中的线程需要自行初始化
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+
+    QImage icon;
+    SHFILEINFOW fileInfo = {};
+    QString nativePath = QDir::toNativeSeparators(path);
+    if (SHGetFileInfoW((LPCWSTR)nativePath.utf16(), 0, &fileInfo, sizeof(fileInfo), SHGFI_ICON | SHGFI_LARGEICON))
+    {
+        icon = QImage::fromHICON(fileInfo.hIcon);
+        DestroyIcon(fileInfo.hIcon);
+    }
+
+    if (SUCCEEDED(hr))
+        CoUninitialize();
+    return icon;
+}
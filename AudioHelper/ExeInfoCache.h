@@ -0,0 +1,76 @@
+#ifndef EXEINFOCACHE_H
+#define EXEINFOCACHE_H
+
+/**
+ * @file ExeInfoCache.h
+ * @author Asteri5m
+ * @date 2026-10-16 18:02:44
+ * @brief 可执行文件信息缓存：友好名称与图标，内存LRU + 磁盘两级，后台线程池解析
+ */
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+#include <QImage>
+#include <QMutex>
+#include <QThreadPool>
+
+struct ExeInfo {
+    QString name;       // 版本资源中的 FileDescription，没有时为空
+    QImage icon;        // 已栅格化的图标，可在任意线程使用
+};
+
+class ExeInfoCache : public QObject
+{
+    Q_OBJECT
+public:
+    static ExeInfoCache &instance();
+
+    // 只查缓存，不做解析；文件的修改时间或大小变化后视为未命中
+    bool find(const QString &path, ExeInfo *info);
+    // 未命中时投递到线程池解析，完成后发出 resolved
+    void request(const QString &path);
+    // 缓存中的友好名称，未命中或没有描述时返回文件名
+    QString friendName(const QString &path);
+
+    // 直接解析，不经过缓存
+    static ExeInfo load(const QString &path);
+
+signals:
+    void resolved(const QString &path);
+
+private:
+    explicit ExeInfoCache(QObject *parent = nullptr);
+    ~ExeInfoCache();
+
+    struct DiskEntry {
+        qint64 modified;
+        qint64 size;
+        QByteArray data;    // 序列化后的 ExeInfo，命中时才解码
+        quint64 stamp;      // 最近使用的序号，保存时据此淘汰
+    };
+
+    struct MemoryEntry {
+        qint64 modified;
+        qint64 size;
+        ExeInfo info;
+    };
+
+    void resolve(const QString &path);
+    void loadDisk();
+    void saveDisk();
+    static QString readDescription(const QString &path);
+    static QImage readIcon(const QString &path);
+
+    QCache<QString, MemoryEntry> mMemory;
+    QHash<QString, DiskEntry> mDisk;
+    QSet<QString> mPending;
+    quint64 mStamp;
+    bool mDiskLoaded;
+    bool mDiskDirty;
+    QMutex mMutex;
+    QThreadPool mThreadPool;
+};
+
+#endif // EXEINFOCACHE_H
@@ -0,0 +1,50 @@
+/**
+ * @file ProcessRowSet.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 16:48:10
+ * @brief 进程列表中已展示的进程：排除前缀过滤与按可执行文件去重
+ */
+
+#include "ProcessRowSet.h"
+
+void ProcessRowSet::clear()
+{
+    mRows.clear();
+    mPaths.clear();
+}
+
+int ProcessRowSet::size() const
+{
+    return mRows.size();
+}
+
+bool ProcessRowSet::contains(quintptr pid) const
+{
+    return mRows.contains(pid);
+}
+
+bool ProcessRowSet::add(quintptr pid, const QString &path, const PrefixTable &prefixes, bool dedup)
+{
+    if (mRows.contains(pid) || prefixes.matches(path))
+        return false;
+
+    if (dedup && mPaths.contains(path))
+        return false;
+
+    mRows.insert(pid, path);
+    mPaths[path]++;
+    return true;
+}
+
+bool ProcessRowSet::remove(quintptr pid)
+{
+    auto row = mRows.find(pid);
+    if (row == mRows.end())
+        return false;
+
+    auto path = mPaths.find(*row);
+    if (path != mPaths.end() && --(*path) <= 0)
+        mPaths.erase(path);
+    mRows.erase(row);
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef PROCESSROWSET_H
+#define PROCESSROWSET_H
+
+/**
+ * @file ProcessRowSet.h
+ * @author Asteri5m
+ * @date 2026-10-17 16:48:10
+ * @brief 进程列表中已展示的进程：排除前缀过滤与按可执行文件去重
+ */
+
+#include <QHash>
+#include <QString>
+#include "RuleIndex.h"
+
+// 记录 pid -> 路径，以及路径 -> 进程数；每个进程的过滤与去重只需一次二分查找和两次哈希查找
+class ProcessRowSet
+{
+public:
+    void clear();
+    int size() const;
+    bool contains(quintptr pid) const;
+
+    // 未记录、未被排除前缀命中、且去重时路径尚未展示的进程会被记录，返回true
+    bool add(quintptr pid, const QString &path, const PrefixTable &prefixes, bool dedup);
+    // 移除已记录的进程，未记录时返回false
+    bool remove(quintptr pid);
+
+private:
+    QHash<quintptr, QString> mRows;
+    QHash<QString, int> mPaths;
+};
+
+#endif // PROCESSROWSET_H
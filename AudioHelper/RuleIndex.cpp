@@ -0,0 +1,115 @@
+/**
+ * @file RuleIndex.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 14:05:18
+ * @brief 关联规则索引：路径前缀匹配与id检索
+ */
+
+#include "RuleIndex.h"
+
+void PrefixTable::clear()
+{
+    mPending.clear();
+    mNodes.clear();
+    mValues.clear();
+}
+
+void PrefixTable::insert(const QString &prefix, int value)
+{
+    mPending.append(qMakePair(prefix, value));
+}
+
+void PrefixTable::build()
+{
+    // 稳定排序，相同前缀的值保持插入顺序
+    std::stable_sort(mPending.begin(), mPending.end(), [](const QPair<QString, int> &a, const QPair<QString, int> &b) {
+        return a.first < b.first;
+    });
+
+    mNodes.clear();
+    mValues.clear();
+    mNodes.reserve(mPending.size());
+    mValues.reserve(mPending.size());
+
+    QVector<int> stack;
+    for (const auto &pending : std::as_const(mPending))
+    {
+        if (!mNodes.isEmpty() && mNodes.last().prefix == pending.first)
+        {
+            mNodes.last().count++;
+            mValues.append(pending.second);
+            continue;
+        }
+
+        // 栈中保存当前项的所有前缀，不再是前缀的项出栈
+        while (!stack.isEmpty() && !pending.first.startsWith(mNodes.at(stack.last()).prefix))
+            stack.removeLast();
+
+        mNodes.append({pending.first, stack.isEmpty() ? -1 : stack.last(), int(mValues.size()), 1});
+        mValues.append(pending.second);
+        stack.append(int(mNodes.size()) - 1);
+    }
+
+    mPending.clear();
+    mPending.squeeze();
+}
+
+bool PrefixTable::isEmpty() const
+{
+    return mNodes.isEmpty();
+}
+
+bool PrefixTable::matches(const QString &path) const
+{
+    return findLongest(path) >= 0;
+}
+
+int PrefixTable::findLongest(const QString &path) const
+{
+    auto it = std::upper_bound(mNodes.cbegin(), mNodes.cend(), path, [](const QString &value, const Node &node) {
+        return value < node.prefix;
+    });
+
+    int index = int(it - mNodes.cbegin()) - 1;
+    while (index >= 0 && !path.startsWith(mNodes.at(index).prefix))
+        index = mNodes.at(index).parent;
+    return index;
+}
+
+
+void RuleIndex::rebuild(const RelatedList &relatedList)
+{
+    mRules = relatedList;
+    mSlots.clear();
+    mSlots.reserve(mRules.size());
+    mTable.clear();
+
+    for (int slot = 0; slot < mRules.size(); ++slot)
+    {
+        const RelatedItem &item = mRules.at(slot);
+        mSlots.insert(item.id, slot);
+        mTable.insert(item.taskInfo.path, slot);
+    }
+    mTable.build();
+}
+
+int RuleIndex::size() const
+{
+    return int(mRules.size());
+}
+
+int RuleIndex::slot(uint id) const
+{
+    return mSlots.value(id, -1);
+}
+
+const RelatedItem *RuleIndex::related(uint id) const
+{
+    int index = slot(id);
+    return index < 0 ? nullptr : &mRules.at(index);
+}
+
+const RelatedItem &RuleIndex::at(int slot) const
+{
+    return mRules.at(slot);
+}
@@ -0,0 +1,80 @@
+#ifndef RULEINDEX_H
+#define RULEINDEX_H
+
+/**
+ * @file RuleIndex.h
+ * @author Asteri5m
+ * @date 2026-10-16 14:05:18
+ * @brief 关联规则索引：路径前缀匹配与id检索
+ */
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <algorithm>
+#include "AudioTypes.h"
+
+// 有序前缀表：按字典序排列所有前缀，并记录每个前缀的"父前缀"（比它短且为其前缀的最长项）。
+// 对任意路径，字典序上不大于它的最后一项若不是它的前缀，则它的所有前缀都在该项的父链上，
+// 因此一次二分查找加上一段父链遍历即可找出全部匹配，匹配语义与 QString::startsWith 一致。
+class PrefixTable
+{
+public:
+    void clear();
+    void insert(const QString &prefix, int value);
+    void build();
+
+    bool isEmpty() const;
+    bool matches(const QString &path) const;
+
+    // 依次回调所有匹配前缀的值，由长到短
+    template<typename Func>
+    void match(const QString &path, Func &&func) const
+    {
+        for (int index = findLongest(path); index >= 0; index = mNodes.at(index).parent)
+        {
+            const Node &node = mNodes.at(index);
+            for (int i = node.first; i < node.first + node.count; ++i)
+                func(mValues.at(i));
+        }
+    }
+
+private:
+    struct Node {
+        QString prefix;
+        int parent;
+        int first;      // 在 mValues 中的起始位置，相同前缀的值连续存放
+        int count;
+    };
+
+    int findLongest(const QString &path) const;
+
+    QVector<QPair<QString, int>> mPending;
+    QVector<Node> mNodes;
+    QVector<int> mValues;
+};
+
+// 由 RelatedList 编译得到的规则索引，槽位即规则在列表中的下标
+class RuleIndex
+{
+public:
+    void rebuild(const RelatedList &relatedList);
+
+    int size() const;
+    int slot(uint id) const;
+    const RelatedItem *related(uint id) const;
+    const RelatedItem &at(int slot) const;
+
+    template<typename Func>
+    void match(const QString &path, Func &&func) const
+    {
+        mTable.match(path, std::forward<Func>(func));
+    }
+
+private:
+    RelatedList mRules;         // 隐式共享的副本，不受界面线程后续修改的影响
+    QHash<uint, int> mSlots;
+    PrefixTable mTable;
+};
+
+#endif // RULEINDEX_H
@@ -12,7 +12,7 @@
 
 SelectionDialog::SelectionDialog(QWidget *parent)
     : QDialog{parent}
-    , mTaskMonitor(new TaskMonitor())
+    , mTaskMonitor(new TaskMonitor(this))
     , mSelectedOption(new SelectionInfo)
 {
     setWindowTitle("添加关联项");
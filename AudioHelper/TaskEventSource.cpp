@@ -0,0 +1,63 @@
+/**
+ * @file TaskEventSource.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 10:12:40
+ * @brief 任务事件源，向后台服务推送进程与窗口的变化
+ */
+
+#include "TaskEventSource.h"
+
+FakeTaskEventSource::FakeTaskEventSource(const TaskEventList &events, QObject *parent)
+    : TaskEventSource(parent)
+    , mEvents(events)
+    , mCursor(0)
+    , mTimer(new QTimer(this))
+{
+    // 间隔为0时，start会同步回放全部事件
+    mTimer->setInterval(0);
+    connect(mTimer, &QTimer::timeout, this, [this]() {
+        if (!step())
+            mTimer->stop();
+    });
+}
+
+void FakeTaskEventSource::push(const TaskEvent &event)
+{
+    mEvents.append(event);
+}
+
+void FakeTaskEventSource::setInterval(int msec)
+{
+    mTimer->setInterval(msec);
+}
+
+bool FakeTaskEventSource::atEnd() const
+{
+    return mCursor >= mEvents.size();
+}
+
+bool FakeTaskEventSource::start()
+{
+    if (mTimer->interval() > 0)
+    {
+        mTimer->start();
+        return true;
+    }
+
+    while (step()) {}
+    return true;
+}
+
+void FakeTaskEventSource::stop()
+{
+    mTimer->stop();
+}
+
+bool FakeTaskEventSource::step()
+{
+    if (atEnd())
+        return false;
+
+    emit taskEvent(mEvents.at(mCursor++));
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef TASKEVENTSOURCE_H
+#define TASKEVENTSOURCE_H
+
+/**
+ * @file TaskEventSource.h
+ * @author Asteri5m
+ * @date 2026-10-16 10:12:40
+ * @brief 任务事件源，向后台服务推送进程与窗口的变化；接口与假事件源只依赖QtCore，Windows 实现见 WinTaskEventSource.h
+ */
+
+#include <QObject>
+#include <QTimer>
+#include <QList>
+#include "AudioTypes.h"
+
+struct TaskEvent {
+    enum Type {
+        ProcessStarted,
+        ProcessExited,
+        WindowOpened,
+        WindowClosed,
+        ForegroundChanged
+    };
+
+    Type type;
+    quintptr id;        // 进程为pid，窗口为hwnd
+    TaskInfo taskInfo;  // 退出/关闭事件中可以为空
+    qint64 startTime;   // 进程的创建时间(ms)，仅进程事件有效
+};
+
+typedef QList<TaskEvent> TaskEventList;
+
+// 事件源接口：启动后先推送一次全量状态，之后只推送增量
+class TaskEventSource : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TaskEventSource(QObject *parent = nullptr) : QObject(parent) {}
+
+public slots:
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+
+signals:
+    void taskEvent(const TaskEvent &event);
+};
+
+// 确定性的假事件源：按顺序回放预置事件，用于脱离桌面环境驱动和测试服务
+class FakeTaskEventSource : public TaskEventSource
+{
+    Q_OBJECT
+public:
+    explicit FakeTaskEventSource(const TaskEventList &events = TaskEventList(), QObject *parent = nullptr);
+
+    void push(const TaskEvent &event);
+    // 回放间隔，为0时 start 同步回放全部事件
+    void setInterval(int msec);
+    bool atEnd() const;
+
+public slots:
+    bool start() override;
+    void stop() override;
+    bool step();
+
+private:
+    TaskEventList mEvents;
+    int mCursor;
+    QTimer *mTimer;
+};
+
+#endif // TASKEVENTSOURCE_H
@@ -0,0 +1,92 @@
+/**
+ * @file TaskEventTracker.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 14:06:52
+ * @brief 事件模式下的任务状态：按事件维护进程与窗口，合并连续事件并安排补偿到期后的重新评分
+ */
+
+#include "TaskEventTracker.h"
+
+TaskEventTracker::TaskEventTracker(QObject *parent)
+    : QObject{parent}
+    , mEventTimer(new QTimer(this))
+    , mExpireTimer(new QTimer(this))
+{
+    // 事件模式下合并短时间内的连续事件，只评分一次
+    mEventTimer->setSingleShot(true);
+    mEventTimer->setInterval(COALESCE_MSEC);
+    // 粗粒度定时器可能提前 5% 触发，补偿尚未到期就会白评一次
+    mExpireTimer->setSingleShot(true);
+    mExpireTimer->setTimerType(Qt::PreciseTimer);
+
+    connect(mEventTimer, SIGNAL(timeout()), this, SIGNAL(rescore()));
+    connect(mExpireTimer, SIGNAL(timeout()), this, SIGNAL(rescore()));
+}
+
+QMap<quintptr, TaskRecord> &TaskEventTracker::processTasks()
+{
+    return mProcessTasks;
+}
+
+QList<TaskRecord> &TaskEventTracker::windowTasks()
+{
+    return mWindowTasks;
+}
+
+void TaskEventTracker::requestRescore()
+{
+    if (!mEventTimer->isActive())
+        mEventTimer->start();
+}
+
+void TaskEventTracker::scheduleExpire(qint64 msec)
+{
+    if (msec > 0)
+        mExpireTimer->start(int(msec));
+}
+
+void TaskEventTracker::clear()
+{
+    mEventTimer->stop();
+    mExpireTimer->stop();
+    mProcessTasks.clear();
+    mWindowTasks.clear();
+}
+
+void TaskEventTracker::handleEvent(const TaskEvent &event)
+{
+    switch (event.type) {
+    case TaskEvent::ProcessStarted:
+        mProcessTasks.insert(event.id, {event.id, event.taskInfo, event.startTime, PathHandle()});
+        break;
+    case TaskEvent::ProcessExited:
+        if (!mProcessTasks.remove(event.id))
+            return;
+        break;
+    case TaskEvent::WindowOpened:
+    case TaskEvent::ForegroundChanged:
+        // 最近出现或激活的窗口排在末尾，评分时逆序遍历使其优先
+        removeWindowTask(event.id);
+        mWindowTasks.append({event.id, event.taskInfo, 0, PathHandle()});
+        break;
+    case TaskEvent::WindowClosed:
+        if (!removeWindowTask(event.id))
+            return;
+        break;
+    }
+
+    requestRescore();
+}
+
+bool TaskEventTracker::removeWindowTask(quintptr id)
+{
+    for (int i = 0; i < mWindowTasks.size(); ++i)
+    {
+        if (mWindowTasks.at(i).id == id)
+        {
+            mWindowTasks.removeAt(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+#ifndef TASKEVENTTRACKER_H
+#define TASKEVENTTRACKER_H
+
+/**
+ * @file TaskEventTracker.h
+ * @author Asteri5m
+ * @date 2026-10-17 14:06:52
+ * @brief 事件模式下的任务状态：按事件维护进程与窗口，合并连续事件并安排补偿到期后的重新评分
+ */
+
+#include <QObject>
+#include <QTimer>
+#include <QMap>
+#include <QList>
+#include "TaskEventSource.h"
+#include "WeightEngine.h"
+
+class TaskEventTracker : public QObject
+{
+    Q_OBJECT
+public:
+    // 合并连续事件的窗口
+    static const int COALESCE_MSEC = 100;
+
+    explicit TaskEventTracker(QObject *parent = nullptr);
+
+    // 定时模式也复用这两份状态，评分时会回写路径句柄
+    QMap<quintptr, TaskRecord> &processTasks();
+    QList<TaskRecord> &windowTasks();
+
+    // 在合并窗口结束时发出一次 rescore
+    void requestRescore();
+    // 补偿到期后发出 rescore，msec <= 0 时不安排
+    void scheduleExpire(qint64 msec);
+    // 清空任务并取消尚未发出的 rescore
+    void clear();
+
+public slots:
+    void handleEvent(const TaskEvent &event);
+
+signals:
+    void rescore();
+
+private:
+    QMap<quintptr, TaskRecord> mProcessTasks;
+    QList<TaskRecord> mWindowTasks;
+    QTimer *mEventTimer;
+    QTimer *mExpireTimer;
+
+    bool removeWindowTask(quintptr id);
+};
+
+#endif // TASKEVENTTRACKER_H
@@ -0,0 +1,197 @@
+/**
+ * @file TaskListModel.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 19:10:25
+ * @brief 任务列表模型：在界面线程中按增量更新，不再整表清空重建
+ */
+
+#include "TaskListModel.h"
+#include <QSet>
+
+TaskListModel::TaskListModel(bool exeName, QObject *parent)
+    : QAbstractListModel(parent)
+    , mExeName(exeName)
+    , mGapStart(0)
+    , mGapSize(0)
+{
+}
+
+int TaskListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(mRows.size()) - mGapSize;
+}
+
+QVariant TaskListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+
+    const TaskRow &row = rowAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return row.name;
+    case Qt::DecorationRole:
+        return row.icon.isNull() ? QVariant() : QVariant(row.icon);
+    case Qt::ToolTipRole:
+        return row.path;
+    default:
+        return QVariant();
+    }
+}
+
+QString TaskListModel::path(int row) const
+{
+    return row >= 0 && row < rowCount() ? rowAt(row).path : QString();
+}
+
+bool TaskListModel::useExeName() const
+{
+    return mExeName;
+}
+
+void TaskListModel::clear()
+{
+    beginResetModel();
+    mRows.clear();
+    endResetModel();
+}
+
+void TaskListModel::applyDelta(const QList<quintptr> &removed, const TaskRowList &added)
+{
+    if (!removed.isEmpty())
+    {
+        QSet<quintptr> keys(removed.cbegin(), removed.cend());
+
+        // 一次遍历完成删除：保留的行前移，连续的待删行合并为一次通知。
+        // 遍历过程中 [mGapStart, mGapStart + mGapSize) 是已删除留下的空位，
+        // rowAt 会跳过它，通知期间视图读到的始终是删除后的行
+        int write = 0;
+        int read = 0;
+        int count = int(mRows.size());
+        while (read < count)
+        {
+            if (!keys.contains(mRows.at(read).key))
+            {
+                if (write != read)
+                    mRows[write] = std::move(mRows[read]);
+                ++write;
+                ++read;
+                mGapStart = write;
+                continue;
+            }
+
+            int last = read;
+            while (last + 1 < count && keys.contains(mRows.at(last + 1).key))
+                ++last;
+
+            beginRemoveRows(QModelIndex(), write, write + last - read);
+            mGapSize += last - read + 1;
+            read = last + 1;
+            endRemoveRows();
+        }
+
+        mRows.erase(mRows.begin() + write, mRows.end());
+        mGapStart = 0;
+        mGapSize = 0;
+    }
+
+    if (added.isEmpty())
+        return;
+
+    int first = int(mRows.size());
+    beginInsertRows(QModelIndex(), first, first + int(added.size()) - 1);
+    mRows.append(added);
+    endInsertRows();
+}
+
+void TaskListModel::setRows(const TaskRowList &rows)
+{
+    QSet<quintptr> keys;
+    keys.reserve(rows.size());
+    for (const TaskRow &row : rows)
+        keys.insert(row.key);
+
+    // 删除不再存在的行
+    for (int row = int(mRows.size()) - 1; row >= 0; --row)
+    {
+        if (keys.contains(mRows.at(row).key))
+            continue;
+        beginRemoveRows(QModelIndex(), row, row);
+        mRows.removeAt(row);
+        endRemoveRows();
+    }
+
+    // 此时剩余的行都在新列表中，逐位对齐即可
+    for (int i = 0; i < rows.size(); ++i)
+    {
+        const TaskRow &row = rows.at(i);
+        if (i < mRows.size() && mRows.at(i).key == row.key)
+        {
+            updateRow(i, row);
+            continue;
+        }
+
+        int from = indexOf(row.key, i + 1);
+        if (from < 0)
+        {
+            beginInsertRows(QModelIndex(), i, i);
+            mRows.insert(i, row);
+            endInsertRows();
+            continue;
+        }
+
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), i);
+        mRows.move(from, i);
+        endMoveRows();
+        updateRow(i, row);
+    }
+}
+
+void TaskListModel::updateExeInfo(const QString &path, const ExeInfo &info)
+{
+    for (int row = 0; row < mRows.size(); ++row)
+    {
+        TaskRow &taskRow = mRows[row];
+        if (taskRow.path != path)
+            continue;
+
+        if (!info.icon.isNull())
+            taskRow.icon = info.icon;
+        if (mExeName && !info.name.isEmpty())
+            taskRow.name = info.name;
+        taskRow.resolved = true;
+
+        QModelIndex modelIndex = index(row);
+        emit dataChanged(modelIndex, modelIndex, {Qt::DisplayRole, Qt::DecorationRole});
+    }
+}
+
+const TaskRow &TaskListModel::rowAt(int row) const
+{
+    return mRows.at(row < mGapStart ? row : row + mGapSize);
+}
+
+int TaskListModel::indexOf(quintptr key, int from) const
+{
+    for (int row = from; row < mRows.size(); ++row)
+    {
+        if (mRows.at(row).key == key)
+            return row;
+    }
+    return -1;
+}
+
+void TaskListModel::updateRow(int row, const TaskRow &taskRow)
+{
+    TaskRow &current = mRows[row];
+    if (current.name == taskRow.name && current.path == taskRow.path)
+        return;
+
+    // 同一路径下已有的图标在新行未命中缓存时保留，避免闪烁
+    QImage icon = current.path == taskRow.path && taskRow.icon.isNull() ? current.icon : taskRow.icon;
+    current = taskRow;
+    current.icon = icon;
+
+    QModelIndex modelIndex = index(row);
+    emit dataChanged(modelIndex, modelIndex);
+}
@@ -0,0 +1,57 @@
+#ifndef TASKLISTMODEL_H
+#define TASKLISTMODEL_H
+
+/**
+ * @file TaskListModel.h
+ * @author Asteri5m
+ * @date 2026-10-16 19:10:25
+ * @brief 任务列表模型：在界面线程中按增量更新，不再整表清空重建
+ */
+
+#include <QAbstractListModel>
+#include <QImage>
+#include "ExeInfoCache.h"
+
+// 列表中的一行，由后台线程生成后只读地交给界面线程
+struct TaskRow {
+    quintptr key;       // 进程为pid，窗口为HWND
+    QString name;
+    QString path;
+    QImage icon;
+    bool resolved;      // 生成时缓存是否命中，未命中的在界面线程应用前再查一次
+};
+
+typedef QList<TaskRow> TaskRowList;
+
+class TaskListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    // exeName 为 true 时，名称取可执行文件的描述（进程列表）；否则保留原名称（窗口标题）
+    explicit TaskListModel(bool exeName, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    QString path(int row) const;
+    bool useExeName() const;
+
+    void clear();
+    // 按键删除行，新行追加到末尾
+    void applyDelta(const QList<quintptr> &removed, const TaskRowList &added);
+    // 以新列表为准逐行对齐：删除、移动、插入，未变化的行保持不动
+    void setRows(const TaskRowList &rows);
+    void updateExeInfo(const QString &path, const ExeInfo &info);
+
+private:
+    const TaskRow &rowAt(int row) const;
+    int indexOf(quintptr key, int from = 0) const;
+    void updateRow(int row, const TaskRow &taskRow);
+
+    TaskRowList mRows;
+    bool mExeName;
+    int mGapStart;      // applyDelta 压缩过程中的空位，其余时候为0
+    int mGapSize;
+};
+
+#endif // TASKLISTMODEL_H
@@ -6,45 +6,59 @@
  */
 
 #include "TaskMonitor.h"
+#include "LogCategory.h"
+#include "Metrics.h"
+#include "Trace.h"
 #include <QDir>
 #include <QFileInfo>
+#include <QDateTime>
 #include <QDebug>
+#include <algorithm>
+#include <winternl.h>
+
+typedef NTSTATUS (NTAPI *NtQuerySystemInformationFunc)(SYSTEM_INFORMATION_CLASS, PVOID, ULONG, PULONG);
+static const NTSTATUS STATUS_INFO_LENGTH_MISMATCH_CODE = (NTSTATUS)0xC0000004L;
+
+// 每批交给界面线程的行数，首次加载时界面可以逐批刷新
+static const int ROW_BATCH_SIZE = 64;
 
 // 构造函数
 TaskMonitor::TaskMonitor(QObject *parent)
     : QObject(parent)
-    , mProcessModel(new QStandardItemModel(this))
-    , mWindowsModel(new QStandardItemModel(this))
-    , mProcessInfoList(new QFileInfoList)
-    , mWindowsInfoList(new QFileInfoList)
-    , mProcessFilter(new QStringList())
-    , mWindowsFilter(new QStringList())
+    , mProcessModel(new TaskListModel(true, this))
+    , mWindowsModel(new TaskListModel(false, this))
     , mFilterMode(FilterMode::All)
-    , mThread(new QThread(this))
+    , mProcessReset(false)
+    , mProcessBusy(false)
+    , mProcessQueued(false)
+    , mWindowsBusy(false)
+    , mWindowsQueued(false)
+    , mProcessSnapshot(new ProcessSnapshot)
+    , mProcessRows(new ProcessRowSet)
 {
-    this->moveToThread(mThread);
-    // 更新操作移到子线程，避免卡顿。
-    connect(this, SIGNAL(backgroundUpdate()), this, SLOT(updateModel()));
-    mThread->start();
+    // 枚举与解析都在线程池中进行，模型只在界面线程中按批次更新
+    mThreadPool.setMaxThreadCount(2);
+    connect(&ExeInfoCache::instance(), SIGNAL(resolved(QString)), this, SLOT(onExeInfoResolved(QString)));
 }
 
 // 析构函数
 TaskMonitor::~TaskMonitor()
 {
-    delete mProcessInfoList;
-    delete mWindowsInfoList;
-    mThread->quit();
-    mThread->wait();
+    // 未送达的批次随对象一起丢弃
+    mThreadPool.clear();
+    mThreadPool.waitForDone();
+    delete mProcessSnapshot;
+    delete mProcessRows;
 }
 
 // 获取进程模型
-QStandardItemModel* TaskMonitor::getProcessModel()
+TaskListModel* TaskMonitor::getProcessModel()
 {
     return mProcessModel;
 }
 
 // 获取窗口模型
-QStandardItemModel* TaskMonitor::getWindowsModel()
+TaskListModel* TaskMonitor::getWindowsModel()
 {
     return mWindowsModel;
 }
@@ -53,27 +67,35 @@ QStandardItemModel* TaskMonitor::getWindowsModel()
 QString TaskMonitor::filePath(const QModelIndex& index, TaskMode mode)
 {
     if (mode == Process && index.isValid()) {
-        return mProcessInfoList->at(index.row()).absoluteFilePath();
+        return mProcessModel->path(index.row());
     } else if (mode == Windows && index.isValid()) {
-        return mWindowsInfoList->at(index.row()).absoluteFilePath();
+        return mWindowsModel->path(index.row());
     }
     return QString();
 }
 
 void TaskMonitor::setFilter(QStringList &headers, TaskMode mode)
 {
+    // 排除前缀编译为有序前缀表，每行只需一次二分查找
+    PrefixTable table;
+    for (const QString &header : std::as_const(headers))
+        table.insert(header, 0);
+    table.build();
+
     switch (mode) {
     case Process:
-        mProcessFilter = new QStringList(headers);
+        mProcessFilter = table;
+        mProcessReset = true;
         break;
     case Windows:
-        mWindowsFilter = new QStringList(headers);
+        mWindowsFilter = table;
     }
 }
 
 void TaskMonitor::setFilter(FilterMode filterMode)
 {
     mFilterMode = filterMode;
+    mProcessReset = true;
 }
 
 void TaskMonitor::getProcessList(TaskInfoList *taskInfoList)
@@ -81,7 +103,7 @@ void TaskMonitor::getProcessList(TaskInfoList *taskInfoList)
     // 枚举进程
     DWORD processes[1024], processCount, cbNeeded;
     if (!EnumProcesses(processes, sizeof(processes), &cbNeeded)) {
-        qDebug() << "Failed to enumerate processes.";
+        qCDebug(lcTaskMonitor) << "Failed to enumerate processes.";
         return;
     }
 
@@ -89,299 +111,444 @@ void TaskMonitor::getProcessList(TaskInfoList *taskInfoList)
 
     // 遍历所有进程
     for (unsigned int i = 0; i < processCount; ++i) {
-        DWORD processId = processes[i];
-
-        // 打开进程
-        HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-        if (hProcess == nullptr)
-            continue;
-
-        // 获取进程的可执行文件路径
-        TCHAR processPath[MAX_PATH];
-        DWORD size = sizeof(processPath) / sizeof(TCHAR);
-        if (!QueryFullProcessImageName(hProcess, 0, processPath, &size))
-        {
-            CloseHandle(hProcess);
-            continue;
-        }
-
-        // 获取进程的创建时间
-        FILETIME creationTime, exitTime, kernelTime, userTime;
-        if (!GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime))
-        {
-            CloseHandle(hProcess);
-            continue;
-        }
-        CloseHandle(hProcess);
-
-        // 将 FILETIME 转换为 Unix 时间戳
-        ULARGE_INTEGER time;
-        time.LowPart = creationTime.dwLowDateTime;
-        time.HighPart = creationTime.dwHighDateTime;
-        qint64 processCreationTime = time.QuadPart / 10000 - 11644473600000LL; // 转换为毫秒
-
-        // 转换为相对时间 单位：毫秒
-        qint64 survivalTime = QDateTime::currentMSecsSinceEpoch() - processCreationTime;
-
-        // 获取绝对路径
-        QString drivepath = QDir::cleanPath(QString::fromWCharArray(processPath));
-
-        // 获取friendname, 首先尝试解析，解析失败后则使用QFileInfo::baseName
-        QString friendName = getExeDescription(drivepath);
-        if (friendName == "")
-        {
-            QFileInfo fileInfo(drivepath);
-            friendName = fileInfo.baseName();
-        }
-
-        TaskInfo taskInfo{friendName, drivepath, survivalTime};
-        taskInfoList->append(taskInfo);
+        TaskInfo taskInfo;
+        if (queryProcess(processes[i], &taskInfo))
+            taskInfoList->append(taskInfo);
     }
 }
 
 void TaskMonitor::getWindowsList(TaskInfoList *taskInfoList)
 {
+    int oldSize = int(taskInfoList->size());
+
     // 使用 lambda 表达式作为 EnumWindows 的回调
     EnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL {
         TaskInfoList *taskInfoList = reinterpret_cast<TaskInfoList *>(lParam);  // 从 lParam 中获取传递的列表指针
 
-        if (!IsWindowVisible(hwnd))
-            return TRUE;
+        // 创建 TaskInfo 并添加到传递的 taskInfoList 中
+        TaskInfo taskInfo;
+        if (queryWindow(hwnd, &taskInfo))
+            taskInfoList->append(taskInfo);
 
-        TCHAR windowTitle[256];
-        GetWindowText(hwnd, windowTitle, sizeof(windowTitle) / sizeof(TCHAR));
-        QString title = QString::fromWCharArray(windowTitle);
-        if (title.isEmpty())
-            return TRUE;
+        return TRUE; // 继续枚举窗口
+    }, reinterpret_cast<LPARAM>(taskInfoList));  // 将 taskInfoList 传递给 lParam
 
-        DWORD processId;
-        GetWindowThreadProcessId(hwnd, &processId);
+    // 枚举按Z序从前到后，结果需要倒序并排在原有内容之前，追加后一次调整代替逐个头插
+    std::reverse(taskInfoList->begin() + oldSize, taskInfoList->end());
+    std::rotate(taskInfoList->begin(), taskInfoList->begin() + oldSize, taskInfoList->end());
+}
 
-        HANDLE processHandle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
-        if (!processHandle)
-            return TRUE;
+// 查询单个进程的信息，失败返回false
+bool TaskMonitor::queryProcess(DWORD processId, TaskInfo *taskInfo, qint64 *creationTime)
+{
+    TRACE_SCOPE("TaskMonitor::queryProcess");
+    // 打开进程
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+    if (hProcess == nullptr)
+        return false;
 
-        WCHAR executablePath[MAX_PATH];
-        DWORD pathSize = MAX_PATH;
-        if (!QueryFullProcessImageNameW(processHandle, 0, executablePath, &pathSize)) {
-            CloseHandle(processHandle);
-            return TRUE;
-        }
+    // 获取进程的可执行文件路径
+    TCHAR processPath[MAX_PATH];
+    DWORD size = sizeof(processPath) / sizeof(TCHAR);
+    if (!QueryFullProcessImageName(hProcess, 0, processPath, &size))
+    {
+        CloseHandle(hProcess);
+        return false;
+    }
 
-        QString drivepath = QDir::cleanPath(QString::fromWCharArray(executablePath));
+    // 获取进程的创建时间
+    FILETIME fileTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(hProcess, &fileTime, &exitTime, &kernelTime, &userTime))
+    {
+        CloseHandle(hProcess);
+        return false;
+    }
+    CloseHandle(hProcess);
+
+    // 将 FILETIME 转换为 Unix 时间戳
+    ULARGE_INTEGER time;
+    time.LowPart = fileTime.dwLowDateTime;
+    time.HighPart = fileTime.dwHighDateTime;
+    qint64 processCreationTime = time.QuadPart / 10000 - 11644473600000LL; // 转换为毫秒
+    if (creationTime != nullptr)
+        *creationTime = processCreationTime;
+
+    // 获取绝对路径
+    QString drivepath = QDir::cleanPath(QString::fromWCharArray(processPath));
+
+    // 获取friendname, 只查缓存，未命中时使用QFileInfo::baseName，版本资源由需要展示的一方按需解析
+    QString friendName = ExeInfoCache::instance().friendName(drivepath);
+
+    // 转换为相对时间 单位：毫秒
+    taskInfo->name = friendName;
+    taskInfo->path = drivepath;
+    taskInfo->survivalTime = QDateTime::currentMSecsSinceEpoch() - processCreationTime;
+    return true;
+}
 
-        // 创建 TaskInfo 并添加到传递的 taskInfoList 中
-        TaskInfo taskInfo{title, drivepath};
-        taskInfoList->insert(0, taskInfo);
+// 查询单个窗口的信息，不可见或无标题的窗口返回false
+bool TaskMonitor::queryWindow(HWND hwnd, TaskInfo *taskInfo)
+{
+    TRACE_SCOPE("TaskMonitor::queryWindow");
+    if (!IsWindowVisible(hwnd))
+        return false;
+
+    TCHAR windowTitle[256];
+    GetWindowText(hwnd, windowTitle, sizeof(windowTitle) / sizeof(TCHAR));
+    QString title = QString::fromWCharArray(windowTitle);
+    if (title.isEmpty())
+        return false;
+
+    DWORD processId;
+    GetWindowThreadProcessId(hwnd, &processId);
 
+    HANDLE processHandle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (!processHandle)
+        return false;
+
+    WCHAR executablePath[MAX_PATH];
+    DWORD pathSize = MAX_PATH;
+    if (!QueryFullProcessImageNameW(processHandle, 0, executablePath, &pathSize)) {
         CloseHandle(processHandle);
+        return false;
+    }
+    CloseHandle(processHandle);
 
-        return TRUE; // 继续枚举窗口
-    }, reinterpret_cast<LPARAM>(taskInfoList));  // 将 taskInfoList 传递给 lParam
+    taskInfo->name = title;
+    taskInfo->path = QDir::cleanPath(QString::fromWCharArray(executablePath));
+    taskInfo->survivalTime = 0;
+    return true;
 }
 
 
+
 // 更新数据（更新模型）
 void TaskMonitor::update()
 {
-    emit backgroundUpdate();
+    startProcessUpdate();
+    startWindowsUpdate();
 }
 
-void TaskMonitor::updateModel()
+void TaskMonitor::startProcessUpdate()
 {
-    updateProcessModel();
-    updateWindowsModel();
+    // 上一轮尚未结束时只记下请求，结束后再补一次
+    if (mProcessBusy)
+    {
+        mProcessQueued = true;
+        return;
+    }
+    mProcessBusy = true;
+    mProcessQueued = false;
+
+    // 过滤条件变化后需要重建
+    TaskFilter filter{mProcessFilter, mFilterMode, mProcessReset};
+    if (mProcessReset)
+    {
+        mProcessModel->clear();
+        mProcessReset = false;
+    }
+
+    mThreadPool.start([this, filter]() { collectProcesses(filter); });
 }
 
-// 更新进程模型
-void TaskMonitor::updateProcessModel()
+void TaskMonitor::startWindowsUpdate()
 {
-    if (!taskMonitorMutex.tryLock())
-        return;
-
-    // 枚举进程
-    DWORD processes[1024], processCount, cbNeeded;
-    if (!EnumProcesses(processes, sizeof(processes), &cbNeeded)) {
-        qDebug() << "Failed to enumerate processes.";
+    if (mWindowsBusy)
+    {
+        mWindowsQueued = true;
         return;
     }
+    mWindowsBusy = true;
+    mWindowsQueued = false;
 
-    // 清空模型和进程信息列表
-    mProcessModel->clear();
-    mProcessInfoList->clear();
+    TaskFilter filter{mWindowsFilter, FilterMode::All, false};
+    mThreadPool.start([this, filter]() { collectWindows(filter); });
+}
 
-    processCount = cbNeeded / sizeof(DWORD);
+void TaskMonitor::finishProcessUpdate()
+{
+    mProcessBusy = false;
+    if (mProcessQueued)
+        startProcessUpdate();
+}
 
-    // 遍历所有进程
-    for (unsigned int i = 0; i < processCount; ++i) 
+void TaskMonitor::finishWindowsUpdate()
+{
+    mWindowsBusy = false;
+    if (mWindowsQueued)
+        startWindowsUpdate();
+}
+
+// 后台任务：比对进程快照，把增量分批交给界面线程
+void TaskMonitor::collectProcesses(const TaskFilter &filter)
+{
+    TRACE_SCOPE("TaskMonitor::collectProcesses");
+    static MetricHistogram &enumTime = Metrics::histogram("task_process_enum_us", "TaskMonitor process enumeration in microseconds");
+    static MetricGauge &processCount = Metrics::gauge("task_process_count", "Processes shown by TaskMonitor");
+    MetricTimer enumTimer(enumTime);
+
+    if (filter.reset)
     {
-        DWORD processId = processes[i];
+        mProcessSnapshot->clear();
+        mProcessRows->clear();
+    }
+
+    ProcessDelta delta;
+    if (!mProcessSnapshot->refresh(&delta)) {
+        qCDebug(lcTaskMonitor) << "Failed to enumerate processes.";
+        QMetaObject::invokeMethod(this, [this]() { finishProcessUpdate(); }, Qt::QueuedConnection);
+        return;
+    }
 
-        // 打开进程
-        HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-        if (hProcess == nullptr)
+    // 移除已退出的进程
+    QList<quintptr> removed;
+    TaskRowList added;
+    for (const ProcessEntry &entry : std::as_const(delta.removed))
+    {
+        if (!mProcessRows->remove(entry.pid))
             continue;
+        removed.append(entry.pid);
 
-        // 获取进程的可执行文件路径
-        TCHAR processPath[MAX_PATH];
-        DWORD size = sizeof(processPath) / sizeof(TCHAR);
-        if (!QueryFullProcessImageName(hProcess, 0, processPath, &size))
-        {
-            CloseHandle(hProcess);
+        // 去重模式下，由同一可执行文件的其它进程顶替
+        if (filter.mode != FilterMode::Clear)
             continue;
+        const QHash<DWORD, ProcessEntry> &entries = mProcessSnapshot->entries();
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+        {
+            if (it->valid && it->taskInfo.path == entry.taskInfo.path)
+            {
+                appendProcessRow(*it, filter, &added);
+                break;
+            }
         }
-        CloseHandle(hProcess);
+    }
+
+    // 添加新进程
+    for (const ProcessEntry &entry : std::as_const(delta.added))
+        appendProcessRow(entry, filter, &added);
+
+    processCount.set(mProcessRows->size());
+    qCTrace(lcTaskMonitor) << "Enumerate process number: " << mProcessRows->size()
+             << ", added:" << delta.added.length() << ", removed:" << delta.removed.length();
+
+    for (qsizetype first = 0; first < added.size() || first == 0; first += ROW_BATCH_SIZE)
+    {
+        QList<quintptr> batchRemoved = first == 0 ? removed : QList<quintptr>();
+        TaskRowList batch = added.mid(first, ROW_BATCH_SIZE);
+        if (batchRemoved.isEmpty() && batch.isEmpty())
+            break;
+
+        QMetaObject::invokeMethod(this, [this, batchRemoved, batch]() mutable {
+            resolveRows(&batch, true);
+            mProcessModel->applyDelta(batchRemoved, batch);
+        }, Qt::QueuedConnection);
+    }
+    QMetaObject::invokeMethod(this, [this]() { finishProcessUpdate(); }, Qt::QueuedConnection);
+}
+
+void TaskMonitor::appendProcessRow(const ProcessEntry &entry, const TaskFilter &filter, TaskRowList *rows)
+{
+    // 过滤与去重，通过的进程同时被记录
+    const QString &drivepath = entry.taskInfo.path;
+    if (!mProcessRows->add(entry.pid, drivepath, filter.prefixes, filter.mode == FilterMode::Clear))
+        return;
+
+    TaskRow row{entry.pid, entry.taskInfo.name, drivepath, QImage(), false};
+    if (!fillExeInfo(&row, true))
+        ExeInfoCache::instance().request(drivepath);
+    rows->append(row);
+}
+
+// 后台任务：枚举窗口，整体交给界面线程按键对齐
+void TaskMonitor::collectWindows(const TaskFilter &filter)
+{
+    TRACE_SCOPE("TaskMonitor::collectWindows");
+    static MetricHistogram &enumTime = Metrics::histogram("task_window_enum_us", "TaskMonitor window enumeration in microseconds");
+    MetricTimer enumTimer(enumTime);
+
+    QList<HWND> windows;
+    EnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL {
+        reinterpret_cast<QList<HWND> *>(lParam)->append(hwnd);
+        return TRUE;
+    }, reinterpret_cast<LPARAM>(&windows));
 
-        QString drivepath = QDir::cleanPath(QString::fromWCharArray(processPath));
+    // EnumWindows 自顶向下枚举，逆序遍历即与原先插入头部得到的顺序一致
+    TaskRowList rows;
+    for (auto it = windows.crbegin(); it != windows.crend(); ++it)
+    {
+        TaskInfo taskInfo;
+        if (!queryWindow(*it, &taskInfo))
+            continue;
 
         // 过滤
-        if (!filterProcess(drivepath))
+        if (!filterWindows(taskInfo.path, filter))
             continue;
 
-        // 将进程信息添加到文件信息列表（模拟 QFileInfo 用于兼容接口）
-        QFileInfo fileInfo(drivepath);
-        mProcessInfoList->append(fileInfo);
+        TaskRow row{reinterpret_cast<quintptr>(*it), taskInfo.name, taskInfo.path, QImage(), false};
+        if (!fillExeInfo(&row, false))
+            ExeInfoCache::instance().request(taskInfo.path);
+        rows.append(row);
+    }
 
-        // 获取friendname, 首先尝试解析，解析失败后则使用QFileInfo::baseName
-        QString friendName = getExeDescription(drivepath);
-        if (friendName == "")
-            friendName = fileInfo.baseName();
+    qCTrace(lcTaskMonitor) << "Enumerate windows number: " << rows.length();
 
-        QFileIconProvider iconProvider;
-        QStandardItem *item = new QStandardItem(iconProvider.icon(fileInfo), friendName);
-        mProcessModel->appendRow(item);
-    }
-    qDebug() << "Enumerate process number: " << mProcessInfoList->length();
-    taskMonitorMutex.unlock();
+    QMetaObject::invokeMethod(this, [this, rows]() mutable {
+        resolveRows(&rows, false);
+        mWindowsModel->setRows(rows);
+        finishWindowsUpdate();
+    }, Qt::QueuedConnection);
 }
 
-// 获取friendname
-QString TaskMonitor::getExeDescription(const QString& filePath)
+// 名称与图标只查缓存，命中返回true
+bool TaskMonitor::fillExeInfo(TaskRow *row, bool withName)
 {
-    DWORD handle = 0;
-    DWORD size = GetFileVersionInfoSize((LPCWSTR)filePath.utf16(), &handle);
-    if (size == 0) {
-        return QString();
-    }
+    ExeInfo info;
+    if (!ExeInfoCache::instance().find(row->path, &info))
+        return false;
 
-    QByteArray buffer(size, 0);
-    if (!GetFileVersionInfo((LPCWSTR)filePath.utf16(), handle, size, buffer.data())) {
-        return QString();
-    }
+    row->icon = info.icon;
+    if (withName && !info.name.isEmpty())
+        row->name = info.name;
+    row->resolved = true;
+    return true;
+}
 
-    VS_FIXEDFILEINFO* fileInfo = nullptr;
-    UINT fileInfoSize = 0;
-    if (!VerQueryValue(buffer.data(), L"\\", (LPVOID*)&fileInfo, &fileInfoSize)) {
-        return QString();
+// 生成时未命中的行，在交给模型前再查一次，期间完成的解析不会因信号先到而丢失
+void TaskMonitor::resolveRows(TaskRowList *rows, bool withName)
+{
+    for (TaskRow &row : *rows)
+    {
+        if (!row.resolved)
+            fillExeInfo(&row, withName);
     }
+}
 
-    // 获取语言和代码页
-    struct LANGANDCODEPAGE {
-        WORD wLanguage;
-        WORD wCodePage;
-    } *translate;
-    UINT translateSize = 0;
-    if (!VerQueryValue(buffer.data(), L"\\VarFileInfo\\Translation", (LPVOID*)&translate, &translateSize)) {
-        return QString();
-    }
+void TaskMonitor::onExeInfoResolved(const QString &path)
+{
+    ExeInfo info;
+    if (!ExeInfoCache::instance().find(path, &info))
+        return;
 
-    // 构建查询路径
-    QString queryString = QString("\\StringFileInfo\\%1%2\\FileDescription")
-                              .arg(QString::number(translate->wLanguage, 16), 4, QLatin1Char('0'))
-                              .arg(QString::number(translate->wCodePage, 16), 4, QLatin1Char('0'));
+    mProcessModel->updateExeInfo(path, info);
+    mWindowsModel->updateExeInfo(path, info);
+}
+
+// 过滤，需要过滤就返回false
+bool TaskMonitor::filterWindows(const QString &text, const TaskFilter &filter) const
+{
+    return !filter.prefixes.matches(text);
+}
 
-    // 查询文件描述
-    LPVOID description = nullptr;
-    UINT sizeDescription = 0;
-    if (!VerQueryValue(buffer.data(), (LPCWSTR)queryString.utf16(), &description, &sizeDescription)) {
-        return QString();
-    }
 
-    return QString::fromWCharArray((WCHAR*)description);
+ProcessSnapshot::ProcessSnapshot()
+    : mGeneration(0)
+{
 }
 
-void TaskMonitor::updateWindowsModel()
+// 刷新快照：一次系统调用取得全部 (pid, 创建时间)，只有新出现的进程才会被打开解析
+bool ProcessSnapshot::refresh(ProcessDelta *delta)
 {
-    if (!taskMonitorMutex.tryLock())
-        return;
+    static const NtQuerySystemInformationFunc ntQuerySystemInformation = reinterpret_cast<NtQuerySystemInformationFunc>(
+        GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtQuerySystemInformation"));
 
-    // 清空模型和窗口信息列表
-    mWindowsModel->clear();
-    mWindowsInfoList->clear();
+    mGeneration++;
 
-    // 使用 lambda 表达式作为 EnumWindows 的回调
-    EnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL 
+    if (ntQuerySystemInformation != nullptr)
     {
-        TaskMonitor *monitor = reinterpret_cast<TaskMonitor *>(lParam);
-        if (!IsWindowVisible(hwnd))
-            return TRUE;
-
-        TCHAR windowTitle[256];
-        GetWindowText(hwnd, windowTitle, sizeof(windowTitle) / sizeof(TCHAR));
-        QString title = QString::fromWCharArray(windowTitle);
-        if (title.isEmpty())
-            return TRUE;
-
-        DWORD processId;
-        GetWindowThreadProcessId(hwnd, &processId);
-
-        HANDLE processHandle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
-        if (!processHandle)
-            return TRUE;
-
-        WCHAR executablePath[MAX_PATH];
-        DWORD pathSize = MAX_PATH;
-        if (!QueryFullProcessImageNameW(processHandle, 0, executablePath, &pathSize)) 
+        if (mBuffer.isEmpty())
+            mBuffer.resize(256 * 1024);
+
+        NTSTATUS status;
+        ULONG needed = 0;
+        while ((status = ntQuerySystemInformation(SystemProcessInformation, mBuffer.data(), ULONG(mBuffer.size()), &needed))
+               == STATUS_INFO_LENGTH_MISMATCH_CODE)
         {
-            CloseHandle(processHandle);
-            return TRUE;
+            // 进程数在两次调用间可能继续增长，多留一些余量
+            mBuffer.resize(qMax<qsizetype>(qsizetype(needed) + 64 * 1024, mBuffer.size() * 2));
         }
-        CloseHandle(processHandle);
-
-        QString drivepath = QDir::cleanPath(QString::fromWCharArray(executablePath));
-
-        // 过滤
-        if (!monitor->filterWindows(drivepath))
-            return TRUE;
+        if (!NT_SUCCESS(status))
+            return false;
 
-        // 将进程信息添加到文件信息列表,因为是递归查找窗口，所以是逆序的，需要将数据往头部插入
-        QFileInfo fileInfo(drivepath);
-        monitor->mWindowsInfoList->insert(0,fileInfo);
+        const char *cursor = mBuffer.constData();
+        for (;;)
+        {
+            const SYSTEM_PROCESS_INFORMATION *info = reinterpret_cast<const SYSTEM_PROCESS_INFORMATION *>(cursor);
+            DWORD pid = DWORD(reinterpret_cast<quintptr>(info->UniqueProcessId));
 
-        QFileIconProvider iconProvider;
-        QStandardItem *item = new QStandardItem(iconProvider.icon(fileInfo), title);
-        monitor->mWindowsModel->insertRow(0, item);
-        return TRUE;
-    }, reinterpret_cast<LPARAM>(this));
+            // CreateTime 位于 winternl.h 中未公开的 Reserved1 字段内
+            LARGE_INTEGER createTime;
+            memcpy(&createTime, info->Reserved1 + 24, sizeof(createTime));
 
-    qDebug() << "Enumerate windows number: " << mWindowsInfoList->length();
-    taskMonitorMutex.unlock();
-}
+            if (pid != 0)
+                visit(pid, createTime.QuadPart / 10000 - 11644473600000LL, delta);
 
-// 过滤，需要过滤就返回false
-bool TaskMonitor::filterProcess(QString &text)
-{
-    foreach (QString filter, *mProcessFilter)
+            if (info->NextEntryOffset == 0)
+                break;
+            cursor += info->NextEntryOffset;
+        }
+    }
+    else
     {
-        if (text.startsWith(filter))
+        // 退化为 EnumProcesses：无法得到创建时间，已知的 pid 直接沿用
+        DWORD processes[1024], cbNeeded;
+        if (!EnumProcesses(processes, sizeof(processes), &cbNeeded))
             return false;
+
+        DWORD processCount = cbNeeded / sizeof(DWORD);
+        for (DWORD i = 0; i < processCount; ++i)
+            visit(processes[i], -1, delta);
     }
 
-    QFileInfo fileInfo(text);
-    if (mProcessInfoList->contains(fileInfo) && mFilterMode==FilterMode::Clear)
-        return false;
+    // 本轮未出现的进程即为已退出
+    for (auto it = mEntries.begin(); it != mEntries.end(); )
+    {
+        if (it->generation == mGeneration)
+        {
+            ++it;
+            continue;
+        }
+        if (delta != nullptr && it->valid)
+            delta->removed.append(*it);
+        it = mEntries.erase(it);
+    }
 
     return true;
 }
 
-// 过滤，需要过滤就返回false
-bool TaskMonitor::filterWindows(QString &text)
+void ProcessSnapshot::clear()
+{
+    mEntries.clear();
+}
+
+const QHash<DWORD, ProcessEntry> &ProcessSnapshot::entries() const
 {
-    foreach (QString filter, *mWindowsFilter)
+    return mEntries;
+}
+
+void ProcessSnapshot::visit(DWORD pid, qint64 creationTime, ProcessDelta *delta)
+{
+    auto it = mEntries.find(pid);
+    if (it != mEntries.end())
     {
-        if (text.startsWith(filter))
-            return false;
+        if (creationTime < 0 || it->creationTime == creationTime)
+        {
+            it->generation = mGeneration;
+            return;
+        }
+
+        // pid 已被新进程复用
+        if (delta != nullptr && it->valid)
+            delta->removed.append(*it);
+        mEntries.erase(it);
     }
 
-    return true;
+    ProcessEntry entry{pid, creationTime, TaskInfo(), false, mGeneration};
+    qint64 resolvedTime = 0;
+    entry.valid = TaskMonitor::queryProcess(pid, &entry.taskInfo, &resolvedTime);
+    if (creationTime < 0)
+        entry.creationTime = resolvedTime;
+
+    mEntries.insert(pid, entry);
+    if (delta != nullptr && entry.valid)
+        delta->added.append(entry);
 }
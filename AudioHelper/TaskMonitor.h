@@ -15,17 +15,46 @@
 #include <Shlobj.h>
 
 #include <QObject>
-#include <QStandardItemModel>
-#include <QFileIconProvider>
 #include <QDir>
-#include <QThread>
-#include <QMutex>
-#include "AudioCustom.h"
 #include <QThreadPool>
+#include "AudioCustom.h"
+#include "ExeInfoCache.h"
+#include "TaskListModel.h"
+#include "RuleIndex.h"
+#include "ProcessRowSet.h"
 
 typedef QList<TaskInfo> TaskInfoList;
 
-inline QMutex taskMonitorMutex;
+struct ProcessEntry {
+    DWORD pid;
+    qint64 creationTime;    // 与pid共同作为进程的唯一标识，单位：毫秒
+    TaskInfo taskInfo;
+    bool valid;             // 无权限访问的进程也会记录，但不会出现在增量中
+    uint generation;
+};
+
+struct ProcessDelta {
+    QList<ProcessEntry> added;
+    QList<ProcessEntry> removed;
+};
+
+// 持久化的进程快照，只解析新出现的进程，并给出新增/退出的增量
+class ProcessSnapshot
+{
+public:
+    ProcessSnapshot();
+
+    bool refresh(ProcessDelta *delta = nullptr);
+    void clear();
+    const QHash<DWORD, ProcessEntry> &entries() const;
+
+private:
+    void visit(DWORD pid, qint64 creationTime, ProcessDelta *delta);
+
+    QHash<DWORD, ProcessEntry> mEntries;
+    QByteArray mBuffer;
+    uint mGeneration;
+};
 
 class TaskMonitor : public QObject
 {
@@ -46,39 +75,57 @@ public:
     explicit TaskMonitor(QObject *parent = nullptr);
     ~TaskMonitor();
 
-    QStandardItemModel* getProcessModel();
-    QStandardItemModel* getWindowsModel();
+    TaskListModel* getProcessModel();
+    TaskListModel* getWindowsModel();
     QString filePath(const QModelIndex& index, TaskMode mode);
     void setFilter(QStringList& headers, TaskMode mode);
     void setFilter(FilterMode filterMode);
 
     static void getProcessList(TaskInfoList *taskInfoList);
     static void getWindowsList(TaskInfoList *taskInfoList);
+    static bool queryProcess(DWORD processId, TaskInfo *taskInfo, qint64 *creationTime = nullptr);
+    static bool queryWindow(HWND hwnd, TaskInfo *taskInfo);
 
 public slots:
     void update();
 
 private slots:
-    void updateModel();
-
-signals:
-    void backgroundUpdate();
+    void onExeInfoResolved(const QString &path);
 
 private:
-    void updateProcessModel();
-    void updateWindowsModel();
-    bool filterProcess(QString& text);
-    bool filterWindows(QString& text);
-    static QString getExeDescription(const QString &filePath);
-
-    QStandardItemModel* mProcessModel;
-    QStandardItemModel* mWindowsModel;
-    QFileInfoList *mProcessInfoList;
-    QFileInfoList *mWindowsInfoList;
-    QStringList *mProcessFilter;
-    QStringList *mWindowsFilter;
+    // 一次刷新所用的过滤条件，按值交给后台任务
+    struct TaskFilter {
+        PrefixTable prefixes;   // 已编译的排除前缀
+        FilterMode mode;
+        bool reset;
+    };
+
+    void startProcessUpdate();
+    void startWindowsUpdate();
+    void finishProcessUpdate();
+    void finishWindowsUpdate();
+    void collectProcesses(const TaskFilter &filter);
+    void collectWindows(const TaskFilter &filter);
+    void appendProcessRow(const ProcessEntry &entry, const TaskFilter &filter, TaskRowList *rows);
+    bool filterWindows(const QString &text, const TaskFilter &filter) const;
+    static bool fillExeInfo(TaskRow *row, bool withName);
+    static void resolveRows(TaskRowList *rows, bool withName);
+
+    // 界面线程
+    TaskListModel* mProcessModel;
+    TaskListModel* mWindowsModel;
+    PrefixTable mProcessFilter;
+    PrefixTable mWindowsFilter;
     FilterMode mFilterMode;
-    QThread *mThread;
+    bool mProcessReset;
+    bool mProcessBusy;
+    bool mProcessQueued;
+    bool mWindowsBusy;
+    bool mWindowsQueued;
+
+    // 仅由后台任务访问，同一时间只有一个进程任务在运行
+    ProcessSnapshot *mProcessSnapshot;
+    ProcessRowSet *mProcessRows;            // 已展示的进程，用于过滤与去重
     QThreadPool mThreadPool;
 };
 
@@ -0,0 +1,205 @@
+/**
+ * @file WeightEngine.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 16:31:07
+ * @brief 权重计算引擎：复用预分配的缓冲区，稳态下评分过程不做堆分配
+ */
+
+#include "WeightEngine.h"
+#include <QVarLengthArray>
+#include "Metrics.h"
+#include "Trace.h"
+
+// 路径表的上限，超过后整体重置，防止长时间运行后无限增长
+static const int MAX_PATH_COUNT = 4096;
+
+WeightEngine::WeightEngine()
+    : mTick(0)
+    , mPass(0)
+    , mEpoch(1)
+{
+    mMatchOffsets.append(0);
+}
+
+void WeightEngine::setRules(const RelatedList &rules)
+{
+    mIndex.rebuild(rules);
+
+    int count = mIndex.size();
+    mIsDir.resize(count);
+    for (int slot = 0; slot < count; ++slot)
+        mIsDir[slot] = mIndex.at(slot).typeInfo.type == "文件夹";
+
+    // 缓冲区一次分配到位，评分时只做代数标记
+    mScores.fill(0, count);
+    mTickStamps.fill(0, count);
+    mPassStamps.fill(0, count);
+    mTouched.clear();
+    mTouched.reserve(count);
+
+    rebuildMatches();
+}
+
+const RuleIndex &WeightEngine::rules() const
+{
+    return mIndex;
+}
+
+int WeightEngine::resolve(const QString &path, PathHandle &handle)
+{
+    TRACE_SCOPE("WeightEngine::resolve");
+    if (handle.epoch == mEpoch && handle.id >= 0)
+        return handle.id;
+
+    int id = mPathIds.value(path, -1);
+    if (id < 0)
+    {
+        if (mPaths.size() >= MAX_PATH_COUNT)
+            resetPaths();
+
+        id = int(mPaths.size());
+        mPaths.append(path);
+        mPathIds.insert(path, id);
+        mPathStamps.append(0);
+        appendMatches(path);
+    }
+
+    handle.id = id;
+    handle.epoch = mEpoch;
+    return id;
+}
+
+void WeightEngine::begin()
+{
+    // 代数回绕时清空标记，避免与旧标记冲突
+    if (++mTick == 0)
+    {
+        mTickStamps.fill(0);
+        mTick = 1;
+    }
+    mTouched.clear();
+}
+
+void WeightEngine::beginPass()
+{
+    if (++mPass == 0)
+    {
+        mPassStamps.fill(0);
+        mPathStamps.fill(0);
+        mPass = 1;
+    }
+}
+
+void WeightEngine::addTask(int path, char weight, bool dedupePath)
+{
+    // 避免多进程任务的重复加权
+    if (dedupePath)
+    {
+        if (mPathStamps.at(path) == mPass)
+            return;
+        mPathStamps[path] = mPass;
+    }
+
+    for (int i = mMatchOffsets.at(path); i < mMatchOffsets.at(path + 1); ++i)
+    {
+        int slot = mMatchSlots.at(i);
+        if (mPassStamps.at(slot) == mPass)
+            continue;
+        mPassStamps[slot] = mPass;
+        score(slot) += weight;
+    }
+}
+
+void WeightEngine::addSceneWeight(const QString &tag, char weight)
+{
+    for (int slot : std::as_const(mTouched))
+    {
+        if (mIndex.at(slot).typeInfo.tag == tag)
+            mScores[slot] += weight;
+    }
+}
+
+int WeightEngine::pick(const IgnoreMap *ignoreMap, char *weight) const
+{
+    static MetricCounter &ignoreHits = Metrics::counter("audio_ignore_hits_total", "Candidate rules skipped because their device failed repeatedly");
+
+    int target = -1;
+    char targetWeight = 0;
+    bool isDir = false;
+
+    for (int slot : mTouched)
+    {
+        const RelatedItem &related = mIndex.at(slot);
+
+        // 跳过排除项
+        if (ignoreMap != nullptr && ignoreMap->value(related.audioDeviceInfo.id, 0) >= 3)
+        {
+            ignoreHits.add();
+            continue;
+        }
+
+        char value = mScores.at(slot);
+        if (value > targetWeight)
+        {
+            target = slot;
+            targetWeight = value;
+            isDir = mIsDir.at(slot);
+        }
+
+        // 降低文件夹的优先级但不降低权重
+        if (value == targetWeight && isDir && !mIsDir.at(slot))
+        {
+            target = slot;
+            isDir = false;
+        }
+    }
+
+    if (weight != nullptr)
+        *weight = targetWeight;
+    return targetWeight == 0 ? -1 : target;
+}
+
+char &WeightEngine::score(int slot)
+{
+    // 本轮首次加权时才清零并记录顺序
+    if (mTickStamps.at(slot) != mTick)
+    {
+        mTickStamps[slot] = mTick;
+        mScores[slot] = 0;
+        mTouched.append(slot);
+    }
+    return mScores[slot];
+}
+
+void WeightEngine::appendMatches(const QString &path)
+{
+    // 按规则列表中的顺序存放，保持与原先线性扫描相同的加权顺序
+    QVarLengthArray<int, 16> matched;
+    mIndex.match(path, [&matched](int slot) { matched.append(slot); });
+    std::sort(matched.begin(), matched.end());
+
+    for (int slot : matched)
+        mMatchSlots.append(slot);
+    mMatchOffsets.append(int(mMatchSlots.size()));
+}
+
+void WeightEngine::rebuildMatches()
+{
+    mMatchSlots.clear();
+    mMatchOffsets.clear();
+    mMatchOffsets.append(0);
+    for (const QString &path : std::as_const(mPaths))
+        appendMatches(path);
+}
+
+void WeightEngine::resetPaths()
+{
+    // 旧句柄的 epoch 失效，调用方下次 resolve 时会重新驻留
+    mPathIds.clear();
+    mPaths.clear();
+    mPathStamps.clear();
+    mMatchSlots.clear();
+    mMatchOffsets.clear();
+    mMatchOffsets.append(0);
+    mEpoch++;
+}
@@ -0,0 +1,153 @@
+#ifndef WEIGHTENGINE_H
+#define WEIGHTENGINE_H
+
+/**
+ * @file WeightEngine.h
+ * @author Asteri5m
+ * @date 2026-10-16 16:31:07
+ * @brief 权重计算引擎：复用预分配的缓冲区，稳态下评分过程不做堆分配；只依赖QtCore
+ */
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include "RuleIndex.h"
+#include "AudioTypes.h"
+
+// key: device->id, value: times. ignore Related when value > 3
+typedef QMap<QString, quint8> IgnoreMap;
+
+// 路径句柄：由引擎驻留路径后分配，调用方缓存后每轮评分无需再计算哈希
+struct PathHandle {
+    int id = -1;
+    uint epoch = 0;
+};
+
+class WeightEngine
+{
+public:
+    WeightEngine();
+
+    void setRules(const RelatedList &rules);
+    const RuleIndex &rules() const;
+
+    // 驻留路径，句柄过期（路径表被重置）时自动重新驻留
+    int resolve(const QString &path, PathHandle &handle);
+
+    // 一轮评分由 begin 开始，每一次加权遍历由 beginPass 开始
+    void begin();
+    void beginPass();
+    void addTask(int path, char weight, bool dedupePath = true);
+    void addSceneWeight(const QString &tag, char weight);
+
+    // 返回胜出规则的槽位，无目标时返回 -1
+    int pick(const IgnoreMap *ignoreMap, char *weight = nullptr) const;
+
+private:
+    char &score(int slot);
+    void appendMatches(const QString &path);
+    void rebuildMatches();
+    void resetPaths();
+
+    RuleIndex mIndex;
+    QVector<bool> mIsDir;           // 按槽位预先计算，避免评分时比较字符串
+
+    // 按槽位的评分缓冲区，以代数标记代替清空
+    QVector<char> mScores;
+    QVector<uint> mTickStamps;
+    QVector<uint> mPassStamps;
+    QVector<int> mTouched;          // 本轮被加权的槽位，保持首次加权的顺序
+    uint mTick;
+    uint mPass;
+
+    // 路径驻留表，以及每个路径命中的槽位（扁平存放）
+    QHash<QString, int> mPathIds;
+    QVector<QString> mPaths;
+    QVector<uint> mPathStamps;
+    QVector<int> mMatchOffsets;
+    QVector<int> mMatchSlots;
+    uint mEpoch;
+};
+
+// 新启动进程的补偿时长
+static const qint64 PROCESS_COMPENSATE_MSEC = 10000;
+
+// 评分所用的任务记录，缓存路径句柄以免每轮重新计算
+struct TaskRecord {
+    quintptr id;
+    TaskInfo taskInfo;
+    qint64 startTime;   // 进程的创建时间，窗口为0
+    PathHandle handle;
+};
+
+struct ScoreOptions {
+    bool windows;               // 统计窗口
+    bool processes;             // 统计进程
+    QString sceneTag;           // 场景加权的标签，为空时不加权
+    qint64 now;                 // 当前时间，用于新进程补偿
+    const IgnoreMap *ignoreMap;
+};
+
+struct ScoreResult {
+    int slot;                   // 胜出规则的槽位，无目标时为 -1
+    char weight;
+    qint64 nextExpire;          // 最近一个新进程补偿到期的剩余毫秒数，没有时为0
+};
+
+// 评分：结果只取决于规则、选项与任务快照，engine 仅提供复用的缓冲区与路径缓存。
+// 任务容器需支持双向迭代，元素为 TaskRecord，最近的任务排在末尾
+template<typename WindowTasks, typename ProcessTasks>
+ScoreResult scoreTasks(WeightEngine &engine, const ScoreOptions &options, WindowTasks &windowTasks, ProcessTasks &processTasks)
+{
+    ScoreResult result{-1, 0, 0};
+    engine.begin();
+
+    // 窗口权重为2，同一路径只计一次
+    if (options.windows)
+    {
+        engine.beginPass();
+        for (auto it = windowTasks.end(); it != windowTasks.begin();)
+        {
+            --it;
+            engine.addTask(engine.resolve(it->taskInfo.path, it->handle), 2);
+        }
+    }
+
+    if (options.processes)
+    {
+        engine.beginPass();
+        for (auto it = processTasks.end(); it != processTasks.begin();)
+        {
+            --it;
+            engine.addTask(engine.resolve(it->taskInfo.path, it->handle), 1);
+        }
+
+        // 对应刚打开的游戏，初始化需要一段时间，
+        // 但是此时没有窗口，无法得到加权，导致部分程序初始化了错误的音频设备，
+        // 并且该程序无法切换音频设备，那么此时就需要"预处理"，提取准备好音频设备
+        engine.beginPass();
+        for (auto it = processTasks.end(); it != processTasks.begin();)
+        {
+            --it;
+
+            // 仅补偿10s内打开的进程
+            qint64 survivalTime = options.now - it->startTime;
+            if (survivalTime > PROCESS_COMPENSATE_MSEC)
+                continue;
+
+            qint64 remaining = PROCESS_COMPENSATE_MSEC - survivalTime + 1;
+            result.nextExpire = result.nextExpire == 0 ? remaining : qMin(result.nextExpire, remaining);
+            engine.addTask(engine.resolve(it->taskInfo.path, it->handle), 2, false);
+        }
+    }
+
+    // 计算特殊场景加权
+    if (!options.sceneTag.isEmpty())
+        engine.addSceneWeight(options.sceneTag, 1);
+
+    result.slot = engine.pick(options.ignoreMap, &result.weight);
+    return result;
+}
+
+#endif // WEIGHTENGINE_H
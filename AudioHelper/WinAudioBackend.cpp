@@ -0,0 +1,298 @@
+/**
+ * @file WinAudioBackend.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 20:14:32
+ * @brief 音频后端的 Windows Core Audio 实现
+ */
+
+//音频相关
+#include <Mmdeviceapi.h>
+#include <functiondiscoverykeys.h>
+#include <QDebug>
+#include "PolicyConfig.h"
+#include "WinAudioBackend.h"
+#include "LogCategory.h"
+#include "Trace.h"
+
+AudioBackend *AudioBackend::createPlatformBackend()
+{
+    return new WinAudioBackend;
+}
+
+// 每个调用线程按需初始化一次COM，并持有自己的设备枚举器，线程结束时依次释放。
+// COM接口不能未经封送跨套间调用，界面线程与后台服务线程因此各用各的枚举器
+struct ComThread {
+    HRESULT hr = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+    IMMDeviceEnumerator *enumerator = nullptr;
+
+    ~ComThread()
+    {
+        if (enumerator != nullptr)
+            enumerator->Release();
+        if (SUCCEEDED(hr))
+            CoUninitialize();
+    }
+};
+
+static ComThread &comThread()
+{
+    thread_local ComThread thread;
+    return thread;
+}
+
+static bool ensureCom()
+{
+    // 线程已按其它模式初始化时COM依然可用
+    HRESULT hr = comThread().hr;
+    return SUCCEEDED(hr) || hr == RPC_E_CHANGED_MODE;
+}
+
+static IMMDeviceEnumerator *threadEnumerator()
+{
+    if (!ensureCom())
+    {
+        qDebug("Failed to initialize COM.");
+        return nullptr;
+    }
+
+    ComThread &thread = comThread();
+    if (thread.enumerator != nullptr)
+        return thread.enumerator;
+
+    HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), NULL, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), (void**)&thread.enumerator);
+    if (FAILED(hr))
+    {
+        qDebug("Failed to create device enumerator.");
+        thread.enumerator = nullptr;
+    }
+    return thread.enumerator;
+}
+
+// 设备变化通知，回调发生在系统线程中，只负责使缓存失效
+class WinAudioBackend::NotificationClient : public IMMNotificationClient
+{
+public:
+    explicit NotificationClient(WinAudioBackend *backend)
+        : mRef(1)
+        , mBackend(backend)
+    {
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return InterlockedIncrement(&mRef);
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        ULONG ref = InterlockedDecrement(&mRef);
+        if (ref == 0)
+            delete this;
+        return ref;
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppvObject) override
+    {
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IMMNotificationClient))
+        {
+            *ppvObject = static_cast<IMMNotificationClient *>(this);
+            AddRef();
+            return S_OK;
+        }
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceStateChanged(LPCWSTR, DWORD) override
+    {
+        mBackend->invalidateDevices();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceAdded(LPCWSTR) override
+    {
+        mBackend->invalidateDevices();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceRemoved(LPCWSTR) override
+    {
+        mBackend->invalidateDevices();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDefaultDeviceChanged(EDataFlow flow, ERole role, LPCWSTR pwstrDefaultDeviceId) override
+    {
+        // 与查询时使用的角色保持一致
+        if (flow == eRender && role == eMultimedia)
+            mBackend->updateDefaultDevice(pwstrDefaultDeviceId ? QString::fromWCharArray(pwstrDefaultDeviceId) : QString());
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnPropertyValueChanged(LPCWSTR, const PROPERTYKEY key) override
+    {
+        if (key.fmtid == PKEY_Device_FriendlyName.fmtid && key.pid == PKEY_Device_FriendlyName.pid)
+            mBackend->invalidateDevices();
+        return S_OK;
+    }
+
+private:
+    LONG mRef;
+    WinAudioBackend *mBackend;
+};
+
+WinAudioBackend::WinAudioBackend(QObject *parent)
+    : AudioBackend(parent)
+    , mEnumerator(nullptr)
+    , mNotificationClient(nullptr)
+{
+    if (!ensureCom())
+    {
+        qDebug("Failed to initialize COM.");
+        return;
+    }
+
+    HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), NULL, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), (void**)&mEnumerator);
+    if (FAILED(hr))
+    {
+        qDebug("Failed to create device enumerator.");
+        mEnumerator = nullptr;
+        return;
+    }
+
+    mNotificationClient = new NotificationClient(this);
+    hr = mEnumerator->RegisterEndpointNotificationCallback(mNotificationClient);
+    if (FAILED(hr))
+    {
+        // 收不到通知时缓存不会自动失效，设备插拔后需重启应用
+        qWarning() << "RegisterEndpointNotificationCallback failed, error:" << QString::number(hr, 16);
+        mNotificationClient->Release();
+        mNotificationClient = nullptr;
+    }
+}
+
+WinAudioBackend::~WinAudioBackend()
+{
+    if (mNotificationClient != nullptr)
+    {
+        mEnumerator->UnregisterEndpointNotificationCallback(mNotificationClient);
+        mNotificationClient->Release();
+    }
+    if (mEnumerator != nullptr)
+        mEnumerator->Release();
+}
+
+bool WinAudioBackend::enumerateDevices(AudioDeviceList *audioDeviceList)
+{
+    TRACE_SCOPE("WinAudioBackend::enumerateDevices");
+    IMMDeviceEnumerator *enumerator = threadEnumerator();
+    if (enumerator == nullptr)
+        return false;
+
+    qCDebug(lcAudioBackend, "Audio Output Devices:");
+
+    // 获取设备集合
+    IMMDeviceCollection* pDeviceCollection = NULL;
+    HRESULT hr = enumerator->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE, &pDeviceCollection);
+    if (FAILED(hr))
+    {
+        qDebug("Failed to enumerate audio endpoints.");
+        return false;
+    }
+
+    UINT deviceCount = 0;
+    pDeviceCollection->GetCount(&deviceCount);
+    // 遍历设备
+    for (UINT i = 0; i < deviceCount; i++)
+    {
+        IMMDevice* pDevice = NULL;
+        if (FAILED(pDeviceCollection->Item(i, &pDevice)))
+            continue;
+
+        // 获取设备ID
+        LPWSTR pwszID = NULL;
+        pDevice->GetId(&pwszID);
+
+        IPropertyStore* pProps = NULL;
+        hr = pDevice->OpenPropertyStore(STGM_READ, &pProps);
+        if (SUCCEEDED(hr))
+        {
+            // 获取设备友好名字
+            PROPVARIANT varName;
+            PropVariantInit(&varName);
+            hr = pProps->GetValue(PKEY_Device_FriendlyName, &varName);
+            if (SUCCEEDED(hr))
+            {
+                QString deviceName = QString::fromWCharArray(varName.pwszVal);
+                QString deviceID = QString::fromWCharArray(pwszID);
+                qCDebug(lcAudioBackend) << "Device" << i + 1 << ":" << deviceID << "|" << deviceName;
+                PropVariantClear(&varName);
+                audioDeviceList->insert(deviceName, deviceID);
+            }
+
+            pProps->Release();
+        }
+        CoTaskMemFree(pwszID);
+        pDevice->Release();
+    }
+    pDeviceCollection->Release();
+    return true;
+}
+
+bool WinAudioBackend::queryDefaultDevice(QString *deviceId)
+{
+    IMMDeviceEnumerator *enumerator = threadEnumerator();
+    if (enumerator == nullptr)
+        return false;
+
+    // 获取设备
+    IMMDevice* pDefaultPlaybackDevice = NULL;
+    HRESULT hr = enumerator->GetDefaultAudioEndpoint(eRender, eMultimedia, &pDefaultPlaybackDevice);
+    if (FAILED(hr))
+        return false;
+
+    // 获取设备ID
+    LPWSTR pwszID = NULL;
+    hr = pDefaultPlaybackDevice->GetId(&pwszID);
+    if (SUCCEEDED(hr))
+    {
+        *deviceId = QString::fromWCharArray(pwszID);
+        CoTaskMemFree(pwszID);
+    }
+    pDefaultPlaybackDevice->Release();
+    return SUCCEEDED(hr);
+}
+
+bool WinAudioBackend::applyDefaultDevice(const QString &deviceId)
+{
+    TRACE_SCOPE("WinAudioBackend::applyDefaultDevice");
+    if (!ensureCom())
+        return false;
+
+    // 将QString转换为UTF-16编码的wchar_t数组
+    const wchar_t* wcharStr = reinterpret_cast<const wchar_t*>(deviceId.utf16());
+    // 将wchar_t数组转换为LPWSTR
+    LPWSTR devID = const_cast<LPWSTR>(wcharStr);
+    IPolicyConfigVista* pPolicyConfig = nullptr;
+    ERole reserved = eConsole;
+    char* errorMsg = nullptr;
+
+    HRESULT hr = CoCreateInstance(__uuidof(CPolicyConfigVistaClient),
+                                  NULL, CLSCTX_ALL, __uuidof(IPolicyConfigVista), (LPVOID*)&pPolicyConfig);
+    if (SUCCEEDED(hr)) {
+        hr = pPolicyConfig->SetDefaultEndpoint(devID, reserved);
+        pPolicyConfig->Release();
+    }
+
+    // 成功返回true
+    if (SUCCEEDED(hr))
+        return true;
+
+    FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+                   NULL, hr, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&errorMsg, 0, NULL);
+    qCritical() << "SetDefaultEndpoint failed - Error code:" << QString::number(hr, 16).toUpper().toUtf8().constData()
+                << ". Description:" << QString::fromLocal8Bit(errorMsg).trimmed().toUtf8().constData();
+    LocalFree(errorMsg);
+    return false;
+}
+
@@ -0,0 +1,35 @@
+#ifndef WINAUDIOBACKEND_H
+#define WINAUDIOBACKEND_H
+
+/**
+ * @file WinAudioBackend.h
+ * @author Asteri5m
+ * @date 2026-10-16 20:14:32
+ * @brief 音频后端的 Windows Core Audio 实现
+ */
+
+#include "AudioBackend.h"
+
+struct IMMDeviceEnumerator;
+
+// Windows Core Audio：查询使用调用线程自己的设备枚举器，另持有一个枚举器注册设备变化通知
+class WinAudioBackend : public AudioBackend
+{
+    Q_OBJECT
+public:
+    explicit WinAudioBackend(QObject *parent = nullptr);
+    ~WinAudioBackend();
+
+protected:
+    bool enumerateDevices(AudioDeviceList *audioDeviceList) override;
+    bool queryDefaultDevice(QString *deviceId) override;
+    bool applyDefaultDevice(const QString &deviceId) override;
+
+private:
+    class NotificationClient;
+
+    IMMDeviceEnumerator *mEnumerator;   // 仅用于注册与注销通知，属于创建后端的线程
+    NotificationClient *mNotificationClient;
+};
+
+#endif // WINAUDIOBACKEND_H
@@ -0,0 +1,152 @@
+/**
+ * @file WinTaskEventSource.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 10:12:40
+ * @brief 任务事件源的 Windows 实现
+ */
+
+#include "WinTaskEventSource.h"
+#include <QDateTime>
+#include <QDebug>
+
+WinTaskEventSource *WinTaskEventSource::sInstance = nullptr;
+
+WinTaskEventSource::WinTaskEventSource(QObject *parent)
+    : TaskEventSource(parent)
+    , mProcessTimer(new QTimer(this))
+{
+    // 进程没有廉价的创建通知，这里只比对进程快照，新进程才会去解析
+    mProcessTimer->setInterval(1000);
+    connect(mProcessTimer, SIGNAL(timeout()), this, SLOT(checkProcesses()));
+}
+
+WinTaskEventSource::~WinTaskEventSource()
+{
+    stop();
+}
+
+bool WinTaskEventSource::start()
+{
+    if (!mHooks.isEmpty())
+        return true;
+
+    // 回调只能是静态函数，同一时间只允许一个实例挂钩
+    if (sInstance != nullptr && sInstance != this)
+    {
+        qWarning() << "WinEventHook is already in use.";
+        return false;
+    }
+    sInstance = this;
+
+    const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+    const DWORD ranges[][2] = {
+        {EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND},
+        {EVENT_OBJECT_DESTROY, EVENT_OBJECT_HIDE},          // DESTROY、SHOW、HIDE
+        {EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE},
+    };
+
+    for (const auto &range : ranges)
+    {
+        HWINEVENTHOOK hook = SetWinEventHook(range[0], range[1], nullptr, winEventProc, 0, 0, flags);
+        if (hook == nullptr)
+        {
+            qWarning() << "SetWinEventHook failed, error:" << GetLastError();
+            stop();
+            return false;
+        }
+        mHooks.append(hook);
+    }
+
+    // 推送初始状态：EnumWindows 自顶向下枚举，逆序推送使最上层的窗口最后到达
+    QList<HWND> windows;
+    EnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL {
+        reinterpret_cast<QList<HWND> *>(lParam)->append(hwnd);
+        return TRUE;
+    }, reinterpret_cast<LPARAM>(&windows));
+
+    for (auto it = windows.rbegin(); it != windows.rend(); ++it)
+        handleWinEvent(EVENT_OBJECT_SHOW, *it);
+
+    checkProcesses();
+    mProcessTimer->start();
+
+    qDebug() << "Task event source started, windows:" << mWindows.size() << ", processes:" << mProcessSnapshot.entries().size();
+    return true;
+}
+
+void WinTaskEventSource::stop()
+{
+    mProcessTimer->stop();
+    for (HWINEVENTHOOK hook : mHooks)
+        UnhookWinEvent(hook);
+    mHooks.clear();
+    mProcessSnapshot.clear();
+    mWindows.clear();
+
+    if (sInstance == this)
+        sInstance = nullptr;
+}
+
+void WinTaskEventSource::checkProcesses()
+{
+    ProcessDelta delta;
+    if (!mProcessSnapshot.refresh(&delta)) {
+        qDebug() << "Failed to enumerate processes.";
+        return;
+    }
+
+    for (const ProcessEntry &entry : std::as_const(delta.removed))
+        emit taskEvent({TaskEvent::ProcessExited, entry.pid, entry.taskInfo, entry.creationTime});
+
+    for (const ProcessEntry &entry : std::as_const(delta.added))
+        emit taskEvent({TaskEvent::ProcessStarted, entry.pid, entry.taskInfo, entry.creationTime});
+}
+
+void CALLBACK WinTaskEventSource::winEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                               LONG idChild, DWORD eventThread, DWORD eventTime)
+{
+    Q_UNUSED(hook);
+    Q_UNUSED(eventThread);
+    Q_UNUSED(eventTime);
+
+    // 只关心窗口本身，忽略窗口内的子对象
+    if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF || hwnd == nullptr)
+        return;
+
+    if (sInstance != nullptr)
+        sInstance->handleWinEvent(event, hwnd);
+}
+
+void WinTaskEventSource::handleWinEvent(DWORD event, HWND hwnd)
+{
+    TaskInfo taskInfo;
+
+    switch (event) {
+    case EVENT_OBJECT_HIDE:
+    case EVENT_OBJECT_DESTROY:
+        if (mWindows.remove(hwnd))
+            emit taskEvent({TaskEvent::WindowClosed, reinterpret_cast<quintptr>(hwnd), TaskInfo(), 0});
+        return;
+
+    case EVENT_OBJECT_SHOW:
+    case EVENT_OBJECT_NAMECHANGE:
+        // 与 TaskMonitor::getWindowsList 保持一致：仅统计可见且有标题的顶层窗口
+        if (mWindows.contains(hwnd) || GetAncestor(hwnd, GA_ROOT) != hwnd)
+            return;
+        if (!TaskMonitor::queryWindow(hwnd, &taskInfo))
+            return;
+        mWindows.insert(hwnd);
+        emit taskEvent({TaskEvent::WindowOpened, reinterpret_cast<quintptr>(hwnd), taskInfo, 0});
+        return;
+
+    case EVENT_SYSTEM_FOREGROUND:
+        if (!TaskMonitor::queryWindow(hwnd, &taskInfo))
+            return;
+        mWindows.insert(hwnd);
+        emit taskEvent({TaskEvent::ForegroundChanged, reinterpret_cast<quintptr>(hwnd), taskInfo, 0});
+        return;
+
+    default:
+        return;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef WINTASKEVENTSOURCE_H
+#define WINTASKEVENTSOURCE_H
+
+/**
+ * @file WinTaskEventSource.h
+ * @author Asteri5m
+ * @date 2026-10-16 10:12:40
+ * @brief 任务事件源的 Windows 实现
+ */
+
+#include <QSet>
+#include "TaskEventSource.h"
+#include "TaskMonitor.h"
+
+// Windows 实现：窗口变化通过 WinEventHook 推送，进程变化通过低频比对进程快照得到
+class WinTaskEventSource : public TaskEventSource
+{
+    Q_OBJECT
+public:
+    explicit WinTaskEventSource(QObject *parent = nullptr);
+    ~WinTaskEventSource();
+
+public slots:
+    bool start() override;
+    void stop() override;
+
+private slots:
+    void checkProcesses();
+
+private:
+    static void CALLBACK winEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                      LONG idChild, DWORD eventThread, DWORD eventTime);
+    void handleWinEvent(DWORD event, HWND hwnd);
+
+    static WinTaskEventSource *sInstance;
+
+    QList<HWINEVENTHOOK> mHooks;
+    ProcessSnapshot mProcessSnapshot;
+    QSet<HWND> mWindows;
+    QTimer *mProcessTimer;
+};
+
+#endif // WINTASKEVENTSOURCE_H
@@ -0,0 +1,251 @@
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+/**
+ * @file BinaryLog.h
+ * @author Asteri5m
+ * @date 2026-10-16 21:48:06
+ * @brief 二进制日志格式的编码与解码，程序和 logdump 工具共用，只依赖 QtCore
+ *
+ * 文件结构（只追加，可直接内存映射读取）：
+ *   文件头   "LDLG" + 版本(1字节)
+ *   会话记录 0xF1 + 绝对时间(varint，毫秒)             每次打开文件时写入，重置时间基准与标签表
+ *   标签记录 0xF0 + 标签id(varint) + 长度(varint) + UTF-8
+ *   日志记录 QtMsgType(1字节) + 时间差(zigzag varint) + 标签id(varint) + 长度(varint) + UTF-8
+ * 末尾的半条记录（写入中途崩溃）在解码时忽略；程序再次打开文件时用 validSize 找到最后一条完整记录并截断，
+ * 否则之后追加的会话都排在损坏数据之后，无法解码。
+ */
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QList>
+#include <cstring>
+
+static const char BINARY_LOG_MAGIC[4] = {'L', 'D', 'L', 'G'};
+static const quint8 BINARY_LOG_VERSION = 1;
+static const int BINARY_LOG_HEADER_SIZE = 5;
+
+enum BinaryLogRecordType : quint8 {
+    BinaryLogTagRecord     = 0xF0,
+    BinaryLogSessionRecord = 0xF1,
+};
+
+// 文本日志中的级别文字，logdump 输出时保持与文本日志一致
+inline QLatin1String logLevelText(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return QLatin1String("DEBUG");
+    case QtInfoMsg:
+        return QLatin1String("INFO ");
+    case QtWarningMsg:
+        return QLatin1String("WARN ");
+    case QtCriticalMsg:
+        return QLatin1String("ERROR");
+    case QtFatalMsg:
+        return QLatin1String("FATAL");
+    }
+    return QLatin1String("     ");
+}
+
+// QtMsgType 的数值不按严重程度排列，过滤时换算成 0(DEBUG) ~ 4(FATAL)
+inline int logSeverity(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:    return 0;
+    case QtInfoMsg:     return 1;
+    case QtWarningMsg:  return 2;
+    case QtCriticalMsg: return 3;
+    case QtFatalMsg:    return 4;
+    }
+    return 0;
+}
+
+inline QString formatLogLine(QtMsgType type, qint64 time, const QString &tag, const QString &msg)
+{
+    return QString("%1 [%2] - %3 - %4\n")
+        .arg(QDateTime::fromMSecsSinceEpoch(time).toString("yyyy-MM-dd hh:mm:ss.zzz"),
+             logLevelText(type), tag, msg);
+}
+
+class BinaryLogEncoder
+{
+public:
+    BinaryLogEncoder() : mLastTime(0) {}
+
+    static void writeHeader(QByteArray *out)
+    {
+        out->append(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+        out->append(char(BINARY_LOG_VERSION));
+    }
+
+    // 新文件或重新打开文件时调用，之后的标签会重新登记
+    void beginSession(qint64 time, QByteArray *out)
+    {
+        mTags.clear();
+        mLastTime = time;
+        out->append(char(BinaryLogSessionRecord));
+        writeVarint(quint64(time), out);
+    }
+
+    void encode(QtMsgType type, qint64 time, const QString &tag, const QString &msg, QByteArray *out)
+    {
+        auto it = mTags.constFind(tag);
+        if (it == mTags.constEnd())
+        {
+            it = mTags.insert(tag, quint32(mTags.size()));
+            QByteArray name = tag.toUtf8();
+            out->append(char(BinaryLogTagRecord));
+            writeVarint(it.value(), out);
+            writeVarint(quint64(name.size()), out);
+            out->append(name);
+        }
+
+        // 系统时间可能回拨，时间差按有符号编码
+        qint64 delta = time - mLastTime;
+        mLastTime = time;
+
+        QByteArray payload = msg.toUtf8();
+        out->append(char(type));
+        writeVarint((quint64(delta) << 1) ^ quint64(delta >> 63), out);
+        writeVarint(it.value(), out);
+        writeVarint(quint64(payload.size()), out);
+        out->append(payload);
+    }
+
+    static void writeVarint(quint64 value, QByteArray *out)
+    {
+        while (value >= 0x80) {
+            out->append(char(value | 0x80));
+            value >>= 7;
+        }
+        out->append(char(value));
+    }
+
+private:
+    QHash<QString, quint32> mTags;
+    qint64 mLastTime;
+};
+
+// 直接在映射的内存上顺序解码，不拷贝整个文件
+class BinaryLogDecoder
+{
+public:
+    struct Entry {
+        QtMsgType type;
+        qint64 time;
+        QString tag;
+        QString msg;
+    };
+
+    BinaryLogDecoder(const uchar *data, qint64 size)
+        : mEnd(data + size)
+        , mPos(data)
+        , mTime(0)
+        , mTruncated(false)
+    {
+        mValid = size >= BINARY_LOG_HEADER_SIZE
+                 && memcmp(data, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)) == 0
+                 && data[4] == BINARY_LOG_VERSION;
+        if (mValid)
+            mPos += BINARY_LOG_HEADER_SIZE;
+    }
+
+    // 从文件开头逐条解码，返回最后一条完整记录的结束位置；文件头无效时返回0
+    static qint64 validSize(const uchar *data, qint64 size)
+    {
+        BinaryLogDecoder decoder(data, size);
+        if (!decoder.isValid())
+            return 0;
+
+        Entry entry;
+        while (decoder.next(&entry)) {}
+        return qint64(decoder.mPos - data);
+    }
+
+    bool isValid() const { return mValid; }
+    // 文件末尾存在不完整的记录
+    bool truncated() const { return mTruncated; }
+
+    // 读取下一条日志，到达末尾或遇到损坏数据时返回 false
+    bool next(Entry *entry)
+    {
+        while (mValid && mPos < mEnd)
+        {
+            const uchar *start = mPos;
+            quint8 recordType = *mPos++;
+            quint64 value, id, length;
+
+            if (recordType == BinaryLogSessionRecord)
+            {
+                if (!readVarint(&value))
+                    return fail(start);
+                mTime = qint64(value);
+                mTags.clear();
+                continue;
+            }
+
+            if (recordType == BinaryLogTagRecord)
+            {
+                if (!readVarint(&id) || !readVarint(&length) || quint64(mEnd - mPos) < length)
+                    return fail(start);
+                if (id != quint64(mTags.size()))
+                    return fail(start);
+                mTags.append(QString::fromUtf8(reinterpret_cast<const char *>(mPos), qsizetype(length)));
+                mPos += length;
+                continue;
+            }
+
+            if (recordType > QtInfoMsg)
+                return fail(start);
+
+            if (!readVarint(&value) || !readVarint(&id) || !readVarint(&length)
+                || quint64(mEnd - mPos) < length || id >= quint64(mTags.size()))
+                return fail(start);
+
+            mTime += qint64(value >> 1) ^ -qint64(value & 1);
+            entry->type = QtMsgType(recordType);
+            entry->time = mTime;
+            entry->tag = mTags.at(qsizetype(id));
+            entry->msg = QString::fromUtf8(reinterpret_cast<const char *>(mPos), qsizetype(length));
+            mPos += length;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    bool readVarint(quint64 *value)
+    {
+        quint64 result = 0;
+        for (int shift = 0; shift < 64 && mPos < mEnd; shift += 7)
+        {
+            uchar byte = *mPos++;
+            result |= quint64(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                *value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool fail(const uchar *start)
+    {
+        mTruncated = true;
+        mPos = start;
+        mValid = false;
+        return false;
+    }
+
+    const uchar *mEnd;
+    const uchar *mPos;
+    qint64 mTime;
+    QList<QString> mTags;
+    bool mValid;
+    bool mTruncated;
+};
+
+#endif // BINARYLOG_H
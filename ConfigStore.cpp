@@ -0,0 +1,173 @@
+/**
+ * @file ConfigStore.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 01:12:37
+ * @brief 键值配置表的内存缓存：启动时整表读入，读取只查内存，修改延迟合并后在一个事务中写回
+ */
+
+#include "ConfigStore.h"
+#include "Storage.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+// 第一次修改后最多等待的时间，期间的修改合并为一次提交
+static const int FLUSH_DELAY_MS = 500;
+// 提交失败后重试的间隔，数据库被占用或磁盘已满时不必频繁重试
+static const int RETRY_DELAY_MS = 5000;
+
+ConfigStore::ConfigStore(const QString &table, QObject *parent)
+    : QObject(parent)
+    , mTable(table)
+    , mCommitFailed(false)
+{
+    mFlushTimer.setSingleShot(true);
+    mFlushTimer.setInterval(FLUSH_DELAY_MS);
+    connect(&mFlushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+
+    load();
+}
+
+ConfigStore::~ConfigStore()
+{
+    // 结果无法再送回已析构的对象，最后一次提交等待完成
+    mFlushTimer.stop();
+    if (mDirty.isEmpty())
+        return;
+
+    Values values = takeDirty();
+    QString table = mTable;
+    Storage::instance().execute([table, values](QSqlDatabase &db) { commit(db, table, values); });
+}
+
+QString ConfigStore::value(const QString &key, const QString &defaultValue)
+{
+    auto it = mValues.constFind(key);
+    if (it != mValues.constEnd())
+        return it.value();
+
+    qDebug() << "Load config failed: select result is null of " + key;
+    if (!defaultValue.isNull()) {
+        mValues.insert(key, defaultValue);
+        markDirty(key);
+    }
+    return defaultValue;
+}
+
+bool ConfigStore::setValue(const QString &key, const QString &value)
+{
+    auto it = mValues.find(key);
+    if (it != mValues.end() && it.value() == value && !value.isNull())
+        return true;
+
+    if (mCommitFailed) {
+        qWarning() << "Config" << mTable << "is not writable, discard" << key << ":" << value;
+        return false;
+    }
+
+    qDebug() << "Insert Data, Key:" << key << ", value:" << value;
+    mValues.insert(key, value);
+    markDirty(key);
+    return true;
+}
+
+void ConfigStore::flush()
+{
+    mFlushTimer.stop();
+    if (mDirty.isEmpty())
+        return;
+
+    Values values = takeDirty();
+    QString table = mTable;
+    Storage::instance().query<bool>([table, values](QSqlDatabase &db) { return commit(db, table, values); },
+                                    this, [this, values](const bool &ok) { commitFinished(values, ok); });
+}
+
+ConfigStore::Values ConfigStore::takeDirty()
+{
+    Values values;
+    values.reserve(mDirty.size());
+    for (const QString &key : std::as_const(mDirty))
+        values.append(qMakePair(key, mValues.value(key)));
+    mDirty.clear();
+    return values;
+}
+
+bool ConfigStore::commit(QSqlDatabase &db, const QString &table, const Values &values)
+{
+    if (!db.isOpen()) {
+        qWarning() << "Database is not open, save" << table << "failed";
+        return false;
+    }
+    if (!db.transaction()) {
+        qCritical() << "Failed to save" << table << ":" << db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.prepare(QString("INSERT OR REPLACE INTO %1 (key, value) VALUES (:key, :value)").arg(table));
+    for (const auto &value : values)
+    {
+        query.bindValue(":key", value.first);
+        query.bindValue(":value", value.second);
+        if (!query.exec()) {
+            qCritical() << "Failed to save" << table << ":" << query.lastError().text();
+            db.rollback();
+            return false;
+        }
+    }
+
+    if (!db.commit()) {
+        qCritical() << "Failed to save" << table << ":" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+    return true;
+}
+
+void ConfigStore::commitFinished(const Values &values, bool ok)
+{
+    mCommitFailed = !ok;
+    if (ok)
+        return;
+
+    // 内存中的值没有变，整批重新登记，稍后连同新的修改一起重试
+    for (const auto &value : values)
+        mDirty.insert(value.first);
+    qWarning() << "Config" << mTable << "not saved, retry in" << RETRY_DELAY_MS << "ms";
+    if (!mFlushTimer.isActive())
+        mFlushTimer.start(RETRY_DELAY_MS);
+}
+
+void ConfigStore::load()
+{
+    // 启动时整表读取一次，之后的读取都不经过数据库
+    QString table = mTable;
+    mValues = Storage::instance().call<QHash<QString, QString>>([table](QSqlDatabase &db) {
+        QHash<QString, QString> values;
+        if (!db.isOpen()) {
+            qWarning() << "Database is not open, load" << table << "failed";
+            return values;
+        }
+
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        if (!query.exec(QString("SELECT key, value FROM %1").arg(table))) {
+            qCritical() << "Load" << table << "failed:" << query.lastError().text()
+                        << ",Error code:" << query.lastError().nativeErrorCode();
+            return values;
+        }
+
+        while (query.next())
+            values.insert(query.value(0).toString(), query.value(1).toString());
+        return values;
+    });
+}
+
+void ConfigStore::markDirty(const QString &key)
+{
+    mDirty.insert(key);
+    // 定时器已在计时则不重置，保证第一次修改后的写回延迟有上限
+    if (!mFlushTimer.isActive())
+        mFlushTimer.start(FLUSH_DELAY_MS);
+}
@@ -0,0 +1,55 @@
+#ifndef CONFIGSTORE_H
+#define CONFIGSTORE_H
+
+/**
+ * @file ConfigStore.h
+ * @author Asteri5m
+ * @date 2026-10-17 01:12:37
+ * @brief 键值配置表的内存缓存：启动时整表读入，读取只查内存，修改延迟合并后在一个事务中写回
+ *
+ * 表位于统一存储中，写回投递到数据库线程执行，调用方不等待磁盘。提交失败时相关的项重新登记为待写入并稍后重试，
+ * 重试成功之前 setValue 拒绝新的修改并返回 false。
+ */
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QSqlDatabase>
+
+class ConfigStore : public QObject
+{
+    Q_OBJECT
+public:
+    // table 需包含 key TEXT PRIMARY KEY, value TEXT 两列，且已由调用方创建
+    explicit ConfigStore(const QString &table, QObject *parent = nullptr);
+    // 析构时提交尚未写回的修改
+    ~ConfigStore();
+
+    // 表中没有该项时返回默认值；默认值非空时同时登记为待写入
+    QString value(const QString &key, const QString &defaultValue = QString());
+    // 返回 false 表示上一次提交失败且尚未重试成功，本次修改未被接受
+    bool setValue(const QString &key, const QString &value);
+
+public slots:
+    // 立即把全部待写入的项提交到数据库线程
+    void flush();
+
+private:
+    typedef QList<QPair<QString, QString>> Values;
+
+    void load();
+    void markDirty(const QString &key);
+    Values takeDirty();
+    // 在数据库线程中把一批修改写入表，返回是否提交成功
+    static bool commit(QSqlDatabase &db, const QString &table, const Values &values);
+    void commitFinished(const Values &values, bool ok);
+
+    QString mTable;
+    QHash<QString, QString> mValues;
+    QSet<QString> mDirty;
+    QTimer mFlushTimer;
+    bool mCommitFailed;
+};
+
+#endif // CONFIGSTORE_H
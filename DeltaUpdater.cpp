@@ -0,0 +1,326 @@
+/**
+ * @file DeltaUpdater.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 03:48:20
+ * @brief 增量更新：按发布附带的文件清单比对安装目录，只下载有变化的文件，重启时原地替换
+ */
+
+#include "DeltaUpdater.h"
+#include "UpdateDownloader.h"
+#include "Trace.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QtConcurrent>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+// 暂存目录中记录本次需要替换的文件，每行一个相对路径
+static const QString STAGE_LIST = "delta.list";
+static const QString OLD_SUFFIX = ".old";
+
+static QByteArray fileSha256(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&file))
+        return QByteArray();
+    return hash.result().toHex();
+}
+
+// 清单中的路径只能指向安装目录之内
+static bool isSafePath(const QString &path)
+{
+    if (path.isEmpty() || QDir::isAbsolutePath(path) || path.contains(':'))
+        return false;
+    const QString cleaned = QDir::cleanPath(path);
+    return cleaned != ".." && !cleaned.startsWith("../") && cleaned == path;
+}
+
+static QStringList readStageList(const QString &stageDir)
+{
+    QFile file(QDir(stageDir).filePath(STAGE_LIST));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QStringList();
+
+    QStringList paths;
+    for (const QString &line : QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts))
+    {
+        const QString path = line.trimmed();
+        if (isSafePath(path))
+            paths.append(path);
+    }
+    return paths;
+}
+
+DeltaUpdater::DeltaUpdater(QNetworkAccessManager *manager, const QString &installDir,
+                           const QString &stageDir, QObject *parent)
+    : QObject(parent)
+    , mManager(manager)
+    , mInstallDir(installDir)
+    , mStageDir(stageDir)
+    , mReply(nullptr)
+    , mDownloader(nullptr)
+    , mTotalBytes(0)
+    , mDoneBytes(0)
+{
+    connect(&mCompareWatcher, SIGNAL(finished()), this, SLOT(onCompareFinished()));
+}
+
+void DeltaUpdater::start(const QUrl &manifestUrl)
+{
+    mManifestUrl = manifestUrl;
+    QNetworkRequest request(manifestUrl);
+    request.setHeader(QNetworkRequest::UserAgentHeader, "LazyDogTools");
+    mReply = mManager->get(request);
+    connect(mReply, SIGNAL(finished()), this, SLOT(onManifestFinished()));
+}
+
+void DeltaUpdater::onManifestFinished()
+{
+    QNetworkReply *reply = mReply;
+    mReply = nullptr;
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        fail("下载文件清单失败: " + reply->errorString());
+        return;
+    }
+    if (!parseManifest(reply->readAll()))
+        return;
+
+    // 计算摘要要读完安装目录中的文件，在后台线程完成，结果在 onCompareFinished 中处理
+    compareFiles();
+}
+
+void DeltaUpdater::onCompareFinished()
+{
+    const QList<int> states = mCompareWatcher.future().results();
+    mPending.clear();
+    mChanged.clear();
+    mTotalBytes = 0;
+    mDoneBytes = 0;
+    for (int i = 0; i < states.size(); ++i)
+    {
+        if (states.at(i) == FileUnchanged)
+            continue;
+        const FileEntry &entry = mFiles.at(i);
+        mChanged.append(entry.path);
+        if (states.at(i) == FileStaged)
+            continue;
+        mPending.append(entry);
+        mTotalBytes += entry.size;
+    }
+
+    if (!writeStageList()) {
+        fail("无法写入暂存清单: " + QDir(mStageDir).filePath(STAGE_LIST));
+        return;
+    }
+
+    qInfo() << "增量更新: 共" << mFiles.size() << "个文件, 需要替换" << mChanged.size()
+            << "个, 需要下载" << mPending.size() << "个," << mTotalBytes << "字节";
+    downloadNext();
+}
+
+bool DeltaUpdater::parseManifest(const QByteArray &data)
+{
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    if (doc.isNull() || !doc.object().value("files").isArray()) {
+        fail("文件清单格式错误: " + error.errorString());
+        return false;
+    }
+
+    mFiles.clear();
+    const QJsonArray files = doc.object().value("files").toArray();
+    for (const QJsonValue &value : files)
+    {
+        const QJsonObject obj = value.toObject();
+        FileEntry entry;
+        entry.path = obj.value("path").toString();
+        entry.size = obj.value("size").toInteger(-1);
+        entry.sha256 = obj.value("sha256").toString().trimmed().toLower().toLatin1();
+        const QString url = obj.value("url").toString(entry.path);
+
+        if (!isSafePath(entry.path) || entry.sha256.size() != 64 || entry.size < 0) {
+            fail("文件清单中的条目无效: " + entry.path);
+            return false;
+        }
+        entry.url = mManifestUrl.resolved(QUrl(url));
+        mFiles.append(entry);
+    }
+    return true;
+}
+
+// 大小不同直接判定为有变化，大小相同再比较摘要；各文件在全局线程池中并行比对，结果保持清单顺序
+void DeltaUpdater::compareFiles()
+{
+    QList<int> indexes;
+    indexes.reserve(mFiles.size());
+    for (int i = 0; i < mFiles.size(); ++i)
+        indexes.append(i);
+
+    // 后台任务只使用副本，比对途中对象被销毁也不受影响
+    const QList<FileEntry> files = mFiles;
+    const QDir installDir(mInstallDir);
+    const QDir stageDir(mStageDir);
+    mCompareWatcher.setFuture(QtConcurrent::mapped(indexes, [files, installDir, stageDir](int i) -> int {
+        TRACE_SCOPE("DeltaUpdater::compareFile");
+        const FileEntry &entry = files.at(i);
+        const QString installed = installDir.filePath(entry.path);
+        QFileInfo info(installed);
+        if (info.exists() && info.size() == entry.size && fileSha256(installed) == entry.sha256)
+            return FileUnchanged;
+
+        // 上次已下载并校验过的文件不再重复下载
+        const QString staged = stageDir.filePath(entry.path);
+        QFileInfo stagedInfo(staged);
+        if (stagedInfo.exists() && stagedInfo.size() == entry.size && fileSha256(staged) == entry.sha256)
+            return FileStaged;
+        return FileMissing;
+    }));
+}
+
+bool DeltaUpdater::writeStageList()
+{
+    if (!QDir().mkpath(mStageDir))
+        return false;
+    QFile file(QDir(mStageDir).filePath(STAGE_LIST));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    for (const QString &path : std::as_const(mChanged))
+        file.write(path.toUtf8() + "\n");
+    return true;
+}
+
+void DeltaUpdater::downloadNext()
+{
+    if (mPending.isEmpty()) {
+        emit finished(mChanged.size());
+        return;
+    }
+
+    const FileEntry &entry = mPending.first();
+    const QString filePath = QDir(mStageDir).filePath(entry.path);
+    QDir().mkpath(QFileInfo(filePath).path());
+
+    mDownloader = new UpdateDownloader(mManager, this);
+    connect(mDownloader, SIGNAL(progress(qint64,qint64)), this, SLOT(onFileProgress(qint64,qint64)));
+    connect(mDownloader, SIGNAL(finished(QString)), this, SLOT(onFileFinished()));
+    connect(mDownloader, SIGNAL(failed(QString)), this, SLOT(onFileFailed(QString)));
+    mDownloader->start(entry.url, filePath, QString::fromLatin1(entry.sha256));
+}
+
+void DeltaUpdater::onFileProgress(qint64 received, qint64 total)
+{
+    Q_UNUSED(total);
+    emit progress(mDoneBytes + received, mTotalBytes);
+}
+
+void DeltaUpdater::onFileFinished()
+{
+    mDownloader->deleteLater();
+    mDownloader = nullptr;
+
+    const FileEntry entry = mPending.takeFirst();
+    mDoneBytes += entry.size;
+    qDebug() << "增量更新文件已下载:" << entry.path;
+    downloadNext();
+}
+
+void DeltaUpdater::onFileFailed(const QString &error)
+{
+    mDownloader->deleteLater();
+    mDownloader = nullptr;
+    fail(QString("下载 %1 失败: %2").arg(mPending.first().path, error));
+}
+
+void DeltaUpdater::fail(const QString &error)
+{
+    qWarning() << error;
+    emit failed(error);
+}
+
+bool DeltaUpdater::apply(const QString &stageDir, const QString &installDir)
+{
+    const QStringList paths = readStageList(stageDir);
+    if (paths.isEmpty()) {
+        qWarning() << "增量更新: 暂存清单为空";
+        return false;
+    }
+
+    QDir stage(stageDir);
+    QDir install(installDir);
+    QList<QPair<QString, bool>> replaced;   // <目标文件, 是否改名保留了原文件>
+    bool ok = true;
+    for (const QString &path : paths)
+    {
+        const QString source = stage.filePath(path);
+        const QString target = install.filePath(path);
+        const QString old = target + OLD_SUFFIX;
+
+        QFile::remove(old);
+        bool renamed = QFile::exists(target);
+        if (renamed && !QFile::rename(target, old)) {
+            qWarning() << "增量更新: 无法替换文件:" << target;
+            ok = false;
+            break;
+        }
+        replaced.append(qMakePair(target, renamed));
+
+        QDir().mkpath(QFileInfo(target).path());
+        if (!QFile::copy(source, target)) {
+            qWarning() << "增量更新: 复制文件失败:" << source;
+            ok = false;
+            break;
+        }
+    }
+
+    if (ok) {
+        qInfo() << "增量更新: 已替换" << paths.size() << "个文件";
+        return true;
+    }
+
+    // 逆序还原已处理的文件
+    for (auto it = replaced.crbegin(); it != replaced.crend(); ++it)
+    {
+        QFile::remove(it->first);
+        if (it->second && !QFile::rename(it->first + OLD_SUFFIX, it->first))
+            qCritical() << "增量更新: 还原文件失败:" << it->first;
+    }
+    return false;
+}
+
+bool DeltaUpdater::cleanup(const QString &stageDir, const QString &installDir)
+{
+    QDir install(installDir);
+    bool removed = true;
+    for (const QString &path : readStageList(stageDir))
+    {
+        const QString old = install.filePath(path) + OLD_SUFFIX;
+        if (QFile::exists(old) && !QFile::remove(old)) {
+            qWarning() << "增量更新: 无法删除旧文件:" << old;
+            removed = false;
+        }
+    }
+    return removed;
+}
+
+bool DeltaUpdater::hasOldFiles(const QString &stageDir, const QString &installDir)
+{
+    QDir install(installDir);
+    for (const QString &path : readStageList(stageDir))
+    {
+        if (QFile::exists(install.filePath(path) + OLD_SUFFIX))
+            return true;
+    }
+    return false;
+}
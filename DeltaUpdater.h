@@ -0,0 +1,88 @@
+#ifndef DELTAUPDATER_H
+#define DELTAUPDATER_H
+
+/**
+ * @file DeltaUpdater.h
+ * @author Asteri5m
+ * @date 2026-10-17 03:48:20
+ * @brief 增量更新：按发布附带的文件清单比对安装目录，只下载有变化的文件，重启时原地替换
+ *
+ * 清单(manifest.json)格式：
+ * {"version": "0.0.4", "files": [{"path": "LazyDogTools.exe", "size": 123, "sha256": "<hex>", "url": "..."}]}
+ * url 可省略或为相对地址，相对清单地址解析，省略时取 path。
+ */
+
+#include <QObject>
+#include <QUrl>
+#include <QList>
+#include <QFutureWatcher>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class UpdateDownloader;
+
+class DeltaUpdater : public QObject
+{
+    Q_OBJECT
+public:
+    DeltaUpdater(QNetworkAccessManager *manager, const QString &installDir,
+                 const QString &stageDir, QObject *parent = nullptr);
+
+    void start(const QUrl &manifestUrl);
+
+    // 把暂存目录中的文件替换到安装目录：原文件先改名为 .old（运行中的程序和 DLL 也允许改名），
+    // 任一文件失败则全部还原
+    static bool apply(const QString &stageDir, const QString &installDir);
+    // 删除上次替换留下的 .old 文件，需在旧进程退出后调用；仍有文件删不掉时返回 false，此时需保留暂存清单以便重试
+    static bool cleanup(const QString &stageDir, const QString &installDir);
+    // 暂存清单中的文件是否还有 .old 残留，即替换已完成但旧文件尚未清理
+    static bool hasOldFiles(const QString &stageDir, const QString &installDir);
+
+signals:
+    void progress(qint64 received, qint64 total);
+    void finished(int changedFiles);
+    void failed(const QString &error);
+
+private slots:
+    void onManifestFinished();
+    void onCompareFinished();
+    void onFileProgress(qint64 received, qint64 total);
+    void onFileFinished();
+    void onFileFailed(const QString &error);
+
+private:
+    struct FileEntry {
+        QString path;
+        qint64 size;
+        QByteArray sha256;
+        QUrl url;
+    };
+
+    // 与安装目录比对的结果
+    enum FileState {
+        FileUnchanged,
+        FileStaged,     // 有变化，暂存目录中已有校验通过的新文件
+        FileMissing,    // 有变化，需要下载
+    };
+
+    bool parseManifest(const QByteArray &data);
+    void compareFiles();
+    void downloadNext();
+    bool writeStageList();
+    void fail(const QString &error);
+
+    QNetworkAccessManager *mManager;
+    QString mInstallDir;
+    QString mStageDir;
+    QUrl mManifestUrl;
+    QNetworkReply *mReply;
+    UpdateDownloader *mDownloader;
+    QList<FileEntry> mFiles;        // 清单中的全部文件
+    QFutureWatcher<int> mCompareWatcher;    // 各文件的 FileState，按清单顺序
+    QList<FileEntry> mPending;      // 有变化、尚未下载的文件
+    QStringList mChanged;           // 有变化的文件，写入暂存清单
+    qint64 mTotalBytes;             // 需要下载的总字节数
+    qint64 mDoneBytes;              // 已下载完成的文件字节数
+};
+
+#endif // DELTAUPDATER_H
@@ -7,16 +7,20 @@
 
 #include <QSysInfo>
 #include <QApplication>
+#include <QDir>
+#include <QFileInfo>
 #include "LazyDogTools.h"
 #include "Settings.h"
 #include "TrayManager.h"
 #include "LogHandler.h"
 #include "ToolManager.h"
 #include "AudioHelper/AudioHelper.h"
+#include "Trace.h"
 
 LazyDogTools::LazyDogTools(QObject *parent)
     :QObject{ parent }
 {
+    TRACE_SCOPE("LazyDogTools::LazyDogTools");
     QElapsedTimer timer;
     timer.start();
     qInfo() << "程序启动";
@@ -63,6 +67,7 @@ void LazyDogTools::onMessageAvailable(QString message)
 
 void LazyDogTools::initTools()
 {
+    TRACE_SCOPE("LazyDogTools::initTools");
     ToolManager::instance().registerTool<AudioHelper>("音频助手",
                                                 {"音频助手", ":/ico/audiohelper.svg", "一款根据场景自动切换音频设备的小助手",
                                                 {"切换模式", "锁定设备", "切换场景"},
@@ -72,6 +77,7 @@ void LazyDogTools::initTools()
 
 void LazyDogTools::initTray()
 {
+    TRACE_SCOPE("LazyDogTools::initTray");
     Settings *settings = mSettings;
     // 添加托盘菜单项
     TrayManager &trayManager = TrayManager::instance();
@@ -93,6 +99,20 @@ void LazyDogTools::initTray()
     // 添加固定项
     trayManager.addSeparator();
     trayManager.addMenuItem("检查更新", [settings]() { settings->checkForUpdates(); }, nullptr, QIcon(":/ico/loop.svg"));
+    trayManager.addMenuItem("性能追踪", [&trayManager]() {
+        // 第一次点击开始记录，再次点击停止并导出
+        if (!Trace::isEnabled()) {
+            Trace::setEnabled(true);
+            trayManager.showMessage("性能追踪", "已开始记录，再次点击停止并导出");
+            return;
+        }
+        Trace::setEnabled(false);
+        QString fileName = Trace::defaultFileName();
+        if (Trace::dump(fileName))
+            trayManager.showMessage("性能追踪", "已导出到 " + QDir::toNativeSeparators(QFileInfo(fileName).absoluteFilePath()));
+        else
+            trayManager.showMessage("性能追踪", "导出失败", QSystemTrayIcon::Warning);
+    }, nullptr, QIcon(":/ico/pulse.svg"));
     trayManager.addMenuItem("退出", []() { QApplication::exit(0); }, nullptr, QIcon(":/ico/close.svg"));
 }
 
@@ -1,56 +1,101 @@
-QT       += core gui svg sql network
+QT       += core gui svg sql network concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
-LIBS += -lUser32 -lDbgHelp -lversion -lole32
+LIBS += -lUser32 -lDbgHelp -lversion -lole32 -lShell32
+
+include(zlib.pri)
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    AudioHelper/AudioBackend.cpp \
+    AudioHelper/WinAudioBackend.cpp \
     AudioHelper/AudioDatabase.cpp \
     AudioHelper/AudioHelper.cpp \
     AudioHelper/AudioHelperServer.cpp \
     AudioHelper/AudioHelperWidget.cpp \
     AudioHelper/AudioManager.cpp \
+    AudioHelper/ExeInfoCache.cpp \
+    AudioHelper/ProcessRowSet.cpp \
+    AudioHelper/RuleIndex.cpp \
     AudioHelper/SelectionDialog.cpp \
+    AudioHelper/TaskEventSource.cpp \
+    AudioHelper/TaskEventTracker.cpp \
+    AudioHelper/WinTaskEventSource.cpp \
+    AudioHelper/TaskListModel.cpp \
     AudioHelper/TaskMonitor.cpp \
+    AudioHelper/WeightEngine.cpp \
+    ConfigStore.cpp \
+    DeltaUpdater.cpp \
     HotkeyManager.cpp \
     LazyDogTools.cpp \
+    LogArchive.cpp \
+    LogCategory.cpp \
+    LogFunctionName.cpp \
     LogHandler.cpp \
+    Metrics.cpp \
     Settings.cpp \
     SettingsWidget.cpp \
     SingleApplication.cpp \
+    Storage.cpp \
     ToolManager.cpp \
     ToolModel.cpp \
+    Trace.cpp \
     TrayManager.cpp \
+    UpdateDownloader.cpp \
+    ZipExtractor.cpp \
     main.cpp
 
 HEADERS += \
+    AudioHelper/AudioBackend.h \
+    AudioHelper/WinAudioBackend.h \
     AudioHelper/AudioCustom.h \
     AudioHelper/AudioDatabase.h \
     AudioHelper/AudioHelper.h \
     AudioHelper/AudioHelperServer.h \
     AudioHelper/AudioHelperWidget.h \
     AudioHelper/AudioManager.h \
+    AudioHelper/AudioTypes.h \
+    AudioHelper/ExeInfoCache.h \
     AudioHelper/PolicyConfig.h \
+    AudioHelper/ProcessRowSet.h \
+    AudioHelper/RuleIndex.h \
     AudioHelper/SelectionDialog.h \
+    AudioHelper/TaskEventSource.h \
+    AudioHelper/TaskEventTracker.h \
+    AudioHelper/WinTaskEventSource.h \
+    AudioHelper/TaskListModel.h \
     AudioHelper/TaskMonitor.h \
+    AudioHelper/WeightEngine.h \
+    BinaryLog.h \
+    ConfigStore.h \
     Custom.h \
     CustomWidget.h \
+    DeltaUpdater.h \
     HotkeyManager.h \
     LazyDogTools.h \
+    LogArchive.h \
+    LogCategory.h \
+    LogFunctionName.h \
     LogHandler.h \
+    LogQueue.h \
+    Metrics.h \
     Settings.h \
     SettingsWidget.h \
     SingleApplication.h \
+    Storage.h \
     ToolManager.h \
     ToolModel.h \
+    Trace.h \
     TrayManager.h \
-    UAC.h
+    UAC.h \
+    UpdateDownloader.h \
+    ZipExtractor.h
 
 #设置图标
 RC_ICONS = images\ico\favicon_32.ico \
@@ -71,6 +116,9 @@ QMAKE_PROJECT_DEPTH = 0
 
 DEFINES += QT_MESSAGELOGCONTEXT
 
+# 高频的逐次枚举日志(qCTrace)只在 Debug 构建中保留
+CONFIG(debug, debug|release): DEFINES += LAZYDOG_TRACE_LOG
+
 # 版本信息
 VERSION = 0.0.1
 
@@ -0,0 +1,231 @@
+/**
+ * @file LogArchive.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 22:31:40
+ * @brief 日志归档：已轮转的日志分段索引、后台gzip压缩与按天数和总大小的保留策略
+ */
+
+#include "LogArchive.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QDebug>
+#include <algorithm>
+#include <zlib.h>
+
+static const qint64 DEFAULT_SEGMENT_BYTES = 8 * 1024 * 1024;
+static const qint64 DEFAULT_TOTAL_BYTES = 64 * 1024 * 1024;
+static const int DEFAULT_MAX_DAYS = 30;
+static const int GZIP_CHUNK_SIZE = 64 * 1024;
+
+// 注意：archive/enforceRetention 在 LogHandler 持有文件锁时调用，这两处不能输出日志
+
+LogArchive::LogArchive(const QString &path)
+    : mDir(path)
+    , mLoaded(false)
+    , mSegmentBytes(DEFAULT_SEGMENT_BYTES)
+    , mTotalBytes(DEFAULT_TOTAL_BYTES)
+    , mMaxDays(DEFAULT_MAX_DAYS)
+{
+    // 压缩按顺序进行，不与前台争抢CPU
+    mThreadPool.setMaxThreadCount(1);
+}
+
+LogArchive::~LogArchive()
+{
+    mThreadPool.waitForDone();
+}
+
+void LogArchive::setLimits(qint64 segmentBytes, qint64 totalBytes, int maxDays)
+{
+    QMutexLocker locker(&mMutex);
+    mSegmentBytes = qMax<qint64>(segmentBytes, 64 * 1024);
+    mTotalBytes = qMax(totalBytes, mSegmentBytes);
+    mMaxDays = qMax(maxDays, 1);
+}
+
+qint64 LogArchive::segmentBytes() const
+{
+    QMutexLocker locker(&mMutex);
+    return mSegmentBytes;
+}
+
+bool LogArchive::archive(const QString &fileName, const QDate &date)
+{
+    QFileInfo fileInfo(fileName);
+    QString target;
+    {
+        QMutexLocker locker(&mMutex);
+        load();
+
+        int sequence = 1;
+        for (const Segment &segment : std::as_const(mSegments)) {
+            if (segment.date == date)
+                sequence = qMax(sequence, segment.sequence + 1);
+        }
+
+        target = mDir.filePath(QString("log_%1_%2.%3")
+                                   .arg(date.toString("yyyyMMdd")).arg(sequence).arg(fileInfo.suffix()));
+        if (!QFile::rename(fileName, target))
+            return false;
+
+        Segment segment{target, date, sequence, fileInfo.size(), true};
+        auto it = std::upper_bound(mSegments.begin(), mSegments.end(), segment,
+                                   [](const Segment &a, const Segment &b) {
+                                       return a.date != b.date ? a.date < b.date : a.sequence < b.sequence;
+                                   });
+        mSegments.insert(it, segment);
+    }
+
+    mThreadPool.start([this, target]() { compress(target); });
+    return true;
+}
+
+void LogArchive::enforceRetention()
+{
+    QMutexLocker locker(&mMutex);
+    load();
+
+    qint64 total = 0;
+    for (const Segment &segment : std::as_const(mSegments))
+        total += segment.size;
+
+    QDate today = QDate::currentDate();
+    for (int i = 0; i < mSegments.size(); )
+    {
+        const Segment &segment = mSegments.at(i);
+        bool expired = segment.date.daysTo(today) > mMaxDays;
+        if ((!expired && total <= mTotalBytes) || segment.compressing) {
+            ++i;
+            continue;
+        }
+
+        if (QFile::remove(segment.fileName) || !QFile::exists(segment.fileName)) {
+            total -= segment.size;
+            mSegments.removeAt(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+// 首次使用时扫描一次目录建立索引，调用方需持有 mMutex
+void LogArchive::load()
+{
+    if (mLoaded)
+        return;
+    mLoaded = true;
+
+    static const QRegularExpression SegmentRegex(R"(^log_(\d{8})(?:_(\d+))?\.(txt|bin)(\.gz)?$)");
+
+    QStringList pending;
+    const QFileInfoList files = mDir.entryInfoList(QStringList() << "log_*", QDir::Files);
+    for (const QFileInfo &fileInfo : files)
+    {
+        // 上次退出时未完成的压缩
+        if (fileInfo.fileName().endsWith(".part")) {
+            QFile::remove(fileInfo.filePath());
+            continue;
+        }
+
+        QRegularExpressionMatch match = SegmentRegex.match(fileInfo.fileName());
+        if (!match.hasMatch())
+            continue;
+
+        Segment segment{fileInfo.filePath(), QDate::fromString(match.captured(1), "yyyyMMdd"),
+                        match.captured(2).toInt(), fileInfo.size(), false};
+        if (!segment.date.isValid())
+            continue;
+
+        if (!match.hasCaptured(4)) {
+            segment.compressing = true;
+            pending.append(segment.fileName);
+        }
+        mSegments.append(segment);
+    }
+
+    std::sort(mSegments.begin(), mSegments.end(), [](const Segment &a, const Segment &b) {
+        return a.date != b.date ? a.date < b.date : a.sequence < b.sequence;
+    });
+
+    // 旧版遗留或上次未压缩完的分段补做压缩
+    for (const QString &fileName : std::as_const(pending))
+        mThreadPool.start([this, fileName]() { compress(fileName); });
+}
+
+void LogArchive::compress(const QString &fileName)
+{
+    QString target = fileName + ".gz";
+    QString part = target + ".part";
+
+    bool compressed = gzipFile(fileName, part);
+    if (compressed) {
+        QFile::remove(target);
+        compressed = QFile::rename(part, target) && QFile::remove(fileName);
+    }
+    if (!compressed)
+        QFile::remove(part);
+
+    qint64 size = QFileInfo(compressed ? target : fileName).size();
+    {
+        QMutexLocker locker(&mMutex);
+        for (Segment &segment : mSegments) {
+            if (segment.fileName != fileName)
+                continue;
+            if (compressed)
+                segment.fileName = target;
+            segment.size = size;
+            segment.compressing = false;
+            break;
+        }
+    }
+
+    if (!compressed)
+        qWarning() << "Failed to compress log segment:" << fileName;
+}
+
+bool LogArchive::gzipFile(const QString &source, const QString &target)
+{
+    QFile in(source);
+    QFile out(target);
+    if (!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly))
+        return false;
+
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+
+    // windowBits 加16输出gzip格式，可直接用常见解压工具打开
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    QByteArray input(GZIP_CHUNK_SIZE, Qt::Uninitialized);
+    QByteArray output(GZIP_CHUNK_SIZE, Qt::Uninitialized);
+    bool ok = true;
+    int flush;
+    do {
+        qint64 read = in.read(input.data(), input.size());
+        if (read < 0) {
+            ok = false;
+            break;
+        }
+        flush = in.atEnd() ? Z_FINISH : Z_NO_FLUSH;
+        strm.avail_in = uInt(read);
+        strm.next_in = reinterpret_cast<Bytef *>(input.data());
+
+        do {
+            strm.avail_out = uInt(output.size());
+            strm.next_out = reinterpret_cast<Bytef *>(output.data());
+            deflate(&strm, flush);
+            qint64 have = output.size() - strm.avail_out;
+            if (out.write(output.constData(), have) != have) {
+                ok = false;
+                break;
+            }
+        } while (strm.avail_out == 0);
+    } while (ok && flush != Z_FINISH);
+
+    deflateEnd(&strm);
+    return ok && out.flush();
+}
@@ -0,0 +1,55 @@
+#ifndef LOGARCHIVE_H
+#define LOGARCHIVE_H
+
+/**
+ * @file LogArchive.h
+ * @author Asteri5m
+ * @date 2026-10-16 22:31:40
+ * @brief 日志归档：已轮转的日志分段索引、后台gzip压缩与按天数和总大小的保留策略
+ */
+
+#include <QDir>
+#include <QDate>
+#include <QList>
+#include <QMutex>
+#include <QThreadPool>
+
+class LogArchive
+{
+public:
+    explicit LogArchive(const QString &path);
+    ~LogArchive();
+
+    // segmentBytes: 单个日志文件的上限；totalBytes: 归档分段的总大小上限；maxDays: 保留天数
+    void setLimits(qint64 segmentBytes, qint64 totalBytes, int maxDays);
+    qint64 segmentBytes() const;
+
+    // 把已关闭的当前日志文件改名为分段并提交后台压缩
+    bool archive(const QString &fileName, const QDate &date);
+    // 按保留天数和总大小删除最旧的分段，只使用内存中的索引
+    void enforceRetention();
+
+private:
+    struct Segment {
+        QString fileName;
+        QDate date;
+        int sequence;       // 同一天内的序号，旧版按日期命名的文件为0
+        qint64 size;
+        bool compressing;
+    };
+
+    void load();
+    void compress(const QString &fileName);
+    static bool gzipFile(const QString &source, const QString &target);
+
+    QDir mDir;
+    mutable QMutex mMutex;
+    QList<Segment> mSegments;   // 按 (日期, 序号) 从旧到新
+    bool mLoaded;
+    qint64 mSegmentBytes;
+    qint64 mTotalBytes;
+    int mMaxDays;
+    QThreadPool mThreadPool;
+};
+
+#endif // LOGARCHIVE_H
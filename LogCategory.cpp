@@ -0,0 +1,12 @@
+/**
+ * @file LogCategory.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 23:12:57
+ * @brief 日志分类：各子系统单独设置日志等级，未启用的分类在格式化参数之前就被跳过
+ */
+
+#include "LogCategory.h"
+
+Q_LOGGING_CATEGORY(lcAudioServer,  "lazydog.audio.server")
+Q_LOGGING_CATEGORY(lcTaskMonitor,  "lazydog.audio.taskmonitor")
+Q_LOGGING_CATEGORY(lcAudioBackend, "lazydog.audio.backend")
@@ -0,0 +1,25 @@
+#ifndef LOGCATEGORY_H
+#define LOGCATEGORY_H
+
+/**
+ * @file LogCategory.h
+ * @author Asteri5m
+ * @date 2026-10-16 23:12:57
+ * @brief 日志分类：各子系统单独设置日志等级，未启用的分类在格式化参数之前就被跳过
+ */
+
+#include <QLoggingCategory>
+
+// 分类名统一以 "lazydog." 开头，由 LogHandler 按等级启用；其余分类（如 qt.*）保持 Qt 默认规则
+Q_DECLARE_LOGGING_CATEGORY(lcAudioServer)
+Q_DECLARE_LOGGING_CATEGORY(lcTaskMonitor)
+Q_DECLARE_LOGGING_CATEGORY(lcAudioBackend)
+
+// 逐次刷新/逐条枚举级别的高频日志：Release 构建直接编译掉，Debug 构建等同 qCDebug
+#ifdef LAZYDOG_TRACE_LOG
+#define qCTrace(category) qCDebug(category)
+#else
+#define qCTrace(category) while (false) QMessageLogger().noDebug()
+#endif
+
+#endif // LOGCATEGORY_H
@@ -0,0 +1,82 @@
+/**
+ * @file LogFunctionName.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 11:32:18
+ * @brief 日志标签：从 context.function 中提取 "类名::函数名"，按调用点缓存
+ */
+
+#include "LogFunctionName.h"
+#include <QHash>
+#include <QStringList>
+
+// 同一调用点的 context.function 指向同一个静态字符串，按指针缓存解析结果
+// 每个线程一份缓存，无需加锁；调用点数量有限，不需要淘汰
+QString extractFunctionName(const char *function)
+{
+    if (function == nullptr)
+        return QStringLiteral("LogHandler::Default");
+
+    thread_local QHash<const char *, QString> cache;
+    auto it = cache.constFind(function);
+    if (it != cache.constEnd())
+        return it.value();
+
+    return cache.insert(function, parseFunctionName(function)).value();
+}
+
+// 从函数签名中取出 "类名::函数名"，兼容 MSVC 的 __FUNCSIG__ 与 GCC/Clang 的 __PRETTY_FUNCTION__：
+//   void __cdecl AudioHelperServer::server(void)
+//   void AudioHelperServer::server()
+//   auto __cdecl TaskMonitor::collectProcesses::<lambda_1>::operator ()(void) const
+//   TaskMonitor::collectProcesses()::<lambda()>
+QString parseFunctionName(const char *signature)
+{
+    // 参数列表的左括号：模板参数外的第一个 '('
+    int depth = 0;
+    const char *end = signature;
+    for (; *end != '\0'; ++end) {
+        if (*end == '<') ++depth;
+        else if (*end == '>' && depth > 0) --depth;
+        else if (*end == '(' && depth == 0) break;
+    }
+    while (end > signature && end[-1] == ' ')
+        --end;
+
+    // 名称的起点：模板参数外、左括号前的最后一个空格（其前为返回类型和调用约定）
+    depth = 0;
+    const char *begin = end;
+    while (begin > signature) {
+        char c = begin[-1];
+        if (c == '>') ++depth;
+        else if (c == '<' && depth > 0) --depth;
+        else if ((c == ' ' || c == '*' || c == '&') && depth == 0) break;
+        --begin;
+    }
+
+    // 按 "::" 拆分，遇到 lambda 等匿名作用域即停止，并去掉各段的模板参数
+    QStringList parts;
+    QString part;
+    depth = 0;
+    for (const char *p = begin; p <= end; ++p) {
+        if (p == end || (depth == 0 && p[0] == ':' && p[1] == ':')) {
+            if (part.isEmpty() || part.startsWith('<') || part.startsWith('`') || part.startsWith('{'))
+                break;
+            parts.append(part);
+            part.clear();
+            if (p == end) break;
+            ++p;
+            continue;
+        }
+        if (*p == '<') ++depth;
+        else if (*p == '>' && depth > 0) --depth;
+        else if (depth == 0) part.append(QLatin1Char(*p));
+    }
+
+    if (parts.isEmpty())
+        return QStringLiteral("LogHandler::Default");
+
+    // 与原先一致，只保留最后的 "类名::函数名"
+    if (parts.size() > 2)
+        parts = parts.mid(parts.size() - 2);
+    return parts.join(QLatin1String("::"));
+}
@@ -0,0 +1,18 @@
+#ifndef LOGFUNCTIONNAME_H
+#define LOGFUNCTIONNAME_H
+
+/**
+ * @file LogFunctionName.h
+ * @author Asteri5m
+ * @date 2026-10-17 11:32:18
+ * @brief 日志标签：从 context.function 中提取 "类名::函数名"，按调用点缓存；只依赖QtCore
+ */
+
+#include <QString>
+
+// 按 context.function 指针缓存的结果，命中时只有一次哈希查找；为空时返回 "LogHandler::Default"
+QString extractFunctionName(const char *function);
+// 直接解析函数签名，不经过缓存
+QString parseFunctionName(const char *signature);
+
+#endif // LOGFUNCTIONNAME_H
@@ -9,24 +9,60 @@
 #include <QDebug>
 #include <QDateTime>
 #include <QMessageBox>
+#include <QStringList>
+#include <QDataStream>
 #include "LogHandler.h"
+#include "LogFunctionName.h"
+#include "Metrics.h"
+
+static const size_t LOG_QUEUE_SIZE = 4096;     // 必须是2的幂
+static const int LOG_BATCH_SIZE = 256;
+static const int LOG_IDLE_MSEC = 50;            // 写线程空闲时的最长等待，兜底偶发的漏唤醒
+static const int LOG_FLUSH_TIMEOUT_MSEC = 1000;
+static const int LOG_STARTUP_BUFFER_SIZE = 512;
+
+QLoggingCategory::CategoryFilter LogHandler::sDefaultFilter = nullptr;
 
 LogHandler::LogHandler()
     :mLogDir("log")
+    ,mArchive("log")
+    ,mLogSize(0)
     ,mLogLevel(Undefined)
+    ,mHasCategoryLevels(false)
+    ,mLogFormat(TextFormat)
+    ,mLogBuffer(LOG_STARTUP_BUFFER_SIZE)
+    ,mBufferCount(0)
+    ,mQueue(LOG_QUEUE_SIZE)
+    ,mWriter(nullptr)
+    ,mAsync(false)
+    ,mProducers(0)
+    ,mWriterIdle(false)
+    ,mWritten(0)
+    ,mDropped(0)
+    ,mDroppedTotal(0)
+    ,mStopping(false)
 {
     // 初始化日志文件
     rotateLogs();
 
+    Metrics::callback("log_queue_depth", "Records waiting for the log writer thread", [this]() {
+        return qint64(mQueue.enqueued() - mQueue.dequeued());
+    });
+    Metrics::callback("log_dropped_total", "Log records dropped because the queue was full", [this]() {
+        return qint64(droppedCount());
+    });
+
     setvbuf(stdout, nullptr, _IONBF, 0);
 }
 
 LogHandler::~LogHandler()
 {
+    setAsync(false);
+
     // 意外终止时输出缓冲区
-    if (!mLogBuffer.isEmpty()){
+    if (mBufferCount > 0 || mSpillFile.isOpen()){
         rotateLogs();
-        LogHandler::instance().setLogLevel(DebugLevel);
+        mLogLevel = DebugLevel;
         LogHandler::instance().clearBuffer();
     }
     mLogFile.close();
@@ -40,59 +76,231 @@ LogHandler& LogHandler::instance()
 
 void LogHandler::messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
 {
-    QString functionName = LogHandler::instance().extractFunctionName(QString::fromLatin1(context.function));
+    LogHandler &handler = LogHandler::instance();
+
+    // 异步模式下函数名的提取也交给写线程。
+    // 读取 mAsync 前先登记，setAsync(false) 等登记的生产者入队完成后才补写队列，记录不会滞留在队列中
+    handler.mProducers.fetch_add(1);
+    if (handler.mAsync.load() && type != QtFatalMsg
+        && handler.logLevel() != Undefined)
+    {
+        if (handler.enablePrint(type, context.category))
+            handler.enqueueLog(type, context.function, msg);
+        handler.mProducers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    handler.mProducers.fetch_sub(1, std::memory_order_release);
 
-    if (LogHandler::instance().logLevel() == Undefined)
-        LogHandler::instance().bufferLog(type, functionName, msg);
+    QString functionName = extractFunctionName(context.function);
 
-    if (!LogHandler::instance().enablePrint(type))
+    if (handler.logLevel() == Undefined)
+        handler.bufferLog(type, functionName, msg);
+
+    if (!handler.enablePrint(type, context.category))
         return;
 
-    LogHandler::instance().writeLog(type, functionName, msg);
+    // 致命错误同步写入，先等队列中更早的记录落盘
+    if (type == QtFatalMsg)
+        handler.flush();
+
+    handler.writeLog(type, functionName, msg);
+}
+
+void LogHandler::enqueueLog(QtMsgType type, const char *function, const QString &msg)
+{
+    if (mQueue.push({type, function, QDateTime::currentMSecsSinceEpoch(), msg}))
+    {
+        if (mWriterIdle.load(std::memory_order_acquire))
+        {
+            QMutexLocker locker(&mWakeMutex);
+            mWakeCondition.wakeOne();
+        }
+        return;
+    }
+
+    // 队列已满：警告和错误退回同步写入（可能排在队列中更早的记录之前），其余丢弃并计数
+    if (type == QtWarningMsg || type == QtCriticalMsg)
+    {
+        writeLog(type, extractFunctionName(function), msg);
+        return;
+    }
+    mDropped.fetch_add(1, std::memory_order_relaxed);
+    mDroppedTotal.fetch_add(1, std::memory_order_relaxed);
 }
 
 void LogHandler::writeLog(QtMsgType type, const QString& tag, const QString& msg)
 {
-    QMutexLocker locker(&mMutex);
+    writeLog(type, QDateTime::currentMSecsSinceEpoch(), tag, msg);
+}
 
-    if (mLogDate != QDate::currentDate()) {
-        rotateLogs();
+void LogHandler::writeLog(QtMsgType type, qint64 time, const QString &tag, const QString &msg)
+{
+    {
+        QMutexLocker locker(&mMutex);
+
+        if (mLogDate != QDate::currentDate()) {
+            rotateLogs();
+        }
+
+        QString text;
+        QByteArray data;
+        encodeLog(type, time, tag, msg, &text, &data);
+        writeBatch(&text, &data);
     }
 
+    if (type == QtFatalMsg)
+        QMessageBox::critical(nullptr, "程序崩溃", msg);
+}
+
+// 调用方需持有 mMutex；文本格式追加到 text，二进制格式追加到 data
+void LogHandler::encodeLog(QtMsgType type, qint64 time, const QString &tag, const QString &msg, QString *text, QByteArray *data)
+{
+    if (mLogFormat == BinaryFormat)
+        mEncoder.encode(type, time, tag, msg, data);
+    else
+        text->append(formatLogLine(type, time, tag, msg));
+}
+
+// 调用方需持有 mMutex，一批日志只写一次文件
+void LogHandler::writeBatch(QString *text, QByteArray *data)
+{
     if (mLogFile.isOpen()) {
-        mLogFile.seek(mLogFile.size());
-        QTextStream out(&mLogFile);
-        QString levelText;
+        // 输出到日志
+        QByteArray bytes = mLogFormat == BinaryFormat ? *data : text->toUtf8();
+        mLogFile.write(bytes);
+        mLogFile.flush();
+        mLogSize += bytes.size();
+
+        // 控制台输出；二进制格式省掉的正是逐条格式化，控制台不再输出
+        if (!text->isEmpty())
+            fprintf(stdout, "%s", text->toLocal8Bit().constData());
+
+        // 超过分段上限时轮转，旧文件交给后台压缩
+        if (mLogSize >= mArchive.segmentBytes())
+            rotateLogs();
+    }
+    text->clear();
+    data->clear();
+}
 
-        switch (type) {
-        case QtDebugMsg:
-            levelText = "DEBUG";
-            break;
-        case QtInfoMsg:
-            levelText = "INFO ";
-            break;
-        case QtWarningMsg:
-            levelText = "WARN ";
-            break;
-        case QtCriticalMsg:
-            levelText = "ERROR";
-            break;
-        case QtFatalMsg:
-            levelText = "FATAL";
-            QMessageBox::critical(nullptr, "程序崩溃", msg);
+void LogHandler::setLogFormat(LogFormat format)
+{
+    QMutexLocker locker(&mMutex);
+    if (mLogFormat == format)
+        return;
+
+    mLogFormat = format;
+    rotateLogs();
+}
+
+LogFormat LogHandler::logFormat() const
+{
+    return mLogFormat;
+}
+
+void LogHandler::setAsync(bool async)
+{
+    if (async == (mWriter != nullptr))
+        return;
+
+    if (async)
+    {
+        mStopping = false;
+        mWriter = QThread::create([this]() { writerLoop(); });
+        mWriter->setObjectName("LogWriter");
+        mWriter->start(QThread::LowPriority);
+        mAsync.store(true, std::memory_order_release);
+        return;
+    }
+
+    // 与生产者的登记都是顺序一致的：生产者要么看到关闭而同步写入，要么已被计入 mProducers
+    mAsync.store(false);
+    while (mProducers.load(std::memory_order_acquire) != 0)
+        QThread::yieldCurrentThread();
+
+    {
+        QMutexLocker locker(&mWakeMutex);
+        mStopping = true;
+        mWakeCondition.wakeOne();
+    }
+    mWriter->wait();
+    delete mWriter;
+    mWriter = nullptr;
+
+    // 关闭前已入队、写线程尚未取走的记录，同步补写
+    LogRecord record;
+    while (mQueue.pop(&record))
+        writeLog(record.type, extractFunctionName(record.function), record.msg);
+}
+
+void LogHandler::flush()
+{
+    // 写线程自身触发的日志（如写线程内崩溃）不能等待自己
+    if (mWriter == nullptr || QThread::currentThread() == mWriter)
+        return;
+
+    QMutexLocker locker(&mWakeMutex);
+    size_t target = mQueue.enqueued();
+    mWakeCondition.wakeOne();
+    while (mWritten.load(std::memory_order_acquire) < target)
+    {
+        // 写线程卡死时不能让调用方跟着卡死
+        if (!mFlushCondition.wait(&mWakeMutex, LOG_FLUSH_TIMEOUT_MSEC))
             break;
+    }
+}
+
+quint64 LogHandler::droppedCount() const
+{
+    return mDroppedTotal.load(std::memory_order_relaxed);
+}
+
+void LogHandler::writerLoop()
+{
+    QList<LogRecord> batch;
+    batch.reserve(LOG_BATCH_SIZE);
+    LogRecord record;
+    QString text;
+    QByteArray data;
+    for (;;)
+    {
+        while (batch.size() < LOG_BATCH_SIZE && mQueue.pop(&record))
+            batch.append(std::move(record));
+        int count = int(batch.size());
+
+        quint64 dropped = mDropped.exchange(0, std::memory_order_relaxed);
+        if (count > 0 || dropped > 0)
+        {
+            QMutexLocker locker(&mMutex);
+
+            if (mLogDate != QDate::currentDate()) {
+                rotateLogs();
+            }
+
+            for (const LogRecord &item : std::as_const(batch))
+                encodeLog(item.type, item.time, extractFunctionName(item.function), item.msg, &text, &data);
+            if (dropped > 0)
+                encodeLog(QtWarningMsg, QDateTime::currentMSecsSinceEpoch(), "LogHandler::writerLoop",
+                          QString("Log queue full, %1 messages dropped").arg(dropped), &text, &data);
+            writeBatch(&text, &data);
+            batch.clear();
         }
 
-        QString logMessage = QString("%1 [%2] - %3 - %4\n")
-                                 .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
-                                 .arg(levelText).arg(tag).arg(msg);
+        QMutexLocker locker(&mWakeMutex);
+        mWritten.store(mQueue.dequeued(), std::memory_order_release);
+        mFlushCondition.wakeAll();
 
-        // 输出到日志
-        out << logMessage;
-        out.flush();
+        // 一批写满说明可能还有积压，继续处理
+        if (count == LOG_BATCH_SIZE)
+            continue;
 
-        // 控制台输出
-        fprintf(stdout, "%s", logMessage.toLocal8Bit().constData());
+        if (mStopping)
+            break;
+
+        mWriterIdle.store(true, std::memory_order_release);
+        if (mQueue.dequeued() == mQueue.enqueued())
+            mWakeCondition.wait(&mWakeMutex, LOG_IDLE_MSEC);
+        mWriterIdle.store(false, std::memory_order_release);
     }
 }
 
@@ -113,56 +321,154 @@ void LogHandler::rotateLogs()
     backupOldLogs();
     deleteOldLogs();
 
-    QString logFileName = mLogDir.filePath("log.txt");
+    bool binary = mLogFormat == BinaryFormat;
+    QString logFileName = mLogDir.filePath(binary ? "log.bin" : "log.txt");
     mLogFile.setFileName(logFileName);
 
-    if (!mLogFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+    // 二进制日志的文件头不对（旧版本或损坏）时不能继续追加；
+    // 上次崩溃留下的半条记录需要截掉，否则这次追加的会话在解码时会被一起丢弃
+    QByteArray head;
+    if (binary && mLogFile.exists()) {
+        QFile oldFile(logFileName);
+        qint64 validSize = 0;
+        if (oldFile.open(QIODevice::ReadWrite)) {
+            qint64 size = oldFile.size();
+            uchar *data = size > 0 ? oldFile.map(0, size) : nullptr;
+            if (data != nullptr) {
+                validSize = BinaryLogDecoder::validSize(data, size);
+                oldFile.unmap(data);
+            }
+            if (validSize > 0 && validSize < size)
+                oldFile.resize(validSize);
+            oldFile.close();
+        }
+        if (validSize == 0)
+            QFile::remove(logFileName);
+    }
+
+    QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Append;
+    if (!binary)
+        mode |= QIODevice::Text;
+
+    if (!mLogFile.open(mode)) {
         qFatal() << "Failed to open log file:" << logFileName;
         return;
     }
+
+    // 每次打开都开始新的会话，时间基准和标签表随之重置
+    if (binary) {
+        if (mLogFile.size() == 0)
+            BinaryLogEncoder::writeHeader(&head);
+        mEncoder.beginSession(QDateTime::currentMSecsSinceEpoch(), &head);
+        mLogFile.write(head);
+        mLogFile.flush();
+    }
+    mLogSize = mLogFile.size();
 }
 
 void LogHandler::backupOldLogs()
 {
-    QString currentLogFileName = mLogDir.filePath("log.txt");
-
-    if (QFile::exists(currentLogFileName)) {
-        QFileInfo fileInfo(currentLogFileName);
-        if (fileInfo.lastModified().date() != mLogDate) {
-            QString backupName = mLogDir.filePath(QString("log_%1.txt").arg(fileInfo.lastModified().date().toString("yyyyMMdd")));
-            QFile::rename(currentLogFileName, backupName);
+    // 文本与二进制日志分别轮转：跨天或超过分段上限时归档为分段，由后台压缩
+    static const char *suffixes[] = {"txt", "bin"};
+    qint64 segmentBytes = mArchive.segmentBytes();
+    for (const char *suffix : suffixes) {
+        QString currentLogFileName = mLogDir.filePath(QString("log.%1").arg(suffix));
+
+        if (QFile::exists(currentLogFileName)) {
+            QFileInfo fileInfo(currentLogFileName);
+            QDate date = fileInfo.lastModified().date();
+            if (date != mLogDate || fileInfo.size() >= segmentBytes) {
+                mArchive.archive(currentLogFileName, date);
+            }
         }
     }
 }
 
 void LogHandler::deleteOldLogs()
 {
+    mArchive.enforceRetention();
+}
+
+void LogHandler::setRetention(qint64 segmentBytes, qint64 totalBytes, int maxDays)
+{
+    mArchive.setLimits(segmentBytes, totalBytes, maxDays);
+}
 
-    QStringList logFiles = mLogDir.entryList(QStringList() << "log_*.txt", QDir::Files);
+void LogHandler::setLogLevel(LogLevel level)
+{
+    mLogLevel = level;
+    applyCategoryLevels();
+}
 
-    for (auto it = logFiles.constBegin(); it != logFiles.constEnd(); ++it) {
-        const QString &fileName = *it;
-        QString logfile = mLogDir.filePath(fileName);
-        QFileInfo fileInfo(logfile);
-        if (fileInfo.lastModified().date().daysTo(QDate::currentDate()) > 30) {
-            QFile::remove(logfile);
-        }
+void LogHandler::setCategoryLevel(const QString &category, LogLevel level)
+{
+    {
+        QMutexLocker locker(&mLevelMutex);
+        if (level == Undefined)
+            mCategoryLevels.remove(category);
+        else
+            mCategoryLevels.insert(category, level);
+        mHasCategoryLevels.store(!mCategoryLevels.isEmpty(), std::memory_order_release);
     }
+    applyCategoryLevels();
 }
 
-QString LogHandler::extractFunctionName(const QString& functionSignature)
+// 规则格式："lazydog.audio.server=debug;lazydog.audio.taskmonitor=warn"
+void LogHandler::setCategoryLevels(const QString &rules)
 {
-    static const QRegularExpression FuncNameRegex(R"(\b(?:__cdecl|__stdcall|__fastcall|__thiscall|__vectorcall)\s*(\w+::\w+))");
-    QRegularExpressionMatch match = FuncNameRegex.match(functionSignature);
-    if (match.hasMatch()) {
-        return match.captured(1); // 提取函数名部分
+    static const QStringList levelNames = {"debug", "info", "warn", "error", "fatal"};
+
+    {
+        QMutexLocker locker(&mLevelMutex);
+        mCategoryLevels.clear();
+        const QStringList items = rules.split(';', Qt::SkipEmptyParts);
+        for (const QString &item : items) {
+            int level = levelNames.indexOf(item.section('=', 1).trimmed().toLower());
+            QString category = item.section('=', 0, 0).trimmed();
+            if (level >= 0 && !category.isEmpty())
+                mCategoryLevels.insert(category, LogLevel(level));
+        }
+        mHasCategoryLevels.store(!mCategoryLevels.isEmpty(), std::memory_order_release);
     }
-    return "LogHandler::Default";
+    applyCategoryLevels();
 }
 
-void LogHandler::setLogLevel(LogLevel level)
+LogLevel LogHandler::categoryLevel(const char *category) const
 {
-    mLogLevel = level;
+    if (mLogLevel == Undefined || category == nullptr
+        || !mHasCategoryLevels.load(std::memory_order_acquire))
+        return mLogLevel;
+
+    QMutexLocker locker(&mLevelMutex);
+    return mCategoryLevels.value(QString::fromLatin1(category), mLogLevel);
+}
+
+// 重新安装过滤器会对所有已注册的分类重新求值，新注册的分类也会经过过滤器
+void LogHandler::applyCategoryLevels()
+{
+    QLoggingCategory::CategoryFilter previous = QLoggingCategory::installFilter(categoryFilter);
+    if (previous != categoryFilter)
+        sDefaultFilter = previous;
+}
+
+void LogHandler::categoryFilter(QLoggingCategory *category)
+{
+    const char *name = category->categoryName();
+    if (qstrcmp(name, "default") != 0 && qstrncmp(name, "lazydog.", 8) != 0) {
+        if (sDefaultFilter != nullptr)
+            sDefaultFilter(category);
+        return;
+    }
+
+    // 等级未确定前日志都要进入启动缓冲，全部启用
+    LogLevel level = LogHandler::instance().categoryLevel(name);
+    if (level == Undefined)
+        level = DebugLevel;
+
+    category->setEnabled(QtDebugMsg,    level <= DebugLevel);
+    category->setEnabled(QtInfoMsg,     level <= InfoLevel);
+    category->setEnabled(QtWarningMsg,  level <= WarningLevel);
+    category->setEnabled(QtCriticalMsg, level <= CriticalLevel);
 }
 
 LogLevel LogHandler::logLevel() const
@@ -172,28 +478,74 @@ LogLevel LogHandler::logLevel() const
 
 void LogHandler::bufferLog(QtMsgType type, const QString& tag, const QString& msg)
 {
-    // 将日志信息存储在缓冲区中
-    mLogBuffer.append({ type, tag, msg });
+    // 将日志信息存储在缓冲区中，缓冲区满时先转存到磁盘，内存占用不随启动阶段的日志量增长
+    QMutexLocker locker(&mBufferMutex);
+    if (mBufferCount == mLogBuffer.size())
+        spillBuffer();
+
+    mLogBuffer[mBufferCount++] = { type, QDateTime::currentMSecsSinceEpoch(), tag, msg };
+}
+
+// 调用方需持有 mBufferMutex
+void LogHandler::spillBuffer()
+{
+    if (!mSpillFile.isOpen()) {
+        // 上次异常退出遗留的文件直接覆盖
+        mSpillFile.setFileName(mLogDir.filePath("startup.spill"));
+        if (!mSpillFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            // 无法转存时只能舍弃最早的一批
+            mBufferCount = 0;
+            return;
+        }
+    }
+
+    QDataStream out(&mSpillFile);
+    for (int i = 0; i < mBufferCount; ++i) {
+        LogEntry &entry = mLogBuffer[i];
+        out << qint32(entry.type) << entry.time << entry.tag << entry.msg;
+        entry = LogEntry();
+    }
+    mBufferCount = 0;
+}
+
+void LogHandler::replayLog(const LogEntry &entry)
+{
+    if (enablePrint(entry.type)) {
+        writeLog(entry.type, entry.time, entry.tag, entry.msg);
+    }
 }
 
 void LogHandler::clearBuffer()
 {
-    // 输出缓冲区中的日志
-    for (auto it = mLogBuffer.constBegin(); it != mLogBuffer.constEnd(); ++it) {
-        const auto &logEntry = *it;
-        const QtMsgType type = logEntry.type;
-        const QString& tag   = logEntry.tag;
-        const QString& msg   = logEntry.msg;
-
-        if (LogHandler::instance().enablePrint(type)) {
-            LogHandler::instance().writeLog(type, tag, msg);
+    QMutexLocker locker(&mBufferMutex);
+
+    // 先输出转存到磁盘的较早日志，再输出缓冲区中的日志，保持原有顺序
+    if (mSpillFile.isOpen()) {
+        mSpillFile.close();
+        if (mSpillFile.open(QIODevice::ReadOnly)) {
+            QDataStream in(&mSpillFile);
+            LogEntry entry;
+            qint32 type;
+            while (!in.atEnd()) {
+                in >> type >> entry.time >> entry.tag >> entry.msg;
+                if (in.status() != QDataStream::Ok)
+                    break;
+                entry.type = QtMsgType(type);
+                replayLog(entry);
+            }
+            mSpillFile.close();
         }
+        mSpillFile.remove();
     }
 
-    mLogBuffer.clear();
+    for (int i = 0; i < mBufferCount; ++i) {
+        replayLog(mLogBuffer.at(i));
+        mLogBuffer[i] = LogEntry();
+    }
+    mBufferCount = 0;
 }
 
-bool LogHandler::enablePrint(QtMsgType type)
+bool LogHandler::enablePrint(QtMsgType type, const char *category)
 {
     LogLevel logLevel;
 
@@ -215,8 +567,8 @@ bool LogHandler::enablePrint(QtMsgType type)
         break;
     }
 
-    // 返回是否可以输出日志
-    return logLevel >= LogHandler::instance().logLevel();
+    // 返回是否可以输出日志，分类单独设置了等级时以分类为准
+    return logLevel >= categoryLevel(category);
 }
 
 LONG WINAPI LogHandler::UnhandledExceptionFilter(EXCEPTION_POINTERS *exceptionInfo) {
@@ -13,9 +13,16 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QDir>
-#include <QRegularExpression>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
 #include <Windows.h>
 #include <DbgHelp.h>
+#include "LogQueue.h"
+#include "BinaryLog.h"
+#include "LogArchive.h"
 
 
 enum LogLevel {
@@ -27,6 +34,11 @@ enum LogLevel {
     Undefined,
 };
 
+enum LogFormat {
+    TextFormat,
+    BinaryFormat,   // 紧凑的二进制记录，用 logdump 工具转换为文本
+};
+
 
 class LogHandler
 {
@@ -39,14 +51,29 @@ public:
     void rotateLogs();
     void setLogLevel(LogLevel level);
     LogLevel logLevel() const;
+    // 单独设置某个分类（如 "lazydog.audio.server"）的等级，Undefined 表示跟随全局等级
+    void setCategoryLevel(const QString &category, LogLevel level);
+    void setCategoryLevels(const QString &rules);
+    LogLevel categoryLevel(const char *category) const;
+    void setLogFormat(LogFormat format);
+    LogFormat logFormat() const;
+    // 单个日志文件的上限、归档分段的总大小上限与保留天数
+    void setRetention(qint64 segmentBytes, qint64 totalBytes, int maxDays);
     void clearBuffer();
 
+    // 异步模式下 messageHandler 只把记录放进队列，由写线程批量格式化和写入
+    void setAsync(bool async);
+    // 等待写线程把已入队的记录写完
+    void flush();
+    quint64 droppedCount() const;
+
 private:
     LogHandler();
     ~LogHandler();
 
     struct LogEntry {
         QtMsgType type;
+        qint64 time;
         QString tag;
         QString msg;
     };
@@ -54,18 +81,51 @@ private:
     typedef QVector<LogEntry> LogBuffer;
 
 
-    bool enablePrint(QtMsgType type);
+    bool enablePrint(QtMsgType type, const char *category = nullptr);
+    void applyCategoryLevels();
+    static void categoryFilter(QLoggingCategory *category);
     void backupOldLogs();
     void deleteOldLogs();
-    QString extractFunctionName(const QString &functionSignature);
     void bufferLog(QtMsgType type, const QString &tag, const QString &msg);
+    void spillBuffer();
+    void replayLog(const LogEntry &entry);
+    void writeLog(QtMsgType type, qint64 time, const QString &tag, const QString &msg);
+    void enqueueLog(QtMsgType type, const char *function, const QString &msg);
+    void encodeLog(QtMsgType type, qint64 time, const QString &tag, const QString &msg, QString *text, QByteArray *data);
+    void writeBatch(QString *text, QByteArray *data);
+    void writerLoop();
 
     QDir mLogDir;
+    LogArchive mArchive;
     QFile mLogFile;
+    qint64 mLogSize;
     QMutex mMutex;
     QDate mLogDate;
     LogLevel mLogLevel;
-    LogBuffer mLogBuffer;
+    QHash<QString, LogLevel> mCategoryLevels;
+    std::atomic<bool> mHasCategoryLevels;
+    mutable QMutex mLevelMutex;
+    LogFormat mLogFormat;
+    BinaryLogEncoder mEncoder;
+    LogBuffer mLogBuffer;           // 启动阶段的固定容量缓冲，写满后整体转存到 mSpillFile
+    int mBufferCount;
+    QFile mSpillFile;
+    QMutex mBufferMutex;
+
+    LogQueue<LogRecord> mQueue;
+    QThread *mWriter;
+    std::atomic<bool> mAsync;
+    std::atomic<int> mProducers;        // 已读取 mAsync、尚未完成入队的生产者数
+    std::atomic<bool> mWriterIdle;
+    std::atomic<size_t> mWritten;       // 写线程已写入文件的记录数
+    std::atomic<quint64> mDropped;      // 队列满时丢弃的记录数，下一批写入时报告
+    std::atomic<quint64> mDroppedTotal;
+    bool mStopping;
+    QMutex mWakeMutex;
+    QWaitCondition mWakeCondition;
+    QWaitCondition mFlushCondition;
+
+    static QLoggingCategory::CategoryFilter sDefaultFilter;
 };
 
 #endif // LOGHANDLER_H
@@ -0,0 +1,105 @@
+#ifndef LOGQUEUE_H
+#define LOGQUEUE_H
+
+/**
+ * @file LogQueue.h
+ * @author Asteri5m
+ * @date 2026-10-16 21:05:18
+ * @brief 日志队列：有界多生产者单消费者环形缓冲，生产端无锁
+ */
+
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+// 队列中的一条日志，只保存原始信息，格式化留给写线程
+struct LogRecord {
+    QtMsgType type;
+    const char *function;   // context.function，指向静态字符串
+    qint64 time;            // 毫秒时间戳
+    QString msg;
+};
+
+// 每个槽位带序号：序号等于写位置时可写，等于写位置+1时可读
+// 生产者通过CAS抢占写位置，消费者只有一个，无需CAS
+template<typename T>
+class LogQueue
+{
+public:
+    explicit LogQueue(size_t capacity)
+        : mCells(new Cell[capacity])
+        , mMask(capacity - 1)
+        , mEnqueuePos(0)
+        , mDequeuePos(0)
+    {
+        // 容量必须是2的幂
+        Q_ASSERT(capacity >= 2 && (capacity & mMask) == 0);
+        for (size_t i = 0; i < capacity; ++i)
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    LogQueue(const LogQueue &) = delete;
+    LogQueue &operator=(const LogQueue &) = delete;
+
+    // 任意线程调用，队列满时返回 false
+    bool push(T &&value)
+    {
+        Cell *cell;
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &mCells[pos & mMask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅写线程调用，队列空时返回 false
+    bool pop(T *value)
+    {
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        Cell *cell = &mCells[pos & mMask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if (intptr_t(sequence) - intptr_t(pos + 1) < 0)
+            return false;
+
+        *value = std::move(cell->value);
+        cell->value = T();
+        mDequeuePos.store(pos + 1, std::memory_order_release);
+        cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 已申请的写位置总数，用于等待写线程追上
+    size_t enqueued() const { return mEnqueuePos.load(std::memory_order_acquire); }
+    size_t dequeued() const { return mDequeuePos.load(std::memory_order_acquire); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> mCells;
+    const size_t mMask;
+
+    // 生产端和消费端的位置分开在不同缓存行，避免互相干扰
+    alignas(64) std::atomic<size_t> mEnqueuePos;
+    alignas(64) std::atomic<size_t> mDequeuePos;
+};
+
+#endif // LOGQUEUE_H
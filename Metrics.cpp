@@ -0,0 +1,173 @@
+/**
+ * @file Metrics.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 23:46:21
+ * @brief 进程内指标：原子计数器、仪表与对数分桶的延迟直方图，按 Prometheus 文本格式导出
+ */
+
+#include "Metrics.h"
+#include <QTextStream>
+
+MetricHistogram::MetricHistogram()
+    : mCount(0)
+    , mSum(0)
+    , mMax(0)
+{
+    for (std::atomic<quint64> &bucket : mBuckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+void MetricHistogram::record(qint64 value)
+{
+    if (value < 0)
+        value = 0;
+
+    mBuckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(value, std::memory_order_relaxed);
+
+    qint64 max = mMax.load(std::memory_order_relaxed);
+    while (value > max && !mMax.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+qint64 MetricHistogram::percentile(double quantile) const
+{
+    quint64 total = count();
+    if (total == 0)
+        return 0;
+
+    quint64 rank = quint64(quantile * double(total) + 0.5);
+    rank = qBound<quint64>(1, rank, total);
+
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        seen += mBuckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return qMin(bucketUpper(bucket), max());
+    }
+    return max();
+}
+
+// 小于16的值各占一个分桶；其余按最高位所在的2的幂分区，再取次高4位细分
+int MetricHistogram::bucketOf(qint64 value)
+{
+    if (value < SUB_BUCKETS)
+        return int(value);
+
+    int magnitude = 63 - qCountLeadingZeroBits(quint64(value));
+    if (magnitude >= MAGNITUDES)
+        return BUCKET_COUNT - 1;
+
+    int sub = int(value >> (magnitude - 4)) - SUB_BUCKETS;
+    return SUB_BUCKETS + (magnitude - 4) * SUB_BUCKETS + sub;
+}
+
+qint64 MetricHistogram::bucketUpper(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+
+    int magnitude = (bucket - SUB_BUCKETS) / SUB_BUCKETS + 4;
+    int sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return (qint64(SUB_BUCKETS + sub + 1) << (magnitude - 4)) - 1;
+}
+
+Metrics::Registry &Metrics::registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+Metrics::Metric &Metrics::find(const QString &name, const QString &help, Type type)
+{
+    Registry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    auto it = reg.metrics.find(name);
+    if (it != reg.metrics.end()) {
+        Q_ASSERT_X(it->second.type == type, "Metrics", "metric registered twice with different types");
+        return it->second;
+    }
+
+    Metric &metric = reg.metrics[name];
+    metric.type = type;
+    metric.help = help;
+    switch (type) {
+    case CounterType:
+        metric.counter.reset(new MetricCounter);
+        break;
+    case GaugeType:
+        metric.gauge.reset(new MetricGauge);
+        break;
+    case HistogramType:
+        metric.histogram.reset(new MetricHistogram);
+        break;
+    case CallbackType:
+        break;
+    }
+    return metric;
+}
+
+MetricCounter &Metrics::counter(const QString &name, const QString &help)
+{
+    return *find(name, help, CounterType).counter;
+}
+
+MetricGauge &Metrics::gauge(const QString &name, const QString &help)
+{
+    return *find(name, help, GaugeType).gauge;
+}
+
+MetricHistogram &Metrics::histogram(const QString &name, const QString &help)
+{
+    return *find(name, help, HistogramType).histogram;
+}
+
+void Metrics::callback(const QString &name, const QString &help, std::function<qint64()> read)
+{
+    Metric &metric = find(name, help, CallbackType);
+    QMutexLocker locker(&registry().mutex);
+    metric.read = std::move(read);
+}
+
+QString Metrics::snapshot()
+{
+    static const double quantiles[] = {0.5, 0.9, 0.99, 1.0};
+
+    QString text;
+    QTextStream out(&text);
+
+    Registry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (const auto &item : reg.metrics)
+    {
+        const QString &name = item.first;
+        const Metric &metric = item.second;
+        out << "# HELP " << name << ' ' << metric.help << '\n';
+
+        switch (metric.type) {
+        case CounterType:
+            out << "# TYPE " << name << " counter\n"
+                << name << ' ' << metric.counter->value() << '\n';
+            break;
+        case GaugeType:
+            out << "# TYPE " << name << " gauge\n"
+                << name << ' ' << metric.gauge->value() << '\n';
+            break;
+        case CallbackType:
+            out << "# TYPE " << name << " gauge\n"
+                << name << ' ' << (metric.read ? metric.read() : 0) << '\n';
+            break;
+        case HistogramType:
+            out << "# TYPE " << name << " summary\n";
+            for (double quantile : quantiles)
+                out << name << "{quantile=\"" << quantile << "\"} " << metric.histogram->percentile(quantile) << '\n';
+            out << name << "_sum " << metric.histogram->sum() << '\n'
+                << name << "_count " << metric.histogram->count() << '\n';
+            break;
+        }
+    }
+
+    out.flush();
+    return text;
+}
@@ -0,0 +1,118 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/**
+ * @file Metrics.h
+ * @author Asteri5m
+ * @date 2026-10-16 23:46:21
+ * @brief 进程内指标：原子计数器、仪表与对数分桶的延迟直方图，按 Prometheus 文本格式导出
+ *
+ * 指标对象注册后地址不变，调用点用静态引用缓存，热路径上只有一次原子操作：
+ *     static MetricCounter &switches = Metrics::counter("audio_switch_total", "...");
+ *     switches.add();
+ */
+
+#include <QString>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+
+class MetricCounter
+{
+public:
+    MetricCounter() : mValue(0) {}
+    void add(quint64 value = 1) { mValue.fetch_add(value, std::memory_order_relaxed); }
+    quint64 value() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> mValue;
+};
+
+class MetricGauge
+{
+public:
+    MetricGauge() : mValue(0) {}
+    void set(qint64 value) { mValue.store(value, std::memory_order_relaxed); }
+    void add(qint64 value) { mValue.fetch_add(value, std::memory_order_relaxed); }
+    qint64 value() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> mValue;
+};
+
+// 对数-线性分桶（每个2的幂区间再分16段，相对误差约6%），记录与查询都无锁
+class MetricHistogram
+{
+public:
+    static const int SUB_BUCKETS = 16;
+    static const int MAGNITUDES = 40;   // 以微秒计可覆盖十余天
+    static const int BUCKET_COUNT = SUB_BUCKETS + (MAGNITUDES - 4) * SUB_BUCKETS;
+
+    MetricHistogram();
+
+    void record(qint64 value);
+    quint64 count() const { return mCount.load(std::memory_order_relaxed); }
+    qint64 sum() const { return mSum.load(std::memory_order_relaxed); }
+    qint64 max() const { return mMax.load(std::memory_order_relaxed); }
+    // 第 quantile (0~1) 分位所在分桶的上界
+    qint64 percentile(double quantile) const;
+
+private:
+    static int bucketOf(qint64 value);
+    static qint64 bucketUpper(int bucket);
+
+    std::atomic<quint64> mBuckets[BUCKET_COUNT];
+    std::atomic<quint64> mCount;
+    std::atomic<qint64> mSum;
+    std::atomic<qint64> mMax;
+};
+
+// 作用域计时，析构时把经过的微秒数记入直方图
+class MetricTimer
+{
+public:
+    explicit MetricTimer(MetricHistogram &histogram) : mHistogram(histogram) { mTimer.start(); }
+    ~MetricTimer() { mHistogram.record(mTimer.nsecsElapsed() / 1000); }
+
+private:
+    MetricHistogram &mHistogram;
+    QElapsedTimer mTimer;
+};
+
+class Metrics
+{
+public:
+    static MetricCounter &counter(const QString &name, const QString &help);
+    static MetricGauge &gauge(const QString &name, const QString &help);
+    static MetricHistogram &histogram(const QString &name, const QString &help);
+    // 导出时才取值的仪表，用于队列深度这类已由其它模块维护的数值
+    static void callback(const QString &name, const QString &help, std::function<qint64()> read);
+
+    // Prometheus 文本格式；直方图按 summary 导出分位数
+    static QString snapshot();
+
+private:
+    enum Type { CounterType, GaugeType, HistogramType, CallbackType };
+
+    struct Metric {
+        Type type;
+        QString help;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+        std::function<qint64()> read;
+    };
+
+    struct Registry {
+        QMutex mutex;
+        std::map<QString, Metric> metrics;  // 按名称排序，导出结果稳定
+    };
+
+    static Registry &registry();
+    static Metric &find(const QString &name, const QString &help, Type type);
+};
+
+#endif // METRICS_H
@@ -10,8 +10,11 @@
 #include "LogHandler.h"
 #include "Custom.h"
 #include "TrayManager.h"
-#include <QSqlQuery>
-#include <QSqlError>
+#include "Trace.h"
+#include "Storage.h"
+#include "ZipExtractor.h"
+#include "UpdateDownloader.h"
+#include "DeltaUpdater.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -23,14 +26,15 @@
 Settings::Settings(QObject *parent)
     : ToolModel{ parent }
     , mHotkeyManager{new HotkeyManager(this)}
-    , mdbDir(QDir("data"))
-    , mdbName("Settings.db")
+    , mConfigStore(nullptr)
     , mConfig(new Config)
     , mHotkeyMap(new HotkeyMap)
     , mHotkeyIdMap(new HotkeyIdMap)
     , mNetworkManager(new QNetworkAccessManager(this))
 {
+    TRACE_SCOPE("Settings::Settings");
     initializeDatabase();
+    mConfigStore = new ConfigStore("settings_config");
 
     // 安装全局的事件过滤器
     qApp->installNativeEventFilter(mHotkeyManager);
@@ -42,16 +46,25 @@ Settings::Settings(QObject *parent)
     mConfig->insert("开机自启动",    "true");
     mConfig->insert("管理员模式启动", "false");
     mConfig->insert("自动更新",      "true");
+    mConfig->insert("增量更新",      "true");
     mConfig->insert("debug日志",    "false");
+    mConfig->insert("二进制日志",   "false");
+    mConfig->insert("日志分段大小",  "8");       // MB，单个日志文件的上限
+    mConfig->insert("日志总大小",    "64");      // MB，压缩后的归档总大小上限
+    mConfig->insert("日志分类等级",  "");        // 如 "lazydog.audio.server=debug;lazydog.audio.taskmonitor=warn"
 
     for (auto it = mConfig->begin(); it != mConfig->end(); ++it)
     {
-        (*mConfig)[it.key()] = loadConfigFromDB(it.key(),it.value());
+        (*mConfig)[it.key()] = mConfigStore->value(it.key(), it.value());
     }
 
     if (parent == nullptr) return;
 
-    // 日志等级
+    // 日志格式与等级
+    LogHandler::instance().setRetention((*mConfig)["日志分段大小"].toLongLong() * 1024 * 1024,
+                                        (*mConfig)["日志总大小"].toLongLong() * 1024 * 1024, 30);
+    LogHandler::instance().setLogFormat((*mConfig)["二进制日志"] == "true" ? BinaryFormat : TextFormat);
+    LogHandler::instance().setCategoryLevels((*mConfig)["日志分类等级"]);
     LogHandler::instance().setLogLevel((*mConfig)["debug日志"] == "true" ? DebugLevel : InfoLevel);
     LogHandler::instance().clearBuffer();
 
@@ -60,7 +73,7 @@ Settings::Settings(QObject *parent)
     {
         if (!UAC::setApplicationStartup(true))
         {
-            saveConfigToDB("开机自启动", "false");
+            mConfigStore->setValue("开机自启动", "false");
             (*mConfig)["开机自启动"] = "false";
         }
     }
@@ -71,7 +84,7 @@ Settings::Settings(QObject *parent)
     for (auto it = allToolsInfo.begin(); it != allToolsInfo.end(); ++it)
     {
         // 启用状态
-        bool enabled = loadConfigFromDB("enable:" + it->Name, "true") == "true" ? true : false;
+        bool enabled = mConfigStore->value("enable:" + it->Name, "true") == "true" ? true : false;
         mConfig->insert("enable:" + it->Name, enabled ? "true" : "false");
         if (enabled)
             toolManager.createTool(it.key());
@@ -82,7 +95,7 @@ Settings::Settings(QObject *parent)
         for (const auto& key : it->HotkeyList)
         {
             QString name = QString("hotkey:%1:%2").arg(it->Name).arg(key);
-            QString hotkey = loadConfigFromDB(name, "");
+            QString hotkey = mConfigStore->value(name, "");
             HotkeyInfo hotkeyInfo{hotkey, false, 0};
             mConfig->insert(name, hotkey);
             mHotkeyMap->insert(name, hotkeyInfo);
@@ -99,14 +112,17 @@ Settings::~Settings()
     delete mHotkeyMap;
     delete mConfig;
     delete mNetworkManager;
-    mdb.close();
+    // 提交未写回的配置
+    delete mConfigStore;
 
     if (mUpdate)
     {
         QDir tempDirObj(UPDATE_DIR);
         QString appPath = QDir::toNativeSeparators(tempDirObj.absoluteFilePath(APPLICATION_NAME));
-        UAC::runArguments("-update", true, appPath);
+        UAC::runArguments(restartArgument("-update"), true, appPath);
     }
+    else if (mDeltaPending && applyDelta())
+        UAC::runArguments(restartArgument("-clear"), UAC::isRunAsAdmin(), QCoreApplication::applicationFilePath());
 }
 
 QString Settings::loadConfig(const QString &key) const
@@ -116,12 +132,11 @@ QString Settings::loadConfig(const QString &key) const
 
 bool Settings::saveConfig(const QString &key, const QString &value) const
 {
-    if (saveConfigToDB(key, value))
-    {
-        mConfig->insert(key, value);
-        return true;
-    }
-    return false;
+    // 写入由 ConfigStore 合并后延迟提交；之前的提交失败且未重试成功时不接受修改
+    if (!mConfigStore->setValue(key, value))
+        return false;
+    mConfig->insert(key, value);
+    return true;
 }
 
 bool Settings::registerHotkey(const QString &key, const QKeySequence &keySequence)
@@ -167,78 +182,21 @@ bool Settings::queryHotkeyState(const QString &key)
 // 初始化数据库配置
 bool Settings::initializeDatabase()
 {
-    if (!mdbDir.exists()) mdbDir.mkpath(".");
-
-    if (QSqlDatabase::contains(mdbName))
-        mdb = QSqlDatabase::database(mdbName);
-    else
-    {
-        mdb = QSqlDatabase::addDatabase("QSQLITE", mdbName);
-        mdb.setDatabaseName(mdbDir.filePath(mdbName));
-    }
-
-    if (!mdb.open())
-    {
-        qCritical() << "Failed to open the database:" << mdb.lastError().text();
-        return false;
-    }
-
-    QSqlQuery query(mdb);
-    return query.exec("CREATE TABLE IF NOT EXISTS settings ("
-                      "key TEXT PRIMARY KEY,"
-                      "value TEXT)");
-}
-
-
-// 保存配置
-bool Settings::saveConfigToDB(const QString &key, const QString &value) const
-{
-    if (!mdb.isOpen()) {
-        qWarning() << "Database is not open, save data failed";
-        return false;
-    }
-
-    qDebug() << "Insert Data, Key:" << key << ", value:" << value;
-
-    QSqlQuery query(mdb);
-    query.prepare("INSERT OR REPLACE INTO settings (key, value) VALUES (:key, :value)");
-    query.bindValue(":key", key);
-    query.bindValue(":value", value);
-
-    if (!query.exec()) {
-        qCritical() << "Failed to save setting:" << query.lastError().text();
-        return false;
-    }
-
-    return true;
+    static const QList<QStringList> steps = {
+        // 1: 配置表
+        {
+            "CREATE TABLE IF NOT EXISTS settings_config ("
+            "key TEXT PRIMARY KEY,"
+            "value TEXT)",
+        },
+    };
+    // 早期版本使用独立的 data/Settings.db
+    static const QStringList imports = {
+        "INSERT OR REPLACE INTO settings_config (key, value) SELECT key, value FROM legacy.settings",
+    };
+    return Storage::instance().migrate("settings", steps, QDir("data").filePath("Settings.db"), imports);
 }
 
-// 加载配置
-QString Settings::loadConfigFromDB(const QString &key, const QString &defaultValue) const
-{
-    if (!mdb.isOpen()) {
-        qWarning() << "Database is not open, load data failed";
-        return defaultValue;
-    }
-
-    QSqlQuery query(mdb);
-    query.prepare("SELECT value FROM settings WHERE key = :key");
-    query.bindValue(":key", key);
-
-    if (!query.exec()) {
-        qCritical() << "Load setting failed:" << query.lastError().text();
-        return defaultValue;
-    }
-
-    if (!query.next()) {
-        qDebug() << "Load setting failed: select result is null of " + key;
-        if (!defaultValue.isNull())
-            saveConfigToDB(key, defaultValue);
-        return defaultValue;
-    }
-
-    return query.value(0).toString();
-}
 
 void Settings::showWindow()
 {
@@ -267,6 +225,47 @@ void Settings::onToolActiveChanged()
     emit toolActiveChanged();
 }
 
+// 在发布的附件中查找下载包的 SHA-256：GitHub 附件的 digest 字段为 "sha256:<hex>"，
+// 另外也支持与压缩包同名的 .sha256 附件
+static void findChecksum(const QJsonArray &assets, const QString &downloadUrl, QString *sha256, QString *checksumUrl)
+{
+    QString packageName;
+    for (const QJsonValue &value : assets)
+    {
+        const QJsonObject asset = value.toObject();
+        if (asset.value("browser_download_url").toString() != downloadUrl)
+            continue;
+        packageName = asset.value("name").toString();
+        const QString digest = asset.value("digest").toString();
+        if (digest.startsWith("sha256:"))
+            *sha256 = digest.mid(7);
+        break;
+    }
+
+    if (packageName.isEmpty())
+        return;
+    for (const QJsonValue &value : assets)
+    {
+        const QJsonObject asset = value.toObject();
+        if (asset.value("name").toString() == packageName + ".sha256") {
+            *checksumUrl = asset.value("browser_download_url").toString();
+            break;
+        }
+    }
+}
+
+// 发布附带的文件清单，存在时可以只下载有变化的文件
+static QString findManifest(const QJsonArray &assets)
+{
+    for (const QJsonValue &value : assets)
+    {
+        const QJsonObject asset = value.toObject();
+        if (asset.value("name").toString() == "manifest.json")
+            return asset.value("browser_download_url").toString();
+    }
+    return QString();
+}
+
 void Settings::checkForUpdates()
 {
     QString apiUrl = mUsingGiteeAPI ? GITEE_API_URL : GITHUB_API_URL;
@@ -384,9 +383,17 @@ void Settings::onUpdateReplyed()
         changelog = obj.value("body").toString();
     }
 
+    // 发布附带的 SHA-256
+    QString checksum;
+    QString checksumUrl;
+    findChecksum(obj.value("assets").toArray(), downloadUrl, &checksum, &checksumUrl);
+    QString manifestUrl = findManifest(obj.value("assets").toArray());
+
     qDebug() << (mUsingGiteeAPI ? "Gitee" : "GitHub") << "更新信息:";
     qDebug() << "版本:" << latestVersion;
     qDebug() << "下载链接:" << downloadUrl;
+    if (!manifestUrl.isEmpty())
+        qDebug() << "文件清单:" << manifestUrl;
     
     // 比较版本号
     if (checkVersion(latestVersion))
@@ -394,7 +401,14 @@ void Settings::onUpdateReplyed()
         qInfo() << "发现新版本:" << latestVersion;
         if (showMessage(mToolWidget == nullptr ? nullptr : mToolWidget, 
             QString("发现新版本-v%1").arg(latestVersion), changelog, MessageType::Info, "立即更新", "稍后更新" ) == QMessageBox::Accepted)
-            return downloadUpPack(downloadUrl);
+        {
+            mPackageUrl = downloadUrl;
+            mPackageSha256 = checksum;
+            mPackageChecksumUrl = checksumUrl;
+            if (!manifestUrl.isEmpty() && (*mConfig)["增量更新"] == "true")
+                return downloadDelta(manifestUrl);
+            return downloadUpPack(downloadUrl, checksum, checksumUrl);
+        }
         qInfo() << "更新已取消";
     } 
     else 
@@ -433,7 +447,6 @@ bool Settings::checkVersion(const QString &remoteVersion)
 // 更新程序，将当前目录下所有文件和文件夹copy到父目录
 bool Settings::updateApp()
 {
-    Sleep(1000);
     QDir currentDir(QCoreApplication::applicationDirPath());
     QDir parentDir = currentDir;
     if (!parentDir.cdUp()) {
@@ -455,7 +468,7 @@ bool Settings::updateApp()
     {
         qInfo() << "更新成功!";
         QString appPath = QDir::toNativeSeparators(parentDir.absoluteFilePath(APPLICATION_NAME));
-        UAC::runArguments("-clear", true, appPath);
+        UAC::runArguments(restartArgument("-clear"), true, appPath);
         return true;
     }
     else
@@ -507,6 +520,13 @@ bool Settings::copyDirectory(const QString &sourceDirPath, const QString &target
 
 void Settings::clearUpdate()
 {
+    // 增量更新替换下来的旧文件；有文件删不掉时保留暂存清单，下次启动时按清单重试
+    QString appDir = QCoreApplication::applicationDirPath();
+    if (!DeltaUpdater::cleanup(QDir(appDir).filePath(UPDATE_DIR), appDir)) {
+        qWarning() << "增量更新: 部分旧文件未能删除, 下次启动时重试";
+        return;
+    }
+
     QDir tempDirObj(UPDATE_DIR);
     if (tempDirObj.exists()) {
         tempDirObj.removeRecursively();
@@ -515,174 +535,75 @@ void Settings::clearUpdate()
     qInfo() << "更新完成,当前版本:" << CURRENT_VERSION;
 }
 
-void Settings::downloadUpPack(const QString &downloadUrl)
+void Settings::clearUpdateLeftovers()
 {
-    qInfo() << "开始下载更新包";
-    TrayManager::instance().showMessage("检查更新", "开始下载更新包,在更新就绪后会通知您。");
-    QNetworkRequest request(downloadUrl);
-    QNetworkReply *reply = mNetworkManager->get(request);
-    connect(reply, SIGNAL(finished()), this, SLOT(onDownloadFinished()));
+    QString appDir = QCoreApplication::applicationDirPath();
+    if (DeltaUpdater::hasOldFiles(QDir(appDir).filePath(UPDATE_DIR), appDir))
+        clearUpdate();
 }
 
-void Settings::onDownloadFinished()
+QString Settings::restartArgument(const QString &option)
 {
-    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) return;
-
-    reply->deleteLater();
-
-    if (reply->error() != QNetworkReply::NoError)
-    {
-        qWarning() << "下载更新包失败:" << reply->errorString();
-        TrayManager::instance().showMessage("检查更新", "下载更新包失败, 请检查网络然后稍后重试。");
-        return;
-    }
+    return QString("%1=%2").arg(option).arg(QCoreApplication::applicationPid());
+}
 
-    QString filePath = QCoreApplication::applicationDirPath() + "/update.zip";
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly))
-    {
-        qWarning() << "无法打开文件:" << filePath;
-        TrayManager::instance().showMessage("检查更新", "无法打开文件:" + filePath);
+void Settings::downloadUpPack(const QString &downloadUrl, const QString &sha256, const QString &checksumUrl)
+{
+    if (mDownloader != nullptr) {
+        qInfo() << "更新包正在下载中";
         return;
     }
 
-    file.write(reply->readAll());
-    file.close();
-
-    qInfo() << "更新包下载完成:" << filePath;   
-    installUpdate(filePath);
+    qInfo() << "开始下载更新包";
+    TrayManager::instance().showMessage("检查更新", "开始下载更新包,在更新就绪后会通知您。");
+    mDownloadPercent = -1;
+    mDownloader = new UpdateDownloader(mNetworkManager, this);
+    connect(mDownloader, SIGNAL(progress(qint64,qint64)), this, SLOT(onDownloadProgress(qint64,qint64)));
+    connect(mDownloader, SIGNAL(finished(QString)), this, SLOT(onDownloadFinished(QString)));
+    connect(mDownloader, SIGNAL(failed(QString)), this, SLOT(onDownloadFailed(QString)));
+    // 下载到程序目录，中断后下次检查更新时从 update.zip.part 继续
+    mDownloader->start(QUrl(downloadUrl), QCoreApplication::applicationDirPath() + "/update.zip",
+                       sha256, QUrl(checksumUrl));
 }
 
-bool Settings::inflateData(const QByteArray &compressedData, QByteArray &uncompressedData)
+void Settings::onDownloadProgress(qint64 received, qint64 total)
 {
-    if (compressedData.isEmpty()) {
-        return false;
-    }
+    if (total <= 0)
+        return;
 
-    z_stream strm;
-    static const int CHUNK_SIZE = 1024;
-    char out[CHUNK_SIZE];
-    
-    // 初始化 zlib
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    strm.avail_in = compressedData.size();
-    strm.next_in = (Bytef*)compressedData.data();
-
-    int ret = inflateInit2(&strm, -MAX_WBITS);
-    if (ret != Z_OK) {
-        return false;
-    }
+    // 每10%记录一次
+    int percent = int(received * 10 / total) * 10;
+    if (percent == mDownloadPercent)
+        return;
+    mDownloadPercent = percent;
+    qDebug() << QString("更新包下载进度: %1% (%2/%3)").arg(percent).arg(received).arg(total).toUtf8().constData();
+}
 
-    // 解压数据
-    do {
-        strm.avail_out = CHUNK_SIZE;
-        strm.next_out = (Bytef*)out;
+void Settings::onDownloadFinished(const QString &filePath)
+{
+    mDownloader->deleteLater();
+    mDownloader = nullptr;
 
-        ret = inflate(&strm, Z_NO_FLUSH);
-        if (ret < 0) {
-            inflateEnd(&strm);
-            return false;
-        }
+    qInfo() << "更新包下载完成:" << filePath;
+    installUpdate(filePath);
+}
 
-        uncompressedData.append(out, CHUNK_SIZE - strm.avail_out);
-    } while (strm.avail_out == 0);
+void Settings::onDownloadFailed(const QString &error)
+{
+    mDownloader->deleteLater();
+    mDownloader = nullptr;
 
-    inflateEnd(&strm);
-    return true;
+    qWarning() << "下载更新包失败:" << error;
+    TrayManager::instance().showMessage("检查更新", "下载更新包失败, 请检查网络然后稍后重试。");
 }
 
 bool Settings::extractZip(const QString &zipFile, const QString &targetDir)
 {
-    QFile file(zipFile);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "无法打开更新包文件";
+    ZipExtractor extractor(zipFile);
+    if (!extractor.extractAll(targetDir)) {
+        qWarning() << "解压更新包失败:" << extractor.errorString();
         return false;
     }
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    QBuffer buffer(&data);
-    buffer.open(QIODevice::ReadOnly);
-
-    // 读取 ZIP 文件头
-    while (buffer.pos() < buffer.size()) {
-        // ZIP 文件头标识
-        char signature[4];
-        if (buffer.read(signature, 4) != 4) break;
-
-        // 检查是否是文件头标识 (0x04034b50)
-        if (signature[0] != 0x50 || signature[1] != 0x4B || 
-            signature[2] != 0x03 || signature[3] != 0x04) {
-            break;
-        }
-
-        // 读取文件头信息
-        quint16 version, flags, method, modTime, modDate;
-        quint32 crc, compSize, uncompSize;
-        quint16 nameLen, extraLen;
-
-        buffer.read((char*)&version, 2);
-        buffer.read((char*)&flags, 2);
-        buffer.read((char*)&method, 2);
-        buffer.read((char*)&modTime, 2);
-        buffer.read((char*)&modDate, 2);
-        buffer.read((char*)&crc, 4);
-        buffer.read((char*)&compSize, 4);
-        buffer.read((char*)&uncompSize, 4);
-        buffer.read((char*)&nameLen, 2);
-        buffer.read((char*)&extraLen, 2);
-
-        // 读取文件名
-        QByteArray nameData = buffer.read(nameLen);
-        QString fileName = QString::fromLocal8Bit(nameData);
-        
-        // 跳过额外字段
-        buffer.skip(extraLen);
-
-        // 读取压缩数据
-        QByteArray compressedData = buffer.read(compSize);
-        QByteArray uncompressedData;
-
-        // 解压文件
-        if (method == 0) {  // 存储
-            uncompressedData = compressedData;
-        } else if (method == 8) {  // DEFLATE
-            if (!inflateData(compressedData, uncompressedData)) {
-                qWarning() << "解压文件失败:" << fileName;
-                continue;
-            }
-        } else {
-            qWarning() << "不支持的压缩方法:" << method;
-            continue;
-        }
-
-        // 创建目标文件
-        QString filePath = targetDir + "/" + fileName;
-        QFileInfo fileInfo(filePath);
-        
-        // 创建目录
-        if (fileName.endsWith('/')) {
-            QDir().mkpath(filePath);
-            continue;
-        }
-
-        // 确保目标目录存在
-        QDir().mkpath(fileInfo.absolutePath());
-
-        // 写入文件
-        QFile outFile(filePath);
-        if (outFile.open(QIODevice::WriteOnly)) {
-            outFile.write(uncompressedData);
-            outFile.close();
-        } else {
-            qWarning() << "无法写入文件:" << filePath;
-        }
-    }
-
     return true;
 }
 
@@ -711,10 +632,73 @@ void Settings::installUpdate(const QString &zipFilePath)
     {
         // 运行tmp目录下的程序，使用绝对路径
         QString appPath = QDir::toNativeSeparators(tempDirObj.absoluteFilePath(APPLICATION_NAME));
-        UAC::runArguments("-update", true, appPath);
+        UAC::runArguments(restartArgument("-update"), true, appPath);
         QCoreApplication::quit();
     }
     else
         mUpdate = true;
 }
-    
+
+void Settings::downloadDelta(const QString &manifestUrl)
+{
+    if (mDeltaUpdater != nullptr || mDownloader != nullptr) {
+        qInfo() << "更新正在下载中";
+        return;
+    }
+
+    qInfo() << "开始增量更新";
+    TrayManager::instance().showMessage("检查更新", "开始下载更新文件,在更新就绪后会通知您。");
+    mDownloadPercent = -1;
+    QString appDir = QCoreApplication::applicationDirPath();
+    mDeltaUpdater = new DeltaUpdater(mNetworkManager, appDir, QDir(appDir).filePath(UPDATE_DIR), this);
+    connect(mDeltaUpdater, SIGNAL(progress(qint64,qint64)), this, SLOT(onDownloadProgress(qint64,qint64)));
+    connect(mDeltaUpdater, SIGNAL(finished(int)), this, SLOT(onDeltaFinished(int)));
+    connect(mDeltaUpdater, SIGNAL(failed(QString)), this, SLOT(onDeltaFailed(QString)));
+    mDeltaUpdater->start(QUrl(manifestUrl));
+}
+
+void Settings::onDeltaFinished(int changedFiles)
+{
+    mDeltaUpdater->deleteLater();
+    mDeltaUpdater = nullptr;
+
+    if (changedFiles == 0)
+    {
+        // 清单与本地文件一致，无需替换
+        qWarning() << "增量更新: 没有需要替换的文件";
+        QDir(QDir(QCoreApplication::applicationDirPath()).filePath(UPDATE_DIR)).removeRecursively();
+        return;
+    }
+    qInfo() << "增量更新文件下载完成, 共" << changedFiles << "个";
+
+    // 向用户确认重启
+    if (showMessage(mToolWidget == nullptr ? nullptr : mToolWidget,
+        "更新完成", "更新完成，是否立即重启？", MessageType::Info, "立即重启", "稍后重启" ) == QMessageBox::Accepted)
+    {
+        if (!applyDelta()) {
+            // 原地替换失败（如安装目录需要管理员权限），改用完整更新包
+            qWarning() << "增量更新失败, 改用完整更新包";
+            return downloadUpPack(mPackageUrl, mPackageSha256, mPackageChecksumUrl);
+        }
+        UAC::runArguments(restartArgument("-clear"), UAC::isRunAsAdmin(), QCoreApplication::applicationFilePath());
+        QCoreApplication::quit();
+    }
+    else
+        mDeltaPending = true;
+}
+
+void Settings::onDeltaFailed(const QString &error)
+{
+    mDeltaUpdater->deleteLater();
+    mDeltaUpdater = nullptr;
+
+    qWarning() << "增量更新失败:" << error << ", 改用完整更新包";
+    downloadUpPack(mPackageUrl, mPackageSha256, mPackageChecksumUrl);
+}
+
+// 把暂存的文件替换到程序目录，运行中的程序改名后仍可继续运行到退出
+bool Settings::applyDelta()
+{
+    QString appDir = QCoreApplication::applicationDirPath();
+    return DeltaUpdater::apply(QDir(appDir).filePath(UPDATE_DIR), appDir);
+}
@@ -10,11 +10,12 @@
 
 #include "ToolManager.h"
 #include "HotkeyManager.h"
-#include <QSqlDatabase>
+#include "ConfigStore.h"
 #include <QDir>
 #include <QNetworkAccessManager>
-#include <QtZlib/zlib.h>
-#include <QBuffer>
+
+class UpdateDownloader;
+class DeltaUpdater;
 
 struct HotkeyInfo
 {
@@ -52,11 +53,13 @@ public:
     static bool updateApp();
     static bool copyDirectory(const QString &sourceDirPath, const QString &targetDirPath);
     static void clearUpdate();
+    // 上次增量更新替换下来的旧文件没能全部删除时，正常启动时再清理一次
+    static void clearUpdateLeftovers();
+    // 重启参数附带当前进程号（如 "-clear=1234"），新实例等当前进程退出后再继续
+    static QString restartArgument(const QString &option);
 
 private:
-    QDir mdbDir;
-    QString mdbName;
-    QSqlDatabase mdb;
+    ConfigStore *mConfigStore;
     HotkeyManager *mHotkeyManager;
     HotkeyMap *mHotkeyMap;
     HotkeyIdMap *mHotkeyIdMap;
@@ -66,17 +69,23 @@ private:
     bool mUsingGiteeAPI = false;  // 标记当前使用的是哪个API
     bool mNotify = false;       // 自动检测更新时不需要通知"已是最新"
     bool mUpdate = false;       // 是否需要更新
+    UpdateDownloader *mDownloader = nullptr;
+    int mDownloadPercent = -1;  // 上次记录的下载进度
+    DeltaUpdater *mDeltaUpdater = nullptr;
+    bool mDeltaPending = false; // 增量更新已暂存，退出时替换
+    QString mPackageUrl;        // 完整更新包，增量更新失败时回退使用
+    QString mPackageSha256;
+    QString mPackageChecksumUrl;
 
     // 更新相关
-    void downloadUpPack(const QString& downloadUrl);
+    void downloadUpPack(const QString& downloadUrl, const QString &sha256, const QString &checksumUrl);
     void installUpdate(const QString &zipFilePath);
+    void downloadDelta(const QString &manifestUrl);
+    bool applyDelta();
     bool extractZip(const QString &zipFile, const QString &targetDir);
-    bool inflateData(const QByteArray &compressedData, QByteArray &uncompressedData);
 
     // 数据库相关操作
     bool initializeDatabase();
-    QString loadConfigFromDB(const QString& key, const QString& defaultValue = QString()) const;
-    bool saveConfigToDB(const QString& key, const QString& value) const;
 
 signals:
     void toolActiveChanged();
@@ -91,7 +100,11 @@ private slots:
     void onHotkeyPressed(int);
     void onToolActiveChanged();
     void onUpdateReplyed();
-    void onDownloadFinished();
+    void onDownloadProgress(qint64 received, qint64 total);
+    void onDownloadFinished(const QString &filePath);
+    void onDownloadFailed(const QString &error);
+    void onDeltaFinished(int changedFiles);
+    void onDeltaFailed(const QString &error);
 };
 
 #endif // SETTINGS_H
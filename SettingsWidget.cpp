@@ -83,11 +83,13 @@ void SettingsWidget::initBasePage()
     QGridLayout *updateLayout = new QGridLayout(updateGroupBox);
 
     MacStyleCheckBox *updateCheckBox = new MacStyleCheckBox("自动更新");
+    MacStyleCheckBox *deltaCheckBox  = new MacStyleCheckBox("增量更新");
     MacStyleButton   *checkNewButton = new MacStyleButton("检查更新");
 
     updateLayout->addWidget(updateCheckBox, 0, 0);
-    updateLayout->addWidget(checkNewButton, 0, 1);
-    updateLayout->setColumnStretch(2, 1);   // 添加填充
+    updateLayout->addWidget(deltaCheckBox,  0, 1);
+    updateLayout->addWidget(checkNewButton, 0, 2);
+    updateLayout->setColumnStretch(3, 1);   // 添加填充
 
 
     // 创建日志区域
@@ -95,11 +97,13 @@ void SettingsWidget::initBasePage()
     QGridLayout *logLayout = new QGridLayout(logGroupBox);
 
     MacStyleCheckBox *debugCheckBox   = new MacStyleCheckBox("debug日志");
+    MacStyleCheckBox *binaryCheckBox  = new MacStyleCheckBox("二进制日志");
     MacStyleButton   *exportLogButton = new MacStyleButton("查看日志");
 
     logLayout->addWidget(debugCheckBox,   0, 0);
-    logLayout->addWidget(exportLogButton, 0, 1);
-    logLayout->setColumnStretch(2, 1); // 设置第 3 列的弹簧
+    logLayout->addWidget(binaryCheckBox,  0, 1);
+    logLayout->addWidget(exportLogButton, 0, 2);
+    logLayout->setColumnStretch(3, 1); // 设置第 4 列的弹簧
 
 
     // 添加各个区域到mainLayout
@@ -114,7 +118,9 @@ void SettingsWidget::initBasePage()
     loadConfigHandler(startCheckBox);
     loadConfigHandler(adminStartCheckBox);
     loadConfigHandler(updateCheckBox);
+    loadConfigHandler(deltaCheckBox);
     loadConfigHandler(debugCheckBox);
+    loadConfigHandler(binaryCheckBox);
 
     // 连接槽 - 按钮
     connect(checkNewButton,  SIGNAL(clicked()), this, SLOT(buttonClicked()));
@@ -124,7 +130,9 @@ void SettingsWidget::initBasePage()
     connect(startCheckBox,      SIGNAL(clicked(bool)), this, SLOT(checkBoxChecked(bool)));
     connect(adminStartCheckBox, SIGNAL(clicked(bool)), this, SLOT(checkBoxChecked(bool)));
     connect(updateCheckBox,     SIGNAL(clicked(bool)), this, SLOT(checkBoxChecked(bool)));
+    connect(deltaCheckBox,      SIGNAL(clicked(bool)), this, SLOT(checkBoxChecked(bool)));
     connect(debugCheckBox,      SIGNAL(clicked(bool)), this, SLOT(checkBoxChecked(bool)));
+    connect(binaryCheckBox,     SIGNAL(clicked(bool)), this, SLOT(checkBoxChecked(bool)));
 }
 
 // 初始化"应用"页面
@@ -450,7 +458,9 @@ void SettingsWidget::buttonClicked()
 
     if (button->text() == "查看日志")
     {
-        QUrl fileUrl = QUrl::fromLocalFile("log/log.txt");
+        // 二进制日志需要 logdump 转换，直接打开日志目录
+        bool binary = LogHandler::instance().logFormat() == BinaryFormat;
+        QUrl fileUrl = QUrl::fromLocalFile(binary ? "log" : "log/log.txt");
         // 使用默认程序打开日志文件
         if (!QDesktopServices::openUrl(fileUrl))
         {
@@ -494,6 +504,9 @@ void SettingsWidget::checkBoxChecked(bool checked)
     {
         LogHandler::instance().setLogLevel(checked ? DebugLevel : InfoLevel);
         qInfo() << (checked ? "开启" : "关闭") << "debug日志";
+    } else if (checkBox->text() == "二进制日志") {
+        qInfo() << "日志格式切换为" << (checked ? "二进制" : "文本");
+        LogHandler::instance().setLogFormat(checked ? BinaryFormat : TextFormat);
     } else if(checkBox->text() == "开机自启动") {
         if (!UAC::setApplicationStartup(checked))
         {
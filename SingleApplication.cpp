@@ -1,5 +1,6 @@
 #include "SingleApplication.h"
 #include <QLocalSocket>
+#include "Metrics.h"
 
 SingleApplication::SingleApplication(int& argc, char* argv[], const QString uniqueKey)
     : QApplication(argc, argv)
@@ -40,6 +41,17 @@ void SingleApplication::onNewConnection()
 
     QByteArray byteArray = localSocket->readAll();
     QString message = QString::fromUtf8(byteArray.constData());
+
+    // metrics request: reply with a text snapshot instead of forwarding the message
+    if (message.trimmed() == "metrics")
+    {
+        localSocket->write(Metrics::snapshot().toUtf8());
+        localSocket->waitForBytesWritten(mTimeout);
+        localSocket->disconnectFromServer();
+        localSocket->deleteLater();
+        return;
+    }
+
     emit signalMessageAvailable(message);
     localSocket->disconnectFromServer();
 }
@@ -0,0 +1,280 @@
+/**
+ * @file Storage.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 01:48:52
+ * @brief 统一存储：所有工具共用 data/LazyDogTools.db，连接只在专用的数据库线程上使用
+ */
+
+#include "Storage.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+
+static const char *CONNECTION_NAME = "LazyDogTools-Storage";
+static const char *DATABASE_FILE = "LazyDogTools.db";
+static const int CHECKPOINT_IDLE_MS = 30 * 1000;    // 空闲这么久后回写WAL
+static const int CHECKPOINT_TASKS = 1000;           // 持续繁忙时每执行这么多任务回写一次
+
+Storage &Storage::instance()
+{
+    static Storage instance;
+    return instance;
+}
+
+Storage::Storage()
+    : mStopping(false)
+    , mTasksSinceCheckpoint(0)
+{
+    mThread = QThread::create([this]() { run(); });
+    mThread->setObjectName("Storage");
+    mThread->start();
+}
+
+Storage::~Storage()
+{
+    {
+        QMutexLocker locker(&mMutex);
+        mStopping = true;
+        mWakeCondition.wakeOne();
+    }
+    // 数据库线程会先执行完队列中剩余的任务再退出
+    mThread->wait();
+    delete mThread;
+}
+
+void Storage::post(const Task &task)
+{
+    QMutexLocker locker(&mMutex);
+    if (mStopping) {
+        qWarning() << "Storage is stopped, task dropped";
+        return;
+    }
+    mTasks.append(task);
+    mWakeCondition.wakeOne();
+}
+
+void Storage::execute(const Task &task)
+{
+    if (QThread::currentThread() == mThread) {
+        task(mdb);
+        return;
+    }
+
+    QSemaphore done;
+    {
+        QMutexLocker locker(&mMutex);
+        if (mStopping) {
+            qWarning() << "Storage is stopped, task dropped";
+            return;
+        }
+        mTasks.append([&task, &done](QSqlDatabase &db) {
+            task(db);
+            done.release();
+        });
+        mWakeCondition.wakeOne();
+    }
+    done.acquire();
+}
+
+bool Storage::migrate(const QString &name, const QList<QStringList> &steps,
+                      const QString &legacyFile, const QStringList &imports)
+{
+    return call<bool>([&](QSqlDatabase &) { return migrateSchema(name, steps, legacyFile, imports); });
+}
+
+void Storage::run()
+{
+    open();
+
+    QList<Task> tasks;
+    for (;;)
+    {
+        {
+            QMutexLocker locker(&mMutex);
+            if (mTasks.isEmpty() && !mStopping)
+            {
+                // 空闲时顺便回写WAL，没有写入过就不必唤醒
+                if (!mWakeCondition.wait(&mMutex, CHECKPOINT_IDLE_MS) && mTasksSinceCheckpoint > 0) {
+                    locker.unlock();
+                    checkpoint("PASSIVE");
+                    continue;
+                }
+            }
+            if (mTasks.isEmpty() && mStopping)
+                break;
+            tasks.swap(mTasks);
+        }
+
+        for (const Task &task : std::as_const(tasks))
+            task(mdb);
+        mTasksSinceCheckpoint += tasks.size();
+        tasks.clear();
+
+        if (mTasksSinceCheckpoint >= CHECKPOINT_TASKS)
+            checkpoint("PASSIVE");
+    }
+
+    close();
+}
+
+bool Storage::open()
+{
+    QDir dir("data");
+    if (!dir.exists()) dir.mkpath(".");
+
+    mdb = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
+    mdb.setDatabaseName(dir.filePath(DATABASE_FILE));
+    if (!mdb.open()) {
+        qCritical() << "Failed to open the database:" << mdb.lastError().text();
+        return false;
+    }
+
+    // WAL 回写由本线程在空闲时进行，提交时不再自动回写
+    static const char *pragmas[] = {
+        "PRAGMA journal_mode = WAL",
+        "PRAGMA synchronous = NORMAL",
+        "PRAGMA cache_size = -4096",     // 单位 KiB
+        "PRAGMA temp_store = MEMORY",
+        "PRAGMA wal_autocheckpoint = 0",
+    };
+
+    QSqlQuery query(mdb);
+    for (const char *pragma : pragmas)
+    {
+        if (!query.exec(pragma))
+            qWarning() << "Failed to apply" << pragma << ":" << query.lastError().text();
+    }
+
+    if (!query.exec("CREATE TABLE IF NOT EXISTS schema_versions ("
+                    "name TEXT PRIMARY KEY,"
+                    "version INTEGER NOT NULL)")) {
+        qCritical() << "create table (schema_versions) failed:" << query.lastError().text()
+                    << ",Error code:" << query.lastError().nativeErrorCode();
+        return false;
+    }
+    return true;
+}
+
+void Storage::close()
+{
+    if (mdb.isOpen()) {
+        checkpoint("TRUNCATE");
+        mdb.close();
+    }
+    mdb = QSqlDatabase();
+    QSqlDatabase::removeDatabase(CONNECTION_NAME);
+}
+
+void Storage::checkpoint(const char *mode)
+{
+    mTasksSinceCheckpoint = 0;
+    if (!mdb.isOpen())
+        return;
+
+    QSqlQuery query(mdb);
+    if (!query.exec(QString("PRAGMA wal_checkpoint(%1)").arg(mode)))
+        qWarning() << "WAL checkpoint failed:" << query.lastError().text();
+}
+
+bool Storage::migrateSchema(const QString &name, const QList<QStringList> &steps,
+                            const QString &legacyFile, const QStringList &imports)
+{
+    if (!mdb.isOpen())
+        return false;
+
+    QSqlQuery query(mdb);
+    query.prepare("SELECT version FROM schema_versions WHERE name = :name");
+    query.bindValue(":name", name);
+    if (!query.exec()) {
+        qCritical() << "Read schema version of" << name << "failed:" << query.lastError().text();
+        return false;
+    }
+    int version = query.next() ? query.value(0).toInt() : 0;
+    query.finish();
+
+    if (version > steps.size()) {
+        qWarning() << "Schema version of" << name << "is" << version << ", newer than supported" << steps.size();
+        return true;
+    }
+    if (version == steps.size())
+        return true;
+
+    // ATTACH 不能在事务中执行
+    bool legacy = version == 0 && !imports.isEmpty() && !legacyFile.isEmpty() && QFile::exists(legacyFile);
+    if (legacy)
+    {
+        query.prepare("ATTACH DATABASE :file AS legacy");
+        query.bindValue(":file", legacyFile);
+        if (!query.exec()) {
+            qWarning() << "Attach legacy database" << legacyFile << "failed:" << query.lastError().text();
+            legacy = false;
+        }
+    }
+
+    bool imported = false;
+    bool ok = true;
+    // 每个版本在独立事务中完成，失败时停留在上一个版本
+    for (int target = version + 1; ok && target <= steps.size(); ++target)
+    {
+        if (!mdb.transaction()) {
+            qCritical() << "Begin migration of" << name << "failed:" << mdb.lastError().text();
+            ok = false;
+            break;
+        }
+
+        for (const QString &sql : steps.at(target - 1))
+        {
+            if (!query.exec(sql)) {
+                qCritical() << "Migrate" << name << "to version" << target << "failed:" << query.lastError().text()
+                            << ",Error code:" << query.lastError().nativeErrorCode();
+                ok = false;
+                break;
+            }
+        }
+
+        // 导入失败只回滚导入部分，不影响新结构的建立
+        if (ok && legacy && target == steps.size() && query.exec("SAVEPOINT legacy_import"))
+        {
+            imported = true;
+            for (const QString &sql : imports)
+            {
+                if (!query.exec(sql)) {
+                    qWarning() << "Import legacy data of" << name << "failed:" << query.lastError().text();
+                    imported = false;
+                    break;
+                }
+            }
+            query.exec(imported ? "RELEASE legacy_import" : "ROLLBACK TO legacy_import");
+        }
+
+        if (ok) {
+            query.prepare("INSERT OR REPLACE INTO schema_versions (name, version) VALUES (:name, :version)");
+            query.bindValue(":name", name);
+            query.bindValue(":version", target);
+            ok = query.exec();
+        }
+
+        if (!ok || !mdb.commit()) {
+            mdb.rollback();
+            ok = false;
+            break;
+        }
+        qInfo() << "Schema of" << name << "migrated to version" << target;
+    }
+
+    if (legacy)
+    {
+        query.exec("DETACH DATABASE legacy");
+        // 导入完成后保留一份旧文件备份，不再重复导入
+        if (ok && imported) {
+            QFile::remove(legacyFile + ".bak");
+            QFile::rename(legacyFile, legacyFile + ".bak");
+            QFile::remove(legacyFile + "-wal");
+            QFile::remove(legacyFile + "-shm");
+            qInfo() << "Legacy database imported:" << legacyFile;
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,87 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+/**
+ * @file Storage.h
+ * @author Asteri5m
+ * @date 2026-10-17 01:48:52
+ * @brief 统一存储：所有工具共用 data/LazyDogTools.db，连接只在专用的数据库线程上使用
+ *
+ * 各工具的表以命名空间为前缀（如 settings_config、audio_related），结构版本按命名空间记录。
+ * 写入用 post 投递后立即返回；需要结果时用 call 等待，或用 query 把结果送回调用方所在线程：
+ *     Storage::instance().post([=](QSqlDatabase &db) { ... });
+ *     bool ok = Storage::instance().call<bool>([&](QSqlDatabase &db) { ...; return true; });
+ */
+
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSemaphore>
+#include <QPointer>
+#include <functional>
+
+class Storage
+{
+public:
+    typedef std::function<void(QSqlDatabase &)> Task;
+
+    static Storage &instance();
+
+    // 投递到数据库线程执行，不等待
+    void post(const Task &task);
+    // 在数据库线程执行并等待完成，数据库线程内调用时直接执行
+    void execute(const Task &task);
+
+    template<typename T>
+    T call(const std::function<T(QSqlDatabase &)> &task)
+    {
+        T result{};
+        execute([&result, &task](QSqlDatabase &db) { result = task(db); });
+        return result;
+    }
+
+    // 在数据库线程执行，结果排队送回 context 所在线程；context 已销毁时丢弃结果
+    template<typename T>
+    void query(const std::function<T(QSqlDatabase &)> &task, QObject *context,
+               const std::function<void(const T &)> &callback)
+    {
+        QPointer<QObject> guard(context);
+        post([task, guard, callback](QSqlDatabase &db) {
+            T result = task(db);
+            if (!guard.isNull())
+                QMetaObject::invokeMethod(guard.data(), [callback, result]() { callback(result); }, Qt::QueuedConnection);
+        });
+    }
+
+    // 按命名空间升级表结构，steps[i] 为升级到版本 i+1 的语句，只能在末尾追加。
+    // 命名空间首次创建且 legacyFile 存在时，旧文件以 legacy 名称附加，imports 在最后一个版本的事务中执行
+    bool migrate(const QString &name, const QList<QStringList> &steps,
+                 const QString &legacyFile = QString(), const QStringList &imports = QStringList());
+
+private:
+    Storage();
+    ~Storage();
+    Storage(const Storage &) = delete;
+    Storage &operator=(const Storage &) = delete;
+
+    void run();
+    bool open();
+    void close();
+    void checkpoint(const char *mode);
+    bool migrateSchema(const QString &name, const QList<QStringList> &steps,
+                       const QString &legacyFile, const QStringList &imports);
+
+    QThread *mThread;
+    QMutex mMutex;
+    QWaitCondition mWakeCondition;
+    QList<Task> mTasks;
+    bool mStopping;
+
+    // 以下只在数据库线程访问
+    QSqlDatabase mdb;
+    int mTasksSinceCheckpoint;
+};
+
+#endif // STORAGE_H
@@ -6,6 +6,7 @@
  */
 
 #include "ToolManager.h"
+#include "Trace.h"
 
 ToolManager::ToolManager() {}
 
@@ -17,6 +18,7 @@ ToolManager& ToolManager::instance()
 
 ToolModel* ToolManager::createTool(const QString& toolID) 
 {
+    TRACE_SCOPE("ToolManager::createTool");
     // 如果工具已经创建，则直接返回已有的实例
     if (mCreatedTools.contains(toolID)) 
         return mCreatedTools[toolID];
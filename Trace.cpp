@@ -0,0 +1,221 @@
+/**
+ * @file Trace.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 00:24:08
+ * @brief 性能追踪：作用域计时片段记录到各线程自己的缓冲区，按需导出为 Chrome/Perfetto 的 trace-event JSON
+ */
+
+#include "Trace.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QMutex>
+#include <QList>
+#include <QTextStream>
+#include <QCoreApplication>
+#include <list>
+#include <memory>
+
+#include <Windows.h>
+
+static const int TRACE_BUFFER_SIZE = 16384;    // 每个线程保留最近的片段数
+static const int TRACE_FINISHED_BUFFERS = 8;   // 未导出时最多保留的已退出线程缓冲区数
+
+struct TraceEvent {
+    const char *name;
+    qint64 begin;       // 纳秒
+    qint64 end;
+};
+
+// 每个线程一个环形缓冲，只有所属线程写入；导出时短暂加锁复制，平时锁无竞争
+struct TraceBuffer {
+    QMutex mutex;
+    QList<TraceEvent> events;
+    int next = 0;
+    bool wrapped = false;
+    quint32 threadId = 0;
+    QString threadName;
+    bool finished = false;  // 所属线程已退出，受 TraceRegistry::mutex 保护
+};
+
+struct TraceRegistry {
+    QMutex mutex;
+    QElapsedTimer clock;
+    // 线程退出后缓冲区保留到下一次导出；线程池会反复创建线程，未导出时只保留最近退出的几个
+    std::list<std::unique_ptr<TraceBuffer>> buffers;
+    int finished = 0;
+};
+
+static TraceRegistry &registry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+// 线程退出时标记其缓冲区，超出上限时释放最早退出的线程的缓冲区
+static void finishBuffer(TraceBuffer *buffer)
+{
+    TraceRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    buffer->finished = true;
+    if (++reg.finished <= TRACE_FINISHED_BUFFERS)
+        return;
+
+    for (auto it = reg.buffers.begin(); it != reg.buffers.end(); ++it) {
+        if ((*it)->finished) {
+            reg.buffers.erase(it);
+            --reg.finished;
+            return;
+        }
+    }
+}
+
+struct TraceThread {
+    TraceBuffer *buffer = nullptr;
+
+    ~TraceThread()
+    {
+        if (buffer != nullptr)
+            finishBuffer(buffer);
+    }
+};
+
+static TraceBuffer *threadBuffer()
+{
+    thread_local TraceThread traceThread;
+    TraceBuffer *&buffer = traceThread.buffer;
+    if (buffer != nullptr)
+        return buffer;
+
+    std::unique_ptr<TraceBuffer> created(new TraceBuffer);
+    created->events.resize(TRACE_BUFFER_SIZE);
+    created->threadId = quint32(GetCurrentThreadId());
+    if (QThread *thread = QThread::currentThread())
+        created->threadName = thread->objectName();
+    if (created->threadName.isEmpty() && QCoreApplication::instance() != nullptr
+        && QThread::currentThread() == QCoreApplication::instance()->thread())
+        created->threadName = "Main";
+
+    TraceRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    buffer = created.get();
+    reg.buffers.push_back(std::move(created));
+    return buffer;
+}
+
+static QString escapeJson(const QString &text)
+{
+    QString escaped;
+    escaped.reserve(text.size());
+    for (QChar c : text) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        if (c.unicode() < 0x20)
+            escaped += QString("\\u%1").arg(c.unicode(), 4, 16, QLatin1Char('0'));
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+std::atomic<bool> Trace::sEnabled(false);
+
+void Trace::setEnabled(bool enabled)
+{
+    TraceRegistry &reg = registry();
+    {
+        QMutexLocker locker(&reg.mutex);
+        if (!reg.clock.isValid())
+            reg.clock.start();
+    }
+    sEnabled.store(enabled, std::memory_order_release);  // 保证其它线程看到开启时计时起点已建立
+}
+
+qint64 Trace::now()
+{
+    return registry().clock.nsecsElapsed();
+}
+
+void Trace::record(const char *name, qint64 begin, qint64 end)
+{
+    TraceBuffer *buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    buffer->events[buffer->next] = {name, begin, end};
+    if (++buffer->next == TRACE_BUFFER_SIZE) {
+        buffer->next = 0;
+        buffer->wrapped = true;
+    }
+}
+
+QString Trace::defaultFileName()
+{
+    return QDir("log").filePath(QString("trace_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+}
+
+bool Trace::dump(const QString &fileName)
+{
+    QString text;
+    QTextStream out(&text);
+    const qint64 pid = qint64(GetCurrentProcessId());
+    bool first = true;
+
+    auto separator = [&out, &first]() {
+        if (!first)
+            out << ",\n";
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    TraceRegistry &reg = registry();
+    QMutexLocker registryLocker(&reg.mutex);
+    for (const std::unique_ptr<TraceBuffer> &buffer : reg.buffers)
+    {
+        QList<TraceEvent> events;
+        {
+            QMutexLocker locker(&buffer->mutex);
+            if (buffer->wrapped)
+                events = buffer->events.mid(buffer->next) + buffer->events.mid(0, buffer->next);
+            else
+                events = buffer->events.mid(0, buffer->next);
+        }
+
+        if (!buffer->threadName.isEmpty()) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->threadId
+                << ",\"args\":{\"name\":\"" << escapeJson(buffer->threadName) << "\"}}";
+        }
+
+        // Chrome 格式的时间单位为微秒
+        for (const TraceEvent &event : std::as_const(events)) {
+            separator();
+            out << "{\"name\":\"" << escapeJson(QString::fromLatin1(event.name)) << "\",\"ph\":\"X\",\"pid\":" << pid
+                << ",\"tid\":" << buffer->threadId
+                << ",\"ts\":" << QString::number(event.begin / 1000.0, 'f', 3)
+                << ",\"dur\":" << QString::number((event.end - event.begin) / 1000.0, 'f', 3) << "}";
+        }
+    }
+
+    // 已退出线程的片段已经写入本次导出，不会再有新片段，释放其缓冲区
+    for (auto it = reg.buffers.begin(); it != reg.buffers.end();) {
+        if ((*it)->finished)
+            it = reg.buffers.erase(it);
+        else
+            ++it;
+    }
+    reg.finished = 0;
+    registryLocker.unlock();
+
+    out << "\n]}\n";
+    out.flush();
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(text.toUtf8());
+    return file.commit();
+}
@@ -0,0 +1,66 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * @file Trace.h
+ * @author Asteri5m
+ * @date 2026-10-17 00:24:08
+ * @brief 性能追踪：作用域计时片段记录到各线程自己的缓冲区，按需导出为 Chrome/Perfetto 的 trace-event JSON
+ *
+ * 用法：TRACE_SCOPE("TaskMonitor::collectWindows");
+ * 未开启追踪时只有一次原子读；定义 LAZYDOG_NO_TRACE 后宏展开为空，不产生任何代码。
+ */
+
+#include <QString>
+#include <atomic>
+
+class Trace
+{
+public:
+    static bool isEnabled() { return sEnabled.load(std::memory_order_acquire); }
+    static void setEnabled(bool enabled);
+
+    // 导出全部线程缓冲区中的片段，成功返回 true
+    static bool dump(const QString &fileName);
+    // 默认导出位置：log/trace_yyyyMMdd_hhmmss.json
+    static QString defaultFileName();
+
+    static qint64 now();
+    static void record(const char *name, qint64 begin, qint64 end);
+
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name)
+        : mName(Trace::isEnabled() ? name : nullptr)
+        , mBegin(mName != nullptr ? Trace::now() : 0)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (mName != nullptr)
+            Trace::record(mName, mBegin, Trace::now());
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *mName;  // 必须是字符串字面量，导出时才读取
+    qint64 mBegin;
+};
+
+#ifdef LAZYDOG_NO_TRACE
+#define TRACE_SCOPE(name) do {} while (false)
+#else
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,251 @@
+/**
+ * @file UpdateDownloader.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 03:02:44
+ * @brief 更新包下载：边接收边写入 .part 文件并计算 SHA-256，中断后用 Range 请求续传
+ */
+
+#include "UpdateDownloader.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QDebug>
+
+static const qint64 HASH_CHUNK_SIZE = 1024 * 1024;
+
+UpdateDownloader::UpdateDownloader(QNetworkAccessManager *manager, QObject *parent)
+    : QObject(parent)
+    , mManager(manager)
+    , mHash(QCryptographicHash::Sha256)
+    , mOffset(0)
+    , mAccepted(false)
+    , mRestarted(false)
+{
+}
+
+UpdateDownloader::~UpdateDownloader()
+{
+    if (!mReply.isNull()) {
+        mReply->disconnect(this);
+        mReply->abort();
+    }
+}
+
+void UpdateDownloader::start(const QUrl &url, const QString &filePath, const QString &sha256, const QUrl &checksumUrl)
+{
+    mUrl = url;
+    mFilePath = filePath;
+    mSha256 = sha256.trimmed().toLower().toLatin1();
+    mRestarted = false;
+
+    if (mSha256.isEmpty() && checksumUrl.isValid())
+    {
+        QNetworkRequest request(checksumUrl);
+        request.setHeader(QNetworkRequest::UserAgentHeader, "LazyDogTools");
+        mReply = mManager->get(request);
+        connect(mReply, SIGNAL(finished()), this, SLOT(onChecksumFinished()));
+        return;
+    }
+
+    startDownload();
+}
+
+void UpdateDownloader::abort()
+{
+    if (!mReply.isNull())
+        mReply->abort();
+}
+
+void UpdateDownloader::onChecksumFinished()
+{
+    QNetworkReply *reply = mReply;
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        fail("下载校验文件失败: " + reply->errorString());
+        return;
+    }
+
+    // sha256sum 的输出格式，只取第一段
+    QByteArray hex = reply->readAll().simplified().split(' ').value(0).toLower();
+    if (hex.size() != 64) {
+        fail("校验文件格式错误");
+        return;
+    }
+    mSha256 = hex;
+    startDownload();
+}
+
+void UpdateDownloader::startDownload()
+{
+    if (!resumePart())
+        restartPart();
+    if (!mPart.isOpen()) {
+        fail("无法打开文件: " + partFileName());
+        return;
+    }
+
+    QNetworkRequest request(mUrl);
+    request.setHeader(QNetworkRequest::UserAgentHeader, "LazyDogTools");
+    if (mOffset > 0)
+    {
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(mOffset) + "-");
+        // 服务器上的文件已变化时会返回完整内容而不是片段
+        if (!mValidator.isEmpty())
+            request.setRawHeader("If-Range", mValidator);
+        qInfo() << "继续下载更新包, 已下载:" << mOffset;
+    }
+
+    mAccepted = false;
+    mReply = mManager->get(request);
+    connect(mReply, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+    connect(mReply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(onDownloadProgress(qint64,qint64)));
+    connect(mReply, SIGNAL(finished()), this, SLOT(onFinished()));
+}
+
+// 收到第一段数据时根据状态码决定续传还是从头写入
+bool UpdateDownloader::accept()
+{
+    int status = mReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status >= 300)
+        return false;
+
+    if (mOffset > 0)
+    {
+        QByteArray range = mReply->rawHeader("Content-Range");
+        if (status != 206 || !range.startsWith("bytes " + QByteArray::number(mOffset) + "-")) {
+            qInfo() << "服务器未接受续传, 重新下载";
+            restartPart();
+        }
+    }
+
+    QByteArray validator = mReply->rawHeader("ETag");
+    if (validator.isEmpty())
+        validator = mReply->rawHeader("Last-Modified");
+    if (validator != mValidator || mOffset == 0)
+    {
+        mValidator = validator;
+        QFile meta(metaFileName());
+        if (meta.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            meta.write(mUrl.toEncoded() + "\n" + mValidator + "\n");
+    }
+
+    mAccepted = true;
+    return true;
+}
+
+void UpdateDownloader::onReadyRead()
+{
+    if (!mAccepted && !accept())
+        return;
+
+    QByteArray data = mReply->readAll();
+    if (mPart.write(data) != data.size()) {
+        // 先关闭文件，随后由 abort 触发的 finished 不再重复报告
+        QString error = mPart.errorString();
+        mPart.close();
+        fail("写入更新包失败: " + error);
+        mReply->abort();
+        return;
+    }
+    mHash.addData(data);
+}
+
+void UpdateDownloader::onDownloadProgress(qint64 received, qint64 total)
+{
+    emit progress(mOffset + received, total < 0 ? -1 : mOffset + total);
+}
+
+void UpdateDownloader::onFinished()
+{
+    QNetworkReply *reply = mReply;
+    reply->deleteLater();
+    if (!mPart.isOpen())
+        return;     // 已在写入失败时报告过
+
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 416 && !mRestarted)
+    {
+        // 已有的片段与服务器上的文件不符，从头下载一次
+        mRestarted = true;
+        mPart.close();
+        QFile::remove(partFileName());
+        QFile::remove(metaFileName());
+        startDownload();
+        return;
+    }
+
+    if (reply->error() != QNetworkReply::NoError) {
+        // 保留 .part，下次从断点继续
+        mPart.close();
+        fail("下载更新包失败: " + reply->errorString());
+        return;
+    }
+
+    if (!mAccepted)
+        accept();
+    mPart.close();
+
+    QByteArray digest = mHash.result().toHex();
+    if (!mSha256.isEmpty() && digest != mSha256)
+    {
+        QFile::remove(partFileName());
+        QFile::remove(metaFileName());
+        fail(QString("更新包校验失败, 期望 %1, 实际 %2").arg(QString::fromLatin1(mSha256), QString::fromLatin1(digest)));
+        return;
+    }
+    if (mSha256.isEmpty())
+        qWarning() << "更新包未提供 SHA-256, 跳过校验";
+
+    QFile::remove(mFilePath);
+    if (!QFile::rename(partFileName(), mFilePath)) {
+        fail("无法保存更新包: " + mFilePath);
+        return;
+    }
+    QFile::remove(metaFileName());
+    emit finished(mFilePath);
+}
+
+// .part 与记录的下载地址一致时接着写入，并先把已有内容计入摘要
+bool UpdateDownloader::resumePart()
+{
+    mPart.close();
+    mPart.setFileName(partFileName());
+    mHash.reset();
+    mOffset = 0;
+    mValidator.clear();
+
+    QFile meta(metaFileName());
+    if (!mPart.exists() || !meta.open(QIODevice::ReadOnly))
+        return false;
+
+    QList<QByteArray> lines = meta.readAll().split('\n');
+    if (lines.value(0) != mUrl.toEncoded())
+        return false;
+
+    if (!mPart.open(QIODevice::ReadWrite))
+        return false;
+
+    QByteArray chunk;
+    while (!(chunk = mPart.read(HASH_CHUNK_SIZE)).isEmpty())
+        mHash.addData(chunk);
+
+    mOffset = mPart.pos();
+    mValidator = lines.value(1);
+    return mOffset > 0;
+}
+
+void UpdateDownloader::restartPart()
+{
+    mPart.close();
+    mPart.setFileName(partFileName());
+    mHash.reset();
+    mOffset = 0;
+    mPart.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+void UpdateDownloader::fail(const QString &error)
+{
+    qWarning() << error;
+    emit failed(error);
+}
@@ -0,0 +1,67 @@
+#ifndef UPDATEDOWNLOADER_H
+#define UPDATEDOWNLOADER_H
+
+/**
+ * @file UpdateDownloader.h
+ * @author Asteri5m
+ * @date 2026-10-17 03:02:44
+ * @brief 更新包下载：边接收边写入 .part 文件并计算 SHA-256，中断后用 Range 请求续传
+ *
+ * 只依赖传入的 QNetworkAccessManager 与 URL，可直接指向本地 HTTP 服务验证续传与校验流程。
+ */
+
+#include <QObject>
+#include <QUrl>
+#include <QFile>
+#include <QCryptographicHash>
+#include <QPointer>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+class UpdateDownloader : public QObject
+{
+    Q_OBJECT
+public:
+    UpdateDownloader(QNetworkAccessManager *manager, QObject *parent = nullptr);
+    ~UpdateDownloader();
+
+    // sha256 为十六进制摘要；为空但给出 checksumUrl 时先下载校验文件（"<hex>  <文件名>" 格式）
+    void start(const QUrl &url, const QString &filePath,
+               const QString &sha256 = QString(), const QUrl &checksumUrl = QUrl());
+    void abort();
+
+signals:
+    void progress(qint64 received, qint64 total);
+    void finished(const QString &filePath);
+    void failed(const QString &error);
+
+private slots:
+    void onChecksumFinished();
+    void onReadyRead();
+    void onDownloadProgress(qint64 received, qint64 total);
+    void onFinished();
+
+private:
+    void startDownload();
+    bool accept();
+    bool resumePart();
+    void restartPart();
+    void fail(const QString &error);
+    QString partFileName() const { return mFilePath + ".part"; }
+    QString metaFileName() const { return mFilePath + ".part.meta"; }
+
+    QNetworkAccessManager *mManager;
+    QPointer<QNetworkReply> mReply;
+    QUrl mUrl;
+    QString mFilePath;
+    QByteArray mSha256;
+    QFile mPart;
+    QCryptographicHash mHash;
+    qint64 mOffset;         // 续传起点，即本次请求前 .part 已有的字节数
+    bool mAccepted;         // 已根据响应状态确定是续传还是重新下载
+    bool mRestarted;        // 续传被拒绝(416)后已从头重试过一次
+    QByteArray mValidator;  // ETag 或 Last-Modified，续传时用于 If-Range
+};
+
+#endif // UPDATEDOWNLOADER_H
@@ -0,0 +1,352 @@
+/**
+ * @file ZipExtractor.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 02:31:15
+ * @brief 更新包解压：按中央目录定位条目，内存映射读取，各条目在线程池中直接解压到目标文件
+ */
+
+#include "ZipExtractor.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <zlib.h>
+
+static const quint32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+static const quint32 CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+static const quint32 END_OF_CENTRAL_SIGNATURE = 0x06054b50;
+static const quint32 ZIP64_END_OF_CENTRAL_SIGNATURE = 0x06064b50;
+static const quint32 ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+
+static const int LOCAL_HEADER_SIZE = 30;
+static const int CENTRAL_HEADER_SIZE = 46;
+static const int END_OF_CENTRAL_SIZE = 22;
+static const int MAX_COMMENT_SIZE = 0xFFFF;
+
+static const quint16 FLAG_ENCRYPTED = 0x0001;
+static const quint16 FLAG_UTF8 = 0x0800;
+
+static const int OUTPUT_BUFFER_SIZE = 1024 * 1024;
+
+// ZIP 中的整数均为小端
+static inline quint16 readU16(const uchar *p)
+{
+    return quint16(p[0] | (p[1] << 8));
+}
+
+static inline quint32 readU32(const uchar *p)
+{
+    return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24);
+}
+
+static inline quint64 readU64(const uchar *p)
+{
+    return quint64(readU32(p)) | (quint64(readU32(p + 4)) << 32);
+}
+
+// 拒绝绝对路径和跳出目标目录的条目
+static bool isSafeEntryName(const QString &name)
+{
+    if (name.isEmpty() || name.startsWith('/') || name.startsWith('\\') || name.contains(':'))
+        return false;
+    const QStringList parts = QString(name).replace('\\', '/').split('/');
+    return !parts.contains("..");
+}
+
+ZipExtractor::ZipExtractor(const QString &zipFile)
+    : mZipFile(zipFile)
+{
+}
+
+QString ZipExtractor::errorString() const
+{
+    QMutexLocker locker(&mErrorMutex);
+    return mError;
+}
+
+void ZipExtractor::setError(const QString &error)
+{
+    QMutexLocker locker(&mErrorMutex);
+    // 只保留第一个错误
+    if (mError.isEmpty())
+        mError = error;
+}
+
+bool ZipExtractor::extractAll(const QString &targetDir)
+{
+    QFile file(mZipFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError("无法打开更新包文件");
+        return false;
+    }
+
+    const qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+    if (data == nullptr) {
+        setError("无法映射更新包文件: " + file.errorString());
+        return false;
+    }
+
+    if (!readCentralDirectory(data, size))
+        return false;
+
+    // 先按顺序建立全部目录，解压线程只负责写文件
+    QDir dir(targetDir);
+    QList<const Entry *> files;
+    for (const Entry &entry : std::as_const(mEntries))
+    {
+        QString filePath = dir.filePath(entry.name);
+        if (entry.name.endsWith('/')) {
+            dir.mkpath(entry.name);
+            continue;
+        }
+        dir.mkpath(QFileInfo(filePath).path());
+        files.append(&entry);
+    }
+
+    // 大文件先开始，减少最后只剩一个线程在工作的时间
+    std::sort(files.begin(), files.end(), [](const Entry *a, const Entry *b) {
+        return a->uncompressedSize > b->uncompressedSize;
+    });
+
+    QThreadPool pool;
+    std::atomic<bool> failed(false);
+    for (const Entry *entry : std::as_const(files))
+    {
+        QString filePath = dir.filePath(entry->name);
+        pool.start([this, data, size, entry, filePath, &failed]() {
+            if (failed.load(std::memory_order_relaxed))
+                return;
+            if (!extractEntry(data, size, *entry, filePath))
+                failed.store(true, std::memory_order_relaxed);
+        });
+    }
+    pool.waitForDone();
+
+    file.unmap(const_cast<uchar *>(data));
+    return !failed.load();
+}
+
+bool ZipExtractor::readCentralDirectory(const uchar *data, qint64 size)
+{
+    // 目录结束记录位于文件末尾，其后可能跟随最长 64KB 的注释
+    qint64 eocd = -1;
+    qint64 lowest = qMax<qint64>(0, size - END_OF_CENTRAL_SIZE - MAX_COMMENT_SIZE);
+    for (qint64 pos = size - END_OF_CENTRAL_SIZE; pos >= lowest; --pos)
+    {
+        if (readU32(data + pos) == END_OF_CENTRAL_SIGNATURE) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd < 0) {
+        setError("更新包格式错误: 未找到中央目录");
+        return false;
+    }
+
+    quint64 count = readU16(data + eocd + 10);
+    quint64 directorySize = readU32(data + eocd + 12);
+    quint64 directoryOffset = readU32(data + eocd + 16);
+
+    // 超过 4GB 或 65535 个条目时使用 ZIP64 记录
+    if (count == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF)
+    {
+        qint64 locator = eocd - 20;
+        if (locator < 0 || readU32(data + locator) != ZIP64_LOCATOR_SIGNATURE) {
+            setError("更新包格式错误: 缺少 ZIP64 定位记录");
+            return false;
+        }
+        quint64 zip64Eocd = readU64(data + locator + 8);
+        if (zip64Eocd + 56 > quint64(size) || readU32(data + zip64Eocd) != ZIP64_END_OF_CENTRAL_SIGNATURE) {
+            setError("更新包格式错误: ZIP64 目录记录损坏");
+            return false;
+        }
+        count = readU64(data + zip64Eocd + 32);
+        directorySize = readU64(data + zip64Eocd + 40);
+        directoryOffset = readU64(data + zip64Eocd + 48);
+    }
+
+    if (directoryOffset + directorySize > quint64(size)) {
+        setError("更新包格式错误: 中央目录越界");
+        return false;
+    }
+
+    mEntries.clear();
+    mEntries.reserve(qsizetype(qMin<quint64>(count, 65535)));
+    const uchar *p = data + directoryOffset;
+    const uchar *end = p + directorySize;
+    for (quint64 i = 0; i < count; ++i)
+    {
+        if (end - p < CENTRAL_HEADER_SIZE || readU32(p) != CENTRAL_HEADER_SIGNATURE) {
+            setError("更新包格式错误: 中央目录条目损坏");
+            return false;
+        }
+
+        Entry entry;
+        entry.flags = readU16(p + 8);
+        entry.method = readU16(p + 10);
+        entry.crc = readU32(p + 16);
+        entry.compressedSize = readU32(p + 20);
+        entry.uncompressedSize = readU32(p + 24);
+        quint16 nameLength = readU16(p + 28);
+        quint16 extraLength = readU16(p + 30);
+        quint16 commentLength = readU16(p + 32);
+        entry.localHeaderOffset = readU32(p + 42);
+
+        if (end - p < CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength) {
+            setError("更新包格式错误: 中央目录条目越界");
+            return false;
+        }
+
+        const char *name = reinterpret_cast<const char *>(p + CENTRAL_HEADER_SIZE);
+        entry.name = (entry.flags & FLAG_UTF8) ? QString::fromUtf8(name, nameLength)
+                                               : QString::fromLocal8Bit(name, nameLength);
+
+        // ZIP64 扩展字段只包含值为 0xFFFFFFFF 的那几项，顺序固定
+        const uchar *extra = p + CENTRAL_HEADER_SIZE + nameLength;
+        const uchar *extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4)
+        {
+            quint16 id = readU16(extra);
+            quint16 length = readU16(extra + 2);
+            const uchar *field = extra + 4;
+            if (extraEnd - field < length)
+                break;
+            if (id == 0x0001)
+            {
+                const uchar *fieldEnd = field + length;
+                if (entry.uncompressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                    entry.uncompressedSize = readU64(field);
+                    field += 8;
+                }
+                if (entry.compressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                    entry.compressedSize = readU64(field);
+                    field += 8;
+                }
+                if (entry.localHeaderOffset == 0xFFFFFFFF && fieldEnd - field >= 8)
+                    entry.localHeaderOffset = readU64(field);
+            }
+            extra += 4 + length;
+        }
+
+        p += CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+
+        if (!isSafeEntryName(entry.name)) {
+            setError("更新包中包含非法路径: " + entry.name);
+            return false;
+        }
+        if (entry.flags & FLAG_ENCRYPTED) {
+            setError("不支持加密的条目: " + entry.name);
+            return false;
+        }
+        mEntries.append(entry);
+    }
+    return true;
+}
+
+// 本地文件头中的大小在使用数据描述符（标志位3）时为0，这里只用它确定数据起点，大小以中央目录为准
+bool ZipExtractor::extractEntry(const uchar *data, qint64 size, const Entry &entry, const QString &filePath)
+{
+    if (entry.localHeaderOffset + LOCAL_HEADER_SIZE > quint64(size)
+        || readU32(data + entry.localHeaderOffset) != LOCAL_HEADER_SIGNATURE) {
+        setError("更新包格式错误: 本地文件头损坏 " + entry.name);
+        return false;
+    }
+
+    const uchar *header = data + entry.localHeaderOffset;
+    quint64 dataOffset = entry.localHeaderOffset + LOCAL_HEADER_SIZE + readU16(header + 26) + readU16(header + 28);
+    if (dataOffset + entry.compressedSize > quint64(size)) {
+        setError("更新包格式错误: 条目数据越界 " + entry.name);
+        return false;
+    }
+
+    if (entry.method != 0 && entry.method != 8) {
+        setError(QString("不支持的压缩方法: %1 (%2)").arg(entry.method).arg(entry.name));
+        return false;
+    }
+
+    QFile out(filePath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        setError("无法写入文件: " + filePath);
+        return false;
+    }
+
+    const uchar *input = data + dataOffset;
+    quint64 remaining = entry.compressedSize;
+    uLong crc = crc32(0L, Z_NULL, 0);
+    quint64 written = 0;
+
+    if (entry.method == 0)
+    {
+        // 存储的条目直接从映射内存写出
+        while (remaining > 0)
+        {
+            qint64 chunk = qint64(qMin<quint64>(remaining, OUTPUT_BUFFER_SIZE));
+            crc = crc32(crc, input, uInt(chunk));
+            if (out.write(reinterpret_cast<const char *>(input), chunk) != chunk) {
+                setError("无法写入文件: " + filePath);
+                return false;
+            }
+            input += chunk;
+            remaining -= quint64(chunk);
+            written += quint64(chunk);
+        }
+    }
+    else
+    {
+        z_stream strm;
+        strm.zalloc = Z_NULL;
+        strm.zfree = Z_NULL;
+        strm.opaque = Z_NULL;
+        strm.avail_in = 0;
+        strm.next_in = Z_NULL;
+        if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+            setError("解压初始化失败: " + entry.name);
+            return false;
+        }
+
+        QByteArray buffer(OUTPUT_BUFFER_SIZE, Qt::Uninitialized);
+        int ret = Z_OK;
+        while (ret != Z_STREAM_END)
+        {
+            // avail_in 为32位，超大条目分段送入
+            if (strm.avail_in == 0 && remaining > 0) {
+                uInt chunk = uInt(qMin<quint64>(remaining, UINT_MAX));
+                strm.next_in = const_cast<Bytef *>(input);
+                strm.avail_in = chunk;
+                input += chunk;
+                remaining -= chunk;
+            }
+
+            strm.next_out = reinterpret_cast<Bytef *>(buffer.data());
+            strm.avail_out = uInt(buffer.size());
+            ret = inflate(&strm, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_STREAM_END) {
+                // 输入已耗尽仍未结束说明数据被截断
+                inflateEnd(&strm);
+                setError("解压文件失败: " + entry.name);
+                return false;
+            }
+
+            qint64 have = buffer.size() - qint64(strm.avail_out);
+            crc = crc32(crc, reinterpret_cast<const Bytef *>(buffer.constData()), uInt(have));
+            if (out.write(buffer.constData(), have) != have) {
+                inflateEnd(&strm);
+                setError("无法写入文件: " + filePath);
+                return false;
+            }
+            written += quint64(have);
+        }
+        inflateEnd(&strm);
+    }
+
+    if (written != entry.uncompressedSize || crc != entry.crc) {
+        setError("文件校验失败: " + entry.name);
+        return false;
+    }
+    return true;
+}
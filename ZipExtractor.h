@@ -0,0 +1,45 @@
+#ifndef ZIPEXTRACTOR_H
+#define ZIPEXTRACTOR_H
+
+/**
+ * @file ZipExtractor.h
+ * @author Asteri5m
+ * @date 2026-10-17 02:31:15
+ * @brief 更新包解压：按中央目录定位条目，内存映射读取，各条目在线程池中直接解压到目标文件
+ */
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+
+class ZipExtractor
+{
+public:
+    explicit ZipExtractor(const QString &zipFile);
+
+    // 解压全部条目到 targetDir，任一条目失败返回 false，已写出的文件保留
+    bool extractAll(const QString &targetDir);
+    QString errorString() const;
+
+private:
+    struct Entry {
+        QString name;
+        quint16 flags;
+        quint16 method;
+        quint32 crc;
+        quint64 compressedSize;
+        quint64 uncompressedSize;
+        quint64 localHeaderOffset;
+    };
+
+    bool readCentralDirectory(const uchar *data, qint64 size);
+    bool extractEntry(const uchar *data, qint64 size, const Entry &entry, const QString &filePath);
+    void setError(const QString &error);
+
+    QString mZipFile;
+    QList<Entry> mEntries;
+    mutable QMutex mErrorMutex;
+    QString mError;
+};
+
+#endif // ZIPEXTRACTOR_H
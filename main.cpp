@@ -4,32 +4,77 @@
 #include "UAC.h"
 #include "Settings.h"
 #include "Custom.h"
+#include "Trace.h"
 #include <QProcess>
 
+// 旧进程退出的最长等待时间
+static const DWORD PARENT_EXIT_TIMEOUT_MS = 30000;
+
+// 由旧进程启动的实例（-update=<pid>、-clear=<pid>）要先等旧进程退出：
+// 旧进程退出前仍持有单实例锁，以及待覆盖、待删除的文件。返回 false 表示等待超时
+static bool waitForParentExit(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const QByteArray arg(argv[i]);
+        if (!arg.startsWith("-update=") && !arg.startsWith("-clear="))
+            continue;
+
+        DWORD pid = DWORD(arg.mid(arg.indexOf('=') + 1).toULong());
+        HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+        if (process == NULL) {
+            // 进程已经退出；没有权限等待时退回固定的等待时间
+            if (GetLastError() == ERROR_ACCESS_DENIED)
+                Sleep(1000);
+            return true;
+        }
+        bool exited = WaitForSingleObject(process, PARENT_EXIT_TIMEOUT_MS) == WAIT_OBJECT_0;
+        CloseHandle(process);
+        return exited;
+    }
+    return true;
+}
+
+static bool hasOption(const QStringList &args, const QString &option)
+{
+    for (const QString &arg : args)
+    {
+        if (arg == option || arg.startsWith(option + "="))
+            return true;
+    }
+    return false;
+}
+
 
 int main(int argc, char *argv[])
 {
     try {
         // 设置全局日志，初始为debug，直到加载到设置内容后修改
         qInstallMessageHandler(LogHandler::messageHandler);
+        // 日志由后台线程批量写入，致命错误仍同步写入
+        LogHandler::instance().setAsync(true);
         // 设置全局未处理异常过滤器
         SetUnhandledExceptionFilter(LogHandler::UnhandledExceptionFilter);
 
+        // 必须在创建 SingleApplication 之前等待，否则会把即将退出的旧进程当作正在运行的实例
+        bool parentExited = waitForParentExit(argc, argv);
         SingleApplication a(argc, argv, "LazyDogTools-SingleApplication");
+        if (!parentExited)
+            qWarning() << "旧进程未在" << PARENT_EXIT_TIMEOUT_MS << "毫秒内退出";
 
         // 检查启动参数
         QStringList args = QApplication::arguments();
         bool isStartup = args.contains("-startup");
-        bool isUpdate = args.contains("-update");
-        bool isClear = args.contains("-clear");
+        bool isUpdate = hasOption(args, "-update");
+        bool isClear = hasOption(args, "-clear");
+        // 从启动开始记录性能追踪，退出时导出
+        if (args.contains("-trace"))
+            Trace::setEnabled(true);
 
         if (isStartup) return UAC::setApplicationStartup(true, true) ? 0 : 1;
         if (isUpdate) return Settings::updateApp() ? 0 : 1;
         if (isClear)
-        {
             Settings::clearUpdate();
-            Sleep(1000); // 等待更新进程结束
-        }
 
         if (a.isRunning())
         {
@@ -37,6 +82,9 @@ int main(int argc, char *argv[])
             return 0;
         }
 
+        if (!isClear)
+            Settings::clearUpdateLeftovers();
+
         { // 限制作用域
             Settings s;
             // 检查是否需要管理员权限启动
@@ -56,7 +104,10 @@ int main(int argc, char *argv[])
         LazyDogTools w;
         QObject::connect(&a, SIGNAL(signalMessageAvailable(QString)), &w, SLOT(onMessageAvailable(QString)));
         QApplication::setQuitOnLastWindowClosed(false);
-        return a.exec();
+        int code = a.exec();
+        if (Trace::isEnabled())
+            Trace::dump(Trace::defaultFileName());
+        return code;
     }
     catch (const std::exception& e) {
         qCritical() << "捕获到异常:" << e.what();
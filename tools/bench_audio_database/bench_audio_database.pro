@@ -0,0 +1,21 @@
+QT = core sql
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 与主程序共用同一份数据库代码，只依赖 QtCore 与 QtSql
+INCLUDEPATH += ../.. ../../AudioHelper
+
+SOURCES += \
+    main.cpp \
+    ../../AudioHelper/AudioDatabase.cpp \
+    ../../ConfigStore.cpp \
+    ../../Storage.cpp \
+    ../../Metrics.cpp
+
+HEADERS += \
+    ../../AudioHelper/AudioDatabase.h \
+    ../../AudioHelper/AudioTypes.h \
+    ../../ConfigStore.h \
+    ../../Storage.h \
+    ../../Metrics.h
@@ -0,0 +1,121 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 16:20:05
+ * @brief bench_audio_database：在临时目录中建库，统计批量导入规则与批量切换设备的耗时
+ *
+ * 用法：bench_audio_database [--rules 10000] [--rounds 3]
+ * 每轮先用 insertItems 在一个事务中导入全部规则，再用 updateItems 把所有规则改到另一个设备，
+ * 最后按设备查询核对行数。Storage 使用相对路径 data/，程序启动后先切换到临时目录，不会碰到真实数据。
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include "AudioDatabase.h"
+
+static RelatedList makeRules(int count)
+{
+    static const QStringList types = {"进程", "窗口", "文件夹", "文件"};
+    static const QStringList tags = {QString(), "游戏", "影音"};
+
+    RelatedList rules;
+    rules.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        RelatedItem item;
+        item.id = 0;
+        item.taskInfo.name = QString("task%1.exe").arg(i);
+        item.taskInfo.path = QString("C:/Program Files/Vendor%1/task%2.exe").arg(i % 97).arg(i);
+        item.taskInfo.survivalTime = 0;
+        item.typeInfo.type = types.at(i % types.size());
+        item.typeInfo.tag = tags.at(i % tags.size());
+        item.audioDeviceInfo.name = "Speakers";
+        item.audioDeviceInfo.id = "{0.0.0.00000000}.{speakers}";
+        rules.append(item);
+    }
+    return rules;
+}
+
+static QString rate(int rows, qint64 nsecs)
+{
+    return QString::number(nsecs > 0 ? rows * 1e9 / nsecs : 0, 'f', 0);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Time bulk rule import and device remap through AudioDatabase.");
+    parser.addHelpOption();
+    QCommandLineOption rulesOption("rules", "Rules imported per round.", "count", "10000");
+    QCommandLineOption roundsOption("rounds", "Import/remap rounds.", "count", "3");
+    parser.addOption(rulesOption);
+    parser.addOption(roundsOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const int ruleCount = qMax(1, parser.value(rulesOption).toInt());
+    const int rounds = qMax(1, parser.value(roundsOption).toInt());
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid() || !QDir::setCurrent(workDir.path())) {
+        err << "Could not create a temporary working directory" << Qt::endl;
+        return 1;
+    }
+
+    AudioDatabase database;
+    out << "rules/round:      " << ruleCount << Qt::endl;
+
+    for (int round = 1; round <= rounds; ++round)
+    {
+        RelatedList rules = makeRules(ruleCount);
+        QElapsedTimer timer;
+
+        timer.start();
+        bool imported = database.insertItems(&rules);
+        qint64 importNsecs = timer.nsecsElapsed();
+        if (!imported || rules.first().id == 0 || rules.last().id == 0) {
+            err << "Import failed: " << database.lastError() << Qt::endl;
+            return 1;
+        }
+
+        // 每轮换到一个新设备，按设备查询即可核对本轮的行数
+        const QString deviceId = QString("{0.0.0.00000000}.{headphones-%1}").arg(round);
+        for (RelatedItem &item : rules) {
+            item.audioDeviceInfo.name = "Headphones";
+            item.audioDeviceInfo.id = deviceId;
+        }
+
+        timer.restart();
+        bool remapped = database.updateItems(rules);
+        qint64 remapNsecs = timer.nsecsElapsed();
+        if (!remapped) {
+            err << "Remap failed: " << database.lastError() << Qt::endl;
+            return 1;
+        }
+
+        timer.restart();
+        RelatedList result;
+        database.queryItems("deviceId", deviceId, &result);
+        qint64 queryNsecs = timer.nsecsElapsed();
+        if (result.size() != rules.size()) {
+            err << "Remap lost rows: " << result.size() << "/" << rules.size() << Qt::endl;
+            return 1;
+        }
+
+        out << "round " << round << Qt::endl;
+        out << "  import:         " << QString::number(importNsecs / 1e6, 'f', 1) << " ms ("
+            << rate(ruleCount, importNsecs) << " rows/s)" << Qt::endl;
+        out << "  remap:          " << QString::number(remapNsecs / 1e6, 'f', 1) << " ms ("
+            << rate(ruleCount, remapNsecs) << " rows/s)" << Qt::endl;
+        out << "  query device:   " << QString::number(queryNsecs / 1e6, 'f', 1) << " ms" << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,22 @@
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 与主程序共用同一份评分代码；追踪编译为空，避免引入 Trace.cpp 的 Windows 依赖
+DEFINES += LAZYDOG_NO_TRACE
+
+INCLUDEPATH += ../.. ../../AudioHelper ../common
+
+SOURCES += \
+    main.cpp \
+    ../../AudioHelper/RuleIndex.cpp \
+    ../../AudioHelper/WeightEngine.cpp \
+    ../../Metrics.cpp
+
+HEADERS += \
+    ../common/AllocationCounter.h \
+    ../../AudioHelper/AudioTypes.h \
+    ../../AudioHelper/RuleIndex.h \
+    ../../AudioHelper/WeightEngine.h \
+    ../../Metrics.h
@@ -0,0 +1,321 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 10:36:52
+ * @brief bench_audio_engine：脱离桌面环境，把进程/窗口快照与规则集回放给 scoreTasks，统计吞吐、延迟与分配次数
+ *
+ * 用法：bench_audio_engine [--rules 1000] [--processes 500] [--windows 20] [--ticks 10000] [--churn 5] [--hold 4] [--seed 1]
+ *       bench_audio_engine --replay snapshots.json [--ticks 10000] [--hold 4]
+ *
+ * 录制文件格式：
+ *     {"rules": [{"id": 1, "path": "C:/Games/game.exe", "type": "应用程序", "tag": "游戏", "device": "id"}],
+ *      "snapshots": [{"now": 0, "windows": ["C:/..."], "processes": [{"pid": 4, "path": "C:/...", "start": 0}]}]}
+ * 快照按顺序循环回放，每个快照连续评分 --hold 轮，对应服务在任务不变时的重复评分；
+ * 相邻快照之间按 pid 比对，保留未变化进程的路径句柄，与服务的增量模式一致。
+ */
+
+#include "AllocationCounter.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <algorithm>
+#include "WeightEngine.h"
+
+struct ProcessEntry {
+    quintptr pid;
+    QString path;
+    qint64 start;
+};
+
+struct Snapshot {
+    qint64 now;
+    QStringList windows;
+    QList<ProcessEntry> processes;
+};
+
+struct Workload {
+    RelatedList rules;
+    QList<Snapshot> snapshots;
+};
+
+static const QStringList PATH_PARTS = {"Steam", "steamapps", "common", "Game", "bin", "x64",
+                                       "Tools", "Launcher", "app", "Epic", "Music", "Video"};
+
+static QString randomPath(QRandomGenerator *random)
+{
+    QString path = random->bounded(2) == 0 ? "C:/Program Files" : "D:/Games";
+    int depth = 1 + random->bounded(4);
+    for (int i = 0; i < depth; ++i)
+        path += "/" + PATH_PARTS.at(random->bounded(int(PATH_PARTS.size())));
+    return path;
+}
+
+// 合成负载：规则一半是目录一半是程序；进程路径取自有限的池，每轮有 churn 个进程退出并被新进程替换
+static Workload syntheticWorkload(int ruleCount, int processCount, int windowCount, int churn, int snapshotCount, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    Workload workload;
+
+    QStringList dirs;
+    for (int i = 0; i < qMax(16, ruleCount / 4); ++i)
+        dirs.append(randomPath(&random));
+
+    for (int i = 0; i < ruleCount; ++i)
+    {
+        RelatedItem item;
+        item.id = uint(i + 1);
+        bool isDir = i % 2 == 0;
+        QString dir = dirs.at(random.bounded(int(dirs.size())));
+        item.taskInfo = {QString("game%1.exe").arg(i), isDir ? dir : QString("%1/game%2.exe").arg(dir).arg(i), 0};
+        item.typeInfo = {isDir ? "文件夹" : "应用程序", i % 3 == 0 ? "游戏" : "影音"};
+        item.audioDeviceInfo = {QString("Device %1").arg(i % 4), QString("device%1").arg(i % 4)};
+        workload.rules.append(item);
+    }
+
+    // 池中路径是规则数量的两倍，既有命中规则的，也有不相关的
+    QStringList pool;
+    for (int i = 0; i < qMax(64, ruleCount * 2); ++i)
+        pool.append(QString("%1/game%2.exe").arg(dirs.at(random.bounded(int(dirs.size())))).arg(random.bounded(qMax(1, ruleCount))));
+
+    Snapshot snapshot;
+    snapshot.now = 0;
+    quintptr nextPid = 4;
+    for (int i = 0; i < processCount; ++i)
+        snapshot.processes.append({nextPid++, pool.at(random.bounded(int(pool.size()))), 0});
+
+    for (int tick = 0; tick < snapshotCount; ++tick)
+    {
+        snapshot.now = qint64(tick) * 500;
+        for (int i = 0; i < churn && !snapshot.processes.isEmpty(); ++i)
+        {
+            int index = random.bounded(int(snapshot.processes.size()));
+            snapshot.processes[index] = {nextPid++, pool.at(random.bounded(int(pool.size()))), snapshot.now};
+        }
+
+        snapshot.windows.clear();
+        for (int i = 0; i < windowCount && i < snapshot.processes.size(); ++i)
+            snapshot.windows.append(snapshot.processes.at(snapshot.processes.size() - 1 - i).path);
+
+        workload.snapshots.append(snapshot);
+    }
+    return workload;
+}
+
+static bool loadWorkload(const QString &fileName, Workload *workload, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        *error = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (document.isNull())
+    {
+        *error = parseError.errorString();
+        return false;
+    }
+
+    const QJsonObject root = document.object();
+    for (const QJsonValue &value : root.value("rules").toArray())
+    {
+        QJsonObject object = value.toObject();
+        RelatedItem item;
+        item.id = uint(object.value("id").toInt());
+        QString path = object.value("path").toString();
+        item.taskInfo = {path.section('/', -1), path, 0};
+        item.typeInfo = {object.value("type").toString(), object.value("tag").toString()};
+        QString device = object.value("device").toString();
+        item.audioDeviceInfo = {device, device};
+        workload->rules.append(item);
+    }
+
+    for (const QJsonValue &value : root.value("snapshots").toArray())
+    {
+        QJsonObject object = value.toObject();
+        Snapshot snapshot;
+        snapshot.now = qint64(object.value("now").toDouble());
+        for (const QJsonValue &window : object.value("windows").toArray())
+            snapshot.windows.append(window.toString());
+        for (const QJsonValue &process : object.value("processes").toArray())
+        {
+            QJsonObject entry = process.toObject();
+            snapshot.processes.append({quintptr(entry.value("pid").toDouble()), entry.value("path").toString(),
+                                       qint64(entry.value("start").toDouble())});
+        }
+        workload->snapshots.append(snapshot);
+    }
+
+    if (workload->snapshots.isEmpty())
+    {
+        *error = "no snapshots";
+        return false;
+    }
+    return true;
+}
+
+// 把快照应用到评分用的任务表：pid 与路径都未变化的进程保留原记录(连同路径句柄)
+static void applySnapshot(const Snapshot &snapshot, QMap<quintptr, TaskRecord> *processTasks, QList<TaskRecord> *windowTasks)
+{
+    QMap<quintptr, TaskRecord> processes;
+    for (const ProcessEntry &entry : snapshot.processes)
+    {
+        auto it = processTasks->constFind(entry.pid);
+        if (it != processTasks->constEnd() && it->taskInfo.path == entry.path)
+            processes.insert(entry.pid, *it);
+        else
+            processes.insert(entry.pid, {entry.pid, {entry.path.section('/', -1), entry.path, 0}, entry.start, PathHandle()});
+    }
+    *processTasks = processes;
+
+    QList<TaskRecord> windows;
+    for (int i = 0; i < snapshot.windows.size(); ++i)
+    {
+        const QString &path = snapshot.windows.at(i);
+        if (i < windowTasks->size() && windowTasks->at(i).taskInfo.path == path)
+            windows.append(windowTasks->at(i));
+        else
+            windows.append({quintptr(i + 1), {path.section('/', -1), path, 0}, 0, PathHandle()});
+    }
+    *windowTasks = windows;
+}
+
+static qint64 percentile(const QVector<qint64> &sorted, double quantile)
+{
+    if (sorted.isEmpty())
+        return 0;
+    int index = qBound(0, int(quantile * (sorted.size() - 1) + 0.5), int(sorted.size()) - 1);
+    return sorted.at(index);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bench_audio_engine");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replay process/window snapshots through the AudioHelper scoring code.");
+    parser.addHelpOption();
+    QCommandLineOption replayOption("replay", "Recorded snapshots and rules (JSON). Synthetic data is used when omitted.", "file");
+    QCommandLineOption rulesOption("rules", "Synthetic rule count.", "count", "1000");
+    QCommandLineOption processesOption("processes", "Synthetic process count.", "count", "500");
+    QCommandLineOption windowsOption("windows", "Synthetic window count.", "count", "20");
+    QCommandLineOption churnOption("churn", "Synthetic processes replaced per tick.", "count", "5");
+    QCommandLineOption ticksOption("ticks", "Number of scoring ticks to run.", "count", "10000");
+    QCommandLineOption warmupOption("warmup", "Ticks run before measuring.", "count", "100");
+    QCommandLineOption holdOption("hold", "Consecutive ticks scored on each snapshot before moving to the next.", "count", "4");
+    QCommandLineOption seedOption("seed", "Random seed for synthetic data.", "seed", "1");
+    parser.addOption(replayOption);
+    parser.addOption(rulesOption);
+    parser.addOption(processesOption);
+    parser.addOption(windowsOption);
+    parser.addOption(churnOption);
+    parser.addOption(ticksOption);
+    parser.addOption(warmupOption);
+    parser.addOption(holdOption);
+    parser.addOption(seedOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const int ticks = qMax(1, parser.value(ticksOption).toInt());
+    const int warmup = qMax(0, parser.value(warmupOption).toInt());
+    const int hold = qMax(1, parser.value(holdOption).toInt());
+
+    Workload workload;
+    if (parser.isSet(replayOption)) {
+        QString error;
+        if (!loadWorkload(parser.value(replayOption), &workload, &error)) {
+            err << parser.value(replayOption) << ": " << error << Qt::endl;
+            return 1;
+        }
+    } else {
+        // 合成快照的数量有限，循环回放，避免预先生成 ticks 份快照
+        workload = syntheticWorkload(parser.value(rulesOption).toInt(), parser.value(processesOption).toInt(),
+                                     parser.value(windowsOption).toInt(), parser.value(churnOption).toInt(),
+                                     qMin((ticks + warmup + hold - 1) / hold, 1000), parser.value(seedOption).toUInt());
+    }
+
+    WeightEngine engine;
+    engine.setRules(workload.rules);
+
+    IgnoreMap ignoreMap;
+    QMap<quintptr, TaskRecord> processTasks;
+    QList<TaskRecord> windowTasks;
+    ScoreOptions options{true, true, "游戏", 0, &ignoreMap};
+
+    QVector<qint64> latencies;
+    latencies.reserve(ticks);
+    quint64 allocations = 0;
+    quint64 steadyAllocations = 0;
+    int steadyTicks = 0;
+    int previousIndex = -1;
+    int picked = 0;
+    qint64 totalNsecs = 0;
+    QElapsedTimer timer;
+
+    for (int tick = 0; tick < warmup + ticks; ++tick)
+    {
+        // 快照变化不计入评分耗时，对应服务中的进程/窗口刷新
+        // 只有切换到另一个快照时任务才会变化；只有一个快照时只在第一轮应用
+        int index = (tick / hold) % workload.snapshots.size();
+        bool changed = index != previousIndex;
+        previousIndex = index;
+        const Snapshot &snapshot = workload.snapshots.at(index);
+        if (changed)
+            applySnapshot(snapshot, &processTasks, &windowTasks);
+        options.now = snapshot.now;
+
+        quint64 before = AllocationCounter::count();
+        timer.start();
+        ScoreResult result = scoreTasks(engine, options, windowTasks, processTasks);
+        qint64 nsecs = timer.nsecsElapsed();
+        quint64 allocated = AllocationCounter::count() - before;
+
+        if (tick < warmup)
+            continue;
+
+        latencies.append(nsecs);
+        totalNsecs += nsecs;
+        allocations += allocated;
+        picked += result.slot >= 0 ? 1 : 0;
+        // 快照与上一轮相同时，评分不应有任何分配
+        if (!changed)
+        {
+            steadyAllocations += allocated;
+            steadyTicks++;
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    out << "rules:            " << workload.rules.size() << Qt::endl;
+    out << "snapshots:        " << workload.snapshots.size() << Qt::endl;
+    out << "ticks:            " << ticks << " (warmup " << warmup << ", hold " << hold << ")" << Qt::endl;
+    out << "unchanged ticks:  " << steadyTicks << "/" << ticks << Qt::endl;
+    out << "ticks/s:          " << QString::number(totalNsecs > 0 ? ticks * 1e9 / totalNsecs : 0, 'f', 0) << Qt::endl;
+    out << "tick p50:         " << QString::number(percentile(latencies, 0.50) / 1000.0, 'f', 2) << " us" << Qt::endl;
+    out << "tick p99:         " << QString::number(percentile(latencies, 0.99) / 1000.0, 'f', 2) << " us" << Qt::endl;
+    out << "tick max:         " << QString::number(latencies.last() / 1000.0, 'f', 2) << " us" << Qt::endl;
+    if (AllocationCounter::available())
+        out << "allocations/tick: " << QString::number(double(allocations) / ticks, 'f', 3) << Qt::endl;
+    else
+        out << "allocations/tick: n/a (no malloc hook on this platform)" << Qt::endl;
+    out << "targets picked:   " << picked << "/" << ticks << Qt::endl;
+
+    if (steadyAllocations > 0) {
+        err << "unexpected allocations in unchanged ticks: " << steadyAllocations << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
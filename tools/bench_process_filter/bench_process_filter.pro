@@ -0,0 +1,17 @@
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 与主程序共用同一份过滤与去重代码，只依赖 QtCore
+INCLUDEPATH += ../.. ../../AudioHelper
+
+SOURCES += \
+    main.cpp \
+    ../../AudioHelper/ProcessRowSet.cpp \
+    ../../AudioHelper/RuleIndex.cpp
+
+HEADERS += \
+    ../../AudioHelper/AudioTypes.h \
+    ../../AudioHelper/ProcessRowSet.h \
+    ../../AudioHelper/RuleIndex.h
@@ -0,0 +1,239 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 16:55:32
+ * @brief bench_process_filter：把进程快照增量喂给进程列表的排除前缀过滤与去重，对比原先的线性扫描
+ *
+ * 用法：bench_process_filter [--processes 2000] [--prefixes 40] [--deltas 200] [--churn 20] [--rounds 5] [--seed 1]
+ * 每轮先喂一次包含全部进程的增量（首次加载或过滤条件变化后的重建），再依次喂入 --deltas 个
+ * 各退出/新增 --churn 个进程的增量。两种实现处理同一组增量，结果行数必须一致。
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTextStream>
+#include "ProcessRowSet.h"
+
+struct ProcessEntry {
+    quintptr pid;
+    QString path;
+};
+
+struct ProcessDelta {
+    QList<ProcessEntry> added;
+    QList<quintptr> removed;
+};
+
+struct Workload {
+    QStringList prefixes;
+    ProcessDelta full;
+    QList<ProcessDelta> deltas;
+};
+
+// 原先的实现：前缀逐个 startsWith，pid 与路径存放在按行对齐的列表中
+class LinearRows
+{
+public:
+    void clear()
+    {
+        mIds.clear();
+        mPaths.clear();
+    }
+
+    int size() const
+    {
+        return mIds.size();
+    }
+
+    bool add(quintptr pid, const QString &path, const QStringList &prefixes, bool dedup)
+    {
+        if (mIds.contains(pid))
+            return false;
+        for (const QString &prefix : prefixes)
+        {
+            if (path.startsWith(prefix))
+                return false;
+        }
+        if (dedup && mPaths.contains(path))
+            return false;
+
+        mIds.append(pid);
+        mPaths.append(path);
+        return true;
+    }
+
+    bool remove(quintptr pid)
+    {
+        qsizetype row = mIds.indexOf(pid);
+        if (row < 0)
+            return false;
+        mIds.removeAt(row);
+        mPaths.removeAt(row);
+        return true;
+    }
+
+private:
+    QList<quintptr> mIds;
+    QStringList mPaths;
+};
+
+// 约三成进程位于被排除的系统目录，其余按可执行文件成组，去重模式下同一程序只展示一次
+static QString processPath(QRandomGenerator &random)
+{
+    int kind = random.bounded(10);
+    if (kind < 3)
+        return QString("C:/Windows/System32/svc%1.exe").arg(random.bounded(300));
+    if (kind < 4)
+        return QString("C:/Program Files/Vendor%1/Updater/update.exe").arg(random.bounded(150));
+    return QString("C:/Program Files/Vendor%1/bin/app%2.exe").arg(random.bounded(150)).arg(random.bounded(4));
+}
+
+static Workload makeWorkload(int processes, int prefixes, int deltas, int churn, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    Workload workload;
+
+    workload.prefixes << "C:/Windows" << "C:/ProgramData" << "C:/Program Files/Common Files";
+    for (int i = 0; workload.prefixes.size() < prefixes; ++i)
+        workload.prefixes << QString("C:/Program Files/Vendor%1/Updater").arg(i);
+
+    // 当前存活的进程，增量中退出的进程从这里随机挑选
+    QList<quintptr> alive;
+    quintptr nextPid = 4;
+    for (int i = 0; i < processes; ++i)
+    {
+        workload.full.added.append({nextPid, processPath(random)});
+        alive.append(nextPid);
+        nextPid += 4;
+    }
+
+    for (int d = 0; d < deltas; ++d)
+    {
+        ProcessDelta delta;
+        for (int i = 0; i < churn && !alive.isEmpty(); ++i)
+            delta.removed.append(alive.takeAt(random.bounded(int(alive.size()))));
+        for (int i = 0; i < churn; ++i)
+        {
+            delta.added.append({nextPid, processPath(random)});
+            alive.append(nextPid);
+            nextPid += 4;
+        }
+        workload.deltas.append(delta);
+    }
+    return workload;
+}
+
+struct Timing {
+    qint64 fullNsecs = 0;
+    qint64 deltaNsecs = 0;
+    int rows = 0;
+};
+
+// 与 TaskMonitor::collectProcesses 的顺序一致：先移除退出的进程，再过滤新增的进程
+template<typename Rows, typename Prefixes>
+static Timing run(Rows &rows, const Prefixes &prefixes, const Workload &workload, bool dedup)
+{
+    Timing timing;
+    QElapsedTimer timer;
+
+    rows.clear();
+    timer.start();
+    for (const ProcessEntry &entry : workload.full.added)
+        rows.add(entry.pid, entry.path, prefixes, dedup);
+    timing.fullNsecs = timer.nsecsElapsed();
+
+    timer.restart();
+    for (const ProcessDelta &delta : workload.deltas)
+    {
+        for (quintptr pid : delta.removed)
+            rows.remove(pid);
+        for (const ProcessEntry &entry : delta.added)
+            rows.add(entry.pid, entry.path, prefixes, dedup);
+    }
+    timing.deltaNsecs = timer.nsecsElapsed();
+    timing.rows = rows.size();
+    return timing;
+}
+
+static QString usecs(qint64 nsecs, int count)
+{
+    return QString::number(count > 0 ? nsecs / 1000.0 / count : 0, 'f', 2);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bench_process_filter");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Time the process list exclusion-prefix filter and de-dup against the old linear scan.");
+    parser.addHelpOption();
+    QCommandLineOption processesOption("processes", "Processes in the full snapshot delta.", "count", "2000");
+    QCommandLineOption prefixesOption("prefixes", "Exclusion prefixes.", "count", "40");
+    QCommandLineOption deltasOption("deltas", "Incremental deltas after the full one.", "count", "200");
+    QCommandLineOption churnOption("churn", "Processes exiting and starting per incremental delta.", "count", "20");
+    QCommandLineOption roundsOption("rounds", "Rounds per implementation; the fastest is reported.", "count", "5");
+    QCommandLineOption seedOption("seed", "Random seed for the synthetic processes.", "seed", "1");
+    parser.addOption(processesOption);
+    parser.addOption(prefixesOption);
+    parser.addOption(deltasOption);
+    parser.addOption(churnOption);
+    parser.addOption(roundsOption);
+    parser.addOption(seedOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const int processes = qMax(1, parser.value(processesOption).toInt());
+    const int deltas = qMax(0, parser.value(deltasOption).toInt());
+    const int churn = qMax(0, parser.value(churnOption).toInt());
+    const int rounds = qMax(1, parser.value(roundsOption).toInt());
+    Workload workload = makeWorkload(processes, qMax(0, parser.value(prefixesOption).toInt()), deltas, churn,
+                                     parser.value(seedOption).toUInt());
+
+    PrefixTable table;
+    for (const QString &prefix : std::as_const(workload.prefixes))
+        table.insert(prefix, 0);
+    table.build();
+
+    out << "processes:        " << processes << Qt::endl;
+    out << "prefixes:         " << workload.prefixes.size() << Qt::endl;
+    out << "deltas:           " << deltas << " x " << churn << " exits/starts" << Qt::endl;
+
+    // 分别测量"全部"与"去重"两种过滤模式
+    for (bool dedup : {false, true})
+    {
+        Timing hashed;
+        Timing linear;
+        for (int round = 0; round < rounds; ++round)
+        {
+            ProcessRowSet rowSet;
+            LinearRows linearRows;
+            Timing a = run(rowSet, table, workload, dedup);
+            Timing b = run(linearRows, workload.prefixes, workload, dedup);
+            if (a.rows != b.rows) {
+                err << "Row count mismatch: " << a.rows << " vs " << b.rows << Qt::endl;
+                return 1;
+            }
+            if (round == 0 || a.fullNsecs < hashed.fullNsecs) hashed.fullNsecs = a.fullNsecs;
+            if (round == 0 || a.deltaNsecs < hashed.deltaNsecs) hashed.deltaNsecs = a.deltaNsecs;
+            if (round == 0 || b.fullNsecs < linear.fullNsecs) linear.fullNsecs = b.fullNsecs;
+            if (round == 0 || b.deltaNsecs < linear.deltaNsecs) linear.deltaNsecs = b.deltaNsecs;
+            hashed.rows = a.rows;
+        }
+
+        out << (dedup ? "mode clear" : "mode all") << " (" << hashed.rows << " rows shown)" << Qt::endl;
+        out << "  full delta:     hashed " << usecs(hashed.fullNsecs, 1) << " us, linear "
+            << usecs(linear.fullNsecs, 1) << " us" << Qt::endl;
+        out << "  per delta:      hashed " << usecs(hashed.deltaNsecs, deltas) << " us, linear "
+            << usecs(linear.deltaNsecs, deltas) << " us" << Qt::endl;
+        out << "  speedup:        full " << QString::number(hashed.fullNsecs > 0 ? double(linear.fullNsecs) / hashed.fullNsecs : 0, 'f', 1)
+            << "x, per delta " << QString::number(hashed.deltaNsecs > 0 ? double(linear.deltaNsecs) / hashed.deltaNsecs : 0, 'f', 1)
+            << "x" << Qt::endl;
+    }
+    return 0;
+}
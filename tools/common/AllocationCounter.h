@@ -0,0 +1,136 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+/**
+ * @file AllocationCounter.h
+ * @author Asteri5m
+ * @date 2026-10-17 09:40:12
+ * @brief 测试与基准共用的堆分配计数：替换全局 operator new，glibc 下同时拦截 malloc 系列，MSVC 调试版用 CRT 分配钩子
+ *
+ * Qt 容器的内存来自 malloc 而不是 operator new，只有拦截 malloc 才能统计到 QString/QVector 的分配；
+ * 其它平台只统计 operator new，available() 返回 false，依赖完整计数的断言应当跳过。
+ * 替换函数不是 inline 的，每个程序只能在一个源文件中包含本头文件。
+ */
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace AllocationCounter {
+
+inline std::atomic<quint64> &counter()
+{
+    static std::atomic<quint64> count(0);
+    return count;
+}
+
+inline quint64 count()
+{
+    return counter().load(std::memory_order_relaxed);
+}
+
+inline void add()
+{
+    counter().fetch_add(1, std::memory_order_relaxed);
+}
+
+// 是否能统计到 malloc 系列的分配
+inline bool available()
+{
+#if defined(__GLIBC__) || (defined(_MSC_VER) && defined(_DEBUG))
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace AllocationCounter
+
+#if defined(__GLIBC__)
+
+// 可执行文件中定义的 malloc 会覆盖共享库(包括 Qt)里的调用，再转给 glibc 的实现
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    AllocationCounter::add();
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    AllocationCounter::add();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    AllocationCounter::add();
+    return __libc_realloc(ptr, size);
+}
+
+// malloc 已经计数，operator new 只需转发
+void *operator new(size_t size)
+{
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+#elif defined(_MSC_VER) && defined(_DEBUG)
+
+#include <crtdbg.h>
+
+// 调试版 CRT 的分配钩子对共用同一 CRT 的 Qt DLL 同样生效；钩子中不能再分配内存
+static int allocationHook(int type, void *, size_t, int blockType, long, const unsigned char *, int)
+{
+    if ((type == _HOOK_ALLOC || type == _HOOK_REALLOC) && blockType != _CRT_BLOCK)
+        AllocationCounter::add();
+    return TRUE;
+}
+
+static const bool allocationHookInstalled = (_CrtSetAllocHook(allocationHook), true);
+
+// 钩子已经计数，operator new 只需转发
+void *operator new(size_t size)
+{
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+#else
+
+void *operator new(size_t size)
+{
+    AllocationCounter::add();
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+#endif
+
+// 替换后的 new/delete 都走 malloc/free，GCC 无法看出二者配对
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// 数组与 nothrow 版本的默认实现会调用上面的 operator new，只需补上对应的 delete
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,134 @@
+#ifndef FIXTURESERVER_H
+#define FIXTURESERVER_H
+
+/**
+ * @file FixtureServer.h
+ * @author Asteri5m
+ * @date 2026-10-17 18:20:37
+ * @brief 测试用的本机 HTTP 文件服务：按路径返回内存中的内容，支持 Range/If-Range、中途断开与 416，并记录收到的请求
+ */
+
+#include <QHash>
+#include <QList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrl>
+
+// 最简单的 HTTP/1.1 文件服务：每个连接只处理一个 GET 请求，应答后关闭连接
+class FixtureServer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Request {
+        QByteArray path;
+        QByteArray range;
+        QByteArray ifRange;
+    };
+
+    bool listen()
+    {
+        connect(&mServer, &QTcpServer::newConnection, this, &FixtureServer::onNewConnection);
+        return mServer.listen(QHostAddress::LocalHost);
+    }
+
+    QUrl url(const QString &path) const
+    {
+        return QUrl(QString("http://127.0.0.1:%1%2").arg(mServer.serverPort()).arg(path));
+    }
+
+    QHash<QByteArray, QByteArray> files;
+    QByteArray etag = "\"v1\"";
+    qint64 cutAfter = -1;       // 下一次应答只发送这么多字节就断开，模拟下载中断
+    bool ignoreRange = false;   // 不支持 Range，总是返回完整内容
+    bool rejectRange = false;   // 对 Range 请求返回 416
+    QList<Request> requests;
+
+private slots:
+    void onNewConnection()
+    {
+        while (QTcpSocket *socket = mServer.nextPendingConnection())
+        {
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+            connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+                mBuffers.remove(socket);
+                socket->deleteLater();
+            });
+        }
+    }
+
+private:
+    void onReadyRead(QTcpSocket *socket)
+    {
+        QByteArray &buffer = mBuffers[socket];
+        buffer += socket->readAll();
+        int end = buffer.indexOf("\r\n\r\n");
+        if (end < 0)
+            return;
+
+        const QList<QByteArray> lines = buffer.left(end).split('\n');
+        buffer.clear();
+
+        Request request;
+        request.path = lines.value(0).split(' ').value(1);
+        for (const QByteArray &line : lines.mid(1))
+        {
+            int colon = line.indexOf(':');
+            QByteArray name = line.left(colon).trimmed().toLower();
+            QByteArray value = line.mid(colon + 1).trimmed();
+            if (name == "range")
+                request.range = value;
+            else if (name == "if-range")
+                request.ifRange = value;
+        }
+        requests.append(request);
+        respond(socket, request);
+    }
+
+    void respond(QTcpSocket *socket, const Request &request)
+    {
+        if (!files.contains(request.path)) {
+            socket->write("HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\nConnection: close\r\n\r\nnot found");
+            socket->disconnectFromHost();
+            return;
+        }
+
+        const QByteArray body = files.value(request.path);
+        const QByteArray size = QByteArray::number(body.size());
+        QByteArray header = "HTTP/1.1 200 OK\r\n";
+        qint64 start = 0;
+
+        // If-Range 与当前 ETag 不符时按规范返回完整内容
+        bool partial = !request.range.isEmpty() && !ignoreRange
+                       && (request.ifRange.isEmpty() || request.ifRange == etag);
+        if (partial && rejectRange) {
+            QByteArray rejected = "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */" + size
+                                  + "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            socket->write(rejected);
+            socket->disconnectFromHost();
+            return;
+        }
+        if (partial) {
+            start = request.range.mid(6).split('-').value(0).toLongLong();
+            header = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + QByteArray::number(start) + "-"
+                     + QByteArray::number(body.size() - 1) + "/" + size + "\r\n";
+        }
+
+        header += "Content-Length: " + QByteArray::number(body.size() - start) + "\r\n";
+        header += "ETag: " + etag + "\r\nConnection: close\r\n\r\n";
+
+        QByteArray payload = body.mid(start);
+        if (cutAfter >= 0) {
+            payload.truncate(cutAfter);
+            cutAfter = -1;
+        }
+        header.append(payload);
+        socket->write(header);
+        // 等已写入的数据发完再关闭，客户端收到的内容比 Content-Length 少即视为中断
+        socket->disconnectFromHost();
+    }
+
+    QTcpServer mServer;
+    QHash<QTcpSocket *, QByteArray> mBuffers;
+};
+
+#endif // FIXTURESERVER_H
@@ -0,0 +1,128 @@
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+/**
+ * @file TestHelpers.h
+ * @author Asteri5m
+ * @date 2026-10-17 19:12:26
+ * @brief 测试共用的辅助：每个用例独立的临时目录、读取输出文件，以及等待异步操作结束
+ */
+
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <memory>
+
+namespace TestHelpers {
+
+// 异步操作的默认超时，本机操作远用不了这么久
+static const int WAIT_TIMEOUT_MSEC = 10000;
+
+// 读取文件，不存在时返回 "<missing>"，QCOMPARE 失败时能直接看出原因
+inline QByteArray readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray("<missing>");
+    return file.readAll();
+}
+
+// 每个用例一个新的临时目录：init() 中 reset()，cleanup() 中 clear()
+class TestDir
+{
+public:
+    bool reset()
+    {
+        mDir.reset(new QTemporaryDir);
+        return mDir->isValid();
+    }
+
+    void clear()
+    {
+        mDir.reset();
+    }
+
+    QString filePath(const QString &name) const
+    {
+        return mDir->filePath(name);
+    }
+
+    QByteArray read(const QString &name) const
+    {
+        return readFile(filePath(name));
+    }
+
+private:
+    std::unique_ptr<QTemporaryDir> mDir;
+};
+
+// 异步操作的结果：成功信号置 ok，失败信号或超时记录错误
+struct AsyncResult {
+    bool ok = false;
+    QString error;
+};
+
+// 在事件循环中等待成功或失败信号之一；信号在 wait() 之前同步发出时也不会漏掉
+class SignalWaiter
+{
+public:
+    explicit SignalWaiter(AsyncResult *result)
+        : mResult(result)
+        , mDone(false)
+    {
+    }
+
+    template<typename Signal>
+    void succeedOn(const typename QtPrivate::FunctionPointer<Signal>::Object *sender, Signal signal)
+    {
+        QObject::connect(sender, signal, &mLoop, [this]() {
+            mResult->ok = true;
+            finish();
+        });
+    }
+
+    // 失败信号的第一个参数为错误文本
+    template<typename Signal>
+    void failOn(const typename QtPrivate::FunctionPointer<Signal>::Object *sender, Signal signal)
+    {
+        QObject::connect(sender, signal, &mLoop, [this](const QString &error) {
+            mResult->error = error;
+            finish();
+        });
+    }
+
+    // 超时返回 false，错误记为 "timeout"
+    bool wait(int msec = WAIT_TIMEOUT_MSEC)
+    {
+        if (mDone)
+            return true;
+
+        QTimer timer;
+        timer.setSingleShot(true);
+        QObject::connect(&timer, &QTimer::timeout, &mLoop, &QEventLoop::quit);
+        timer.start(msec);
+        mLoop.exec();
+        if (mDone)
+            return true;
+
+        mResult->error = "timeout";
+        return false;
+    }
+
+private:
+    void finish()
+    {
+        mDone = true;
+        mLoop.quit();
+    }
+
+    AsyncResult *mResult;
+    bool mDone;
+    QEventLoop mLoop;
+};
+
+} // namespace TestHelpers
+
+#endif // TESTHELPERS_H
@@ -0,0 +1,16 @@
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 与主程序共用二进制日志的编解码
+INCLUDEPATH += ../..
+
+# 解压归档后的 .gz 分段
+include(../../zlib.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../BinaryLog.h
@@ -0,0 +1,169 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-16 21:48:06
+ * @brief logdump：把二进制日志转换为文本，可按级别、标签和时间范围过滤
+ *
+ * 用法：logdump [-l warn] [-t AudioHelperServer] [--from "2026-10-16 08:00:00"] [--to ...] log.bin log_20261016_1.bin.gz ...
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <limits>
+#include <zlib.h>
+#include "BinaryLog.h"
+
+static int parseLevel(const QString &name)
+{
+    static const QStringList names = {"debug", "info", "warn", "error", "fatal"};
+    return names.indexOf(name.toLower());
+}
+
+static bool parseTime(const QString &text, qint64 *time)
+{
+    QDateTime dateTime = QDateTime::fromString(text, "yyyy-MM-dd hh:mm:ss");
+    if (!dateTime.isValid())
+        dateTime = QDateTime::fromString(text, "yyyy-MM-dd");
+    if (!dateTime.isValid())
+        return false;
+    *time = dateTime.toMSecsSinceEpoch();
+    return true;
+}
+
+// 归档后的分段是 gzip 压缩的，先整体解压到内存
+static bool gunzip(QFile *file, QByteArray *data)
+{
+    QByteArray input = file->readAll();
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.avail_in = uInt(input.size());
+    strm.next_in = reinterpret_cast<Bytef *>(input.data());
+    if (inflateInit2(&strm, MAX_WBITS + 16) != Z_OK)
+        return false;
+
+    char out[64 * 1024];
+    int ret;
+    do {
+        strm.avail_out = sizeof(out);
+        strm.next_out = reinterpret_cast<Bytef *>(out);
+        ret = inflate(&strm, Z_NO_FLUSH);
+        if (ret != Z_OK && ret != Z_STREAM_END)
+            break;
+        data->append(out, sizeof(out) - strm.avail_out);
+    } while (ret != Z_STREAM_END);
+
+    inflateEnd(&strm);
+    return ret == Z_STREAM_END;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("logdump");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Convert LazyDogTools binary logs to text.");
+    parser.addHelpOption();
+    QCommandLineOption levelOption({"l", "level"}, "Minimum level: debug, info, warn, error, fatal.", "level", "debug");
+    QCommandLineOption tagOption({"t", "tag"}, "Only records whose tag contains this text; may be repeated.", "tag");
+    QCommandLineOption fromOption("from", "Start time, \"yyyy-MM-dd hh:mm:ss\" or \"yyyy-MM-dd\".", "time");
+    QCommandLineOption toOption("to", "End time (exclusive), same format as --from.", "time");
+    parser.addOption(levelOption);
+    parser.addOption(tagOption);
+    parser.addOption(fromOption);
+    parser.addOption(toOption);
+    parser.addPositionalArgument("files", "Binary log files (log.bin, log_yyyyMMdd_N.bin.gz).", "files...");
+    parser.process(app);
+
+    QTextStream err(stderr);
+    int minLevel = parseLevel(parser.value(levelOption));
+    if (minLevel < 0) {
+        err << "Unknown level: " << parser.value(levelOption) << Qt::endl;
+        return 2;
+    }
+
+    qint64 from = std::numeric_limits<qint64>::min();
+    qint64 to = std::numeric_limits<qint64>::max();
+    if ((parser.isSet(fromOption) && !parseTime(parser.value(fromOption), &from))
+        || (parser.isSet(toOption) && !parseTime(parser.value(toOption), &to))) {
+        err << "Invalid time, expected \"yyyy-MM-dd hh:mm:ss\"" << Qt::endl;
+        return 2;
+    }
+
+    const QStringList tags = parser.values(tagOption);
+    const QStringList files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        parser.showHelp(2);
+    }
+
+    QFile out;
+    out.open(stdout, QIODevice::WriteOnly);
+
+    int result = 0;
+    for (const QString &fileName : files)
+    {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            err << fileName << ": " << file.errorString() << Qt::endl;
+            result = 1;
+            continue;
+        }
+        if (file.size() == 0)
+            continue;
+
+        QByteArray inflated;
+        const uchar *data;
+        qint64 size;
+        if (fileName.endsWith(".gz")) {
+            if (!gunzip(&file, &inflated)) {
+                err << fileName << ": corrupt gzip data" << Qt::endl;
+                result = 1;
+                continue;
+            }
+            data = reinterpret_cast<const uchar *>(inflated.constData());
+            size = inflated.size();
+        } else {
+            // 直接映射整个文件，解码时不再额外拷贝
+            data = file.map(0, file.size());
+            size = file.size();
+            if (data == nullptr) {
+                err << fileName << ": " << file.errorString() << Qt::endl;
+                result = 1;
+                continue;
+            }
+        }
+
+        BinaryLogDecoder decoder(data, size);
+        if (!decoder.isValid()) {
+            err << fileName << ": not a binary log" << Qt::endl;
+            result = 1;
+            continue;
+        }
+
+        BinaryLogDecoder::Entry entry;
+        while (decoder.next(&entry))
+        {
+            if (logSeverity(entry.type) < minLevel || entry.time < from || entry.time >= to)
+                continue;
+
+            if (!tags.isEmpty()) {
+                bool matched = false;
+                for (const QString &tag : tags)
+                    matched = matched || entry.tag.contains(tag, Qt::CaseInsensitive);
+                if (!matched)
+                    continue;
+            }
+
+            out.write(formatLogLine(entry.type, entry.time, entry.tag, entry.msg).toUtf8());
+        }
+
+        if (decoder.truncated())
+            err << fileName << ": stopped at an incomplete or corrupt record" << Qt::endl;
+    }
+
+    return result;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 15:02:18
+ * @brief AudioBackend 的测试：假后端注入后，设备列表与默认设备的缓存只在变化通知后重新枚举
+ */
+
+#include <QtTest>
+#include "AudioBackend.h"
+#include "AudioManager.h"
+
+// 测试中没有平台实现，所有用例都会先注入假后端
+AudioBackend *AudioBackend::createPlatformBackend()
+{
+    return new FakeAudioBackend;
+}
+
+static AudioDeviceList makeDevices(const QStringList &names)
+{
+    AudioDeviceList devices;
+    for (const QString &name : names)
+        devices.insert(name, "id-" + name);
+    return devices;
+}
+
+class TestAudioBackend : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void injectedInstance();
+    void devicesCachedUntilNotified();
+    void defaultDeviceCachedUntilNotified();
+    void switchUpdatesCache();
+};
+
+void TestAudioBackend::cleanup()
+{
+    AudioBackend::setInstance(nullptr);
+}
+
+void TestAudioBackend::injectedInstance()
+{
+    FakeAudioBackend firstBackend;
+    FakeAudioBackend secondBackend;
+    AudioBackend *first = &firstBackend;
+    AudioBackend *second = &secondBackend;
+
+    AudioBackend::setInstance(first);
+    QCOMPARE(AudioBackend::instance(), first);
+    AudioBackend::setInstance(second);
+    QCOMPARE(AudioBackend::instance(), second);
+
+    // 恢复后使用平台默认实现
+    AudioBackend::setInstance(nullptr);
+    AudioBackend *platform = AudioBackend::instance();
+    QVERIFY(platform != nullptr);
+    QVERIFY(platform != first && platform != second);
+    QCOMPARE(AudioBackend::instance(), platform);
+}
+
+void TestAudioBackend::devicesCachedUntilNotified()
+{
+    FakeAudioBackend backend(makeDevices({"speaker", "headset"}));
+    AudioBackend::setInstance(&backend);
+    QSignalSpy spy(&backend, &AudioBackend::devicesChanged);
+
+    // 反复查询，包括通过 AudioManager 的包装，只枚举一次
+    AudioDeviceList devices;
+    for (int i = 0; i < 5; ++i)
+    {
+        AudioManager::getAudioOutDeviceList(&devices);
+        QCOMPARE(devices, makeDevices({"speaker", "headset"}));
+    }
+    QCOMPARE(backend.outputDevices(), makeDevices({"speaker", "headset"}));
+    QCOMPARE(backend.enumerateCount(), 1);
+
+    // 设备插拔的通知使缓存失效，下一次查询重新枚举，之后再次命中缓存
+    backend.setDevices(makeDevices({"speaker", "headset", "hdmi"}));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(backend.enumerateCount(), 1);
+    for (int i = 0; i < 5; ++i)
+    {
+        AudioManager::getAudioOutDeviceList(&devices);
+        QCOMPARE(devices, makeDevices({"speaker", "headset", "hdmi"}));
+    }
+    QCOMPARE(backend.enumerateCount(), 2);
+
+    // 没有通知时，后端设备的变化不可见
+    backend.invalidateDevices();
+    backend.invalidateDevices();
+    QCOMPARE(spy.count(), 3);
+    AudioManager::getAudioOutDeviceList(&devices);
+    AudioManager::getAudioOutDeviceList(&devices);
+    QCOMPARE(backend.enumerateCount(), 3);
+}
+
+void TestAudioBackend::defaultDeviceCachedUntilNotified()
+{
+    FakeAudioBackend backend(makeDevices({"headset", "speaker"}));
+    AudioBackend::setInstance(&backend);
+    QSignalSpy spy(&backend, &AudioBackend::defaultDeviceChanged);
+    AudioManager manager;
+
+    for (int i = 0; i < 5; ++i)
+        QCOMPARE(manager.getCurrentAudioOutDevice(), QString("id-headset"));
+    QCOMPARE(backend.queryCount(), 1);
+
+    // 系统侧修改默认设备，通知直接携带新的设备，无需重新查询
+    backend.setSystemDefault("id-speaker");
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("id-speaker"));
+    QCOMPARE(manager.getCurrentAudioOutDevice(), QString("id-speaker"));
+    QCOMPARE(AudioManager::getDefaultAudioOutDevice(), QString("id-speaker"));
+    QCOMPARE(backend.queryCount(), 1);
+
+    // 没有默认设备时每次都会重新查询，AudioManager 以"0"表示
+    backend.setSystemDefault(QString());
+    QCOMPARE(manager.getCurrentAudioOutDevice(), QString("0"));
+    QCOMPARE(manager.getCurrentAudioOutDevice(), QString("0"));
+    QCOMPARE(backend.queryCount(), 3);
+}
+
+void TestAudioBackend::switchUpdatesCache()
+{
+    FakeAudioBackend backend(makeDevices({"headset", "speaker"}));
+    AudioBackend::setInstance(&backend);
+    AudioManager manager;
+
+    QCOMPARE(manager.getCurrentAudioOutDevice(), QString("id-headset"));
+    QVERIFY(manager.setAudioOutDevice("id-speaker"));
+    QCOMPARE(backend.appliedDevices(), QStringList({"id-speaker"}));
+    QCOMPARE(manager.getCurrentAudioOutDevice(), QString("id-speaker"));
+    QCOMPARE(backend.queryCount(), 1);
+
+    // 切换失败时缓存保持原来的设备
+    QVERIFY(!manager.setAudioOutDevice("id-unknown"));
+    backend.setFailing(true);
+    QVERIFY(!manager.setAudioOutDevice("id-headset"));
+    QCOMPARE(manager.getCurrentAudioOutDevice(), QString("id-speaker"));
+    QCOMPARE(backend.appliedDevices(), QStringList({"id-speaker"}));
+    QCOMPARE(backend.queryCount(), 1);
+}
+
+QTEST_APPLESS_MAIN(TestAudioBackend)
+#include "main.moc"
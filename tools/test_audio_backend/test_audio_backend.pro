@@ -0,0 +1,18 @@
+QT = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 只编译后端基类、假后端与 AudioManager；追踪在测试中编译为空，避免引入 Trace.cpp 的 Windows 依赖
+DEFINES += LAZYDOG_NO_TRACE
+
+INCLUDEPATH += ../.. ../../AudioHelper
+
+SOURCES += \
+    main.cpp \
+    ../../AudioHelper/AudioBackend.cpp \
+    ../../AudioHelper/AudioManager.cpp
+
+HEADERS += \
+    ../../AudioHelper/AudioBackend.h \
+    ../../AudioHelper/AudioManager.h
@@ -0,0 +1,269 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 18:34:52
+ * @brief 增量更新的测试：本机 HTTP 服务提供清单与新版本文件，以更新前后的目录树核对比对、下载、替换、还原与清理
+ */
+
+#include <QtTest>
+#include <QDirIterator>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+#include <memory>
+#include "FixtureServer.h"
+#include "TestHelpers.h"
+#include "DeltaUpdater.h"
+
+typedef QMap<QString, QByteArray> FileTree;
+
+// 与程序一致，暂存目录位于安装目录下
+static const QString STAGE_DIR = "update";
+
+static FileTree beforeTree()
+{
+    return {
+        {"LazyDogTools.exe", "exe v1"},
+        {"Qt6Core.dll", "qt core"},
+        {"plugins/audio.dll", "audio v1"},
+        {"readme.txt", "not in manifest"},
+    };
+}
+
+// 清单中的文件：exe 与 audio.dll 大小不变、内容变化，Qt6Core.dll 不变，zh_CN.qm 为新增
+static FileTree releaseTree()
+{
+    return {
+        {"LazyDogTools.exe", "exe v2"},
+        {"Qt6Core.dll", "qt core"},
+        {"plugins/audio.dll", "audio v2"},
+        {"translations/zh_CN.qm", "translations"},
+    };
+}
+
+static QByteArray sha256Hex(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex();
+}
+
+static void writeTree(const QString &root, const FileTree &tree)
+{
+    QDir dir(root);
+    for (auto it = tree.cbegin(); it != tree.cend(); ++it)
+    {
+        const QString filePath = dir.filePath(it.key());
+        QDir().mkpath(QFileInfo(filePath).path());
+        QFile file(filePath);
+        if (file.open(QIODevice::WriteOnly))
+            file.write(it.value());
+    }
+}
+
+// 读取安装目录，不含暂存目录
+static FileTree readTree(const QString &root)
+{
+    FileTree tree;
+    QDir dir(root);
+    QDirIterator it(root, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        const QString path = dir.relativeFilePath(it.next());
+        if (path.startsWith(STAGE_DIR + "/"))
+            continue;
+        QFile file(it.filePath());
+        if (file.open(QIODevice::ReadOnly))
+            tree.insert(path, file.readAll());
+    }
+    return tree;
+}
+
+class TestDeltaUpdater : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void downloadChanged();
+    void reuseStaged();
+    void nothingChanged();
+    void checksumMismatch();
+    void applyAndCleanup();
+    void applyRollback();
+
+private:
+    struct Result : TestHelpers::AsyncResult {
+        int changedFiles = -1;
+    };
+
+    Result run();
+    QString installDir() const { return mDir.filePath("app"); }
+    QString stageDir() const { return QDir(installDir()).filePath(STAGE_DIR); }
+    QStringList requestedPaths() const;
+
+    TestHelpers::TestDir mDir;
+    std::unique_ptr<FixtureServer> mServer;
+    std::unique_ptr<QNetworkAccessManager> mManager;
+};
+
+void TestDeltaUpdater::init()
+{
+    QVERIFY(mDir.reset());
+    writeTree(installDir(), beforeTree());
+
+    // 清单中 exe 使用相对地址，其余省略 url，均相对清单地址解析
+    mServer.reset(new FixtureServer);
+    QJsonArray files;
+    const FileTree release = releaseTree();
+    for (auto it = release.cbegin(); it != release.cend(); ++it)
+    {
+        QJsonObject entry{{"path", it.key()},
+                          {"size", qint64(it.value().size())},
+                          {"sha256", QString::fromLatin1(sha256Hex(it.value()))}};
+        QString served = "/release/" + it.key();
+        if (it.key() == "LazyDogTools.exe") {
+            entry.insert("url", "files/LazyDogTools.exe");
+            served = "/release/files/LazyDogTools.exe";
+        }
+        files.append(entry);
+        mServer->files.insert(served.toUtf8(), it.value());
+    }
+    QJsonObject manifest{{"version", "0.0.4"}, {"files", files}};
+    mServer->files.insert("/release/manifest.json", QJsonDocument(manifest).toJson());
+    QVERIFY(mServer->listen());
+
+    mManager.reset(new QNetworkAccessManager);
+    mManager->setProxy(QNetworkProxy::NoProxy);
+}
+
+void TestDeltaUpdater::cleanup()
+{
+    mManager.reset();
+    mServer.reset();
+    mDir.clear();
+}
+
+TestDeltaUpdater::Result TestDeltaUpdater::run()
+{
+    Result result;
+    DeltaUpdater updater(mManager.get(), installDir(), stageDir());
+    connect(&updater, &DeltaUpdater::finished, this, [&result](int changedFiles) {
+        result.changedFiles = changedFiles;
+    });
+    TestHelpers::SignalWaiter waiter(&result);
+    waiter.succeedOn(&updater, &DeltaUpdater::finished);
+    waiter.failOn(&updater, &DeltaUpdater::failed);
+
+    updater.start(mServer->url("/release/manifest.json"));
+    waiter.wait();
+    return result;
+}
+
+QStringList TestDeltaUpdater::requestedPaths() const
+{
+    QStringList paths;
+    for (const FixtureServer::Request &request : std::as_const(mServer->requests))
+        paths.append(QString::fromUtf8(request.path));
+    return paths;
+}
+
+void TestDeltaUpdater::downloadChanged()
+{
+    Result result = run();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.changedFiles, 3);
+
+    // 不变的 Qt6Core.dll 不下载
+    QStringList requested = requestedPaths();
+    requested.sort();
+    QCOMPARE(requested, QStringList({"/release/files/LazyDogTools.exe", "/release/manifest.json",
+                                     "/release/plugins/audio.dll", "/release/translations/zh_CN.qm"}));
+
+    // 暂存清单按清单顺序列出有变化的文件，安装目录在替换前保持原样
+    QFile list(QDir(stageDir()).filePath("delta.list"));
+    QVERIFY(list.open(QIODevice::ReadOnly | QIODevice::Text));
+    QCOMPARE(list.readAll(), QByteArray("LazyDogTools.exe\nplugins/audio.dll\ntranslations/zh_CN.qm\n"));
+    QCOMPARE(readTree(installDir()), beforeTree());
+
+    FileTree staged = readTree(stageDir());
+    staged.remove("delta.list");
+    FileTree expected = releaseTree();
+    expected.remove("Qt6Core.dll");
+    QCOMPARE(staged, expected);
+}
+
+void TestDeltaUpdater::reuseStaged()
+{
+    // 上次已下载并校验通过的文件只参与替换，不再下载
+    writeTree(stageDir(), {{"plugins/audio.dll", "audio v2"}});
+
+    Result result = run();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.changedFiles, 3);
+    QVERIFY(!requestedPaths().contains("/release/plugins/audio.dll"));
+    QCOMPARE(requestedPaths().size(), 3);
+}
+
+void TestDeltaUpdater::nothingChanged()
+{
+    QDir(installDir()).removeRecursively();
+    writeTree(installDir(), releaseTree());
+
+    Result result = run();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.changedFiles, 0);
+    QCOMPARE(requestedPaths(), QStringList({"/release/manifest.json"}));
+}
+
+void TestDeltaUpdater::checksumMismatch()
+{
+    // 服务器上的文件与清单不符时整体失败，由调用方改用完整更新包
+    mServer->files.insert("/release/plugins/audio.dll", "audio v3");
+
+    Result result = run();
+    QVERIFY(!result.ok);
+    QVERIFY2(result.error.contains("plugins/audio.dll"), qPrintable(result.error));
+    QCOMPARE(readTree(installDir()), beforeTree());
+}
+
+void TestDeltaUpdater::applyAndCleanup()
+{
+    Result result = run();
+    QVERIFY2(result.ok, qPrintable(result.error));
+
+    QVERIFY(DeltaUpdater::apply(stageDir(), installDir()));
+
+    // 替换下来的旧文件改名保留，新增的文件没有 .old
+    FileTree expected = releaseTree();
+    expected.insert("readme.txt", "not in manifest");
+    expected.insert("LazyDogTools.exe.old", "exe v1");
+    expected.insert("plugins/audio.dll.old", "audio v1");
+    QCOMPARE(readTree(installDir()), expected);
+    QVERIFY(DeltaUpdater::hasOldFiles(stageDir(), installDir()));
+
+    // 旧进程退出后清理 .old，之后才能删除暂存清单
+    QVERIFY(DeltaUpdater::cleanup(stageDir(), installDir()));
+    QVERIFY(!DeltaUpdater::hasOldFiles(stageDir(), installDir()));
+    expected.remove("LazyDogTools.exe.old");
+    expected.remove("plugins/audio.dll.old");
+    QCOMPARE(readTree(installDir()), expected);
+}
+
+void TestDeltaUpdater::applyRollback()
+{
+    Result result = run();
+    QVERIFY2(result.ok, qPrintable(result.error));
+
+    // 最后一个文件复制失败，已替换的文件全部还原
+    QVERIFY(QFile::remove(QDir(stageDir()).filePath("translations/zh_CN.qm")));
+    QVERIFY(!DeltaUpdater::apply(stageDir(), installDir()));
+    QCOMPARE(readTree(installDir()), beforeTree());
+    QVERIFY(!DeltaUpdater::hasOldFiles(stageDir(), installDir()));
+}
+
+QTEST_GUILESS_MAIN(TestDeltaUpdater)
+
+#include "main.moc"
@@ -0,0 +1,20 @@
+QT = core network concurrent testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 追踪编译为空，避免引入 Trace.cpp 的 Windows 依赖；清单与文件由测试在本机端口上提供
+DEFINES += LAZYDOG_NO_TRACE
+
+INCLUDEPATH += ../.. ../common
+
+SOURCES += \
+    main.cpp \
+    ../../DeltaUpdater.cpp \
+    ../../UpdateDownloader.cpp
+
+HEADERS += \
+    ../common/FixtureServer.h \
+    ../common/TestHelpers.h \
+    ../../DeltaUpdater.h \
+    ../../UpdateDownloader.h
@@ -0,0 +1,288 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 11:05:26
+ * @brief 日志模块的测试：无锁队列的正确性与多生产者吞吐，函数名提取与缓存，二进制日志的截断恢复
+ */
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "LogQueue.h"
+#include "LogFunctionName.h"
+#include "BinaryLog.h"
+
+class TestLogging : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void queueOrder();
+    void queueFull();
+    void queueProducers_data();
+    void queueProducers();
+    void functionName_data();
+    void functionName();
+    void functionNameCache();
+    void benchmarkFunctionName_data();
+    void benchmarkFunctionName();
+    void binaryLogRoundTrip();
+    void binaryLogTruncatedTail();
+};
+
+void TestLogging::queueOrder()
+{
+    LogQueue<LogRecord> queue(8);
+    for (int round = 0; round < 3; ++round)
+    {
+        // 多轮写满再读空，覆盖序号回绕
+        for (int i = 0; i < 8; ++i)
+            QVERIFY(queue.push({QtDebugMsg, "queueOrder", i, QString::number(i)}));
+
+        LogRecord record;
+        for (int i = 0; i < 8; ++i)
+        {
+            QVERIFY(queue.pop(&record));
+            QCOMPARE(record.time, qint64(i));
+            QCOMPARE(record.msg, QString::number(i));
+        }
+        QVERIFY(!queue.pop(&record));
+    }
+    QCOMPARE(queue.enqueued(), size_t(24));
+    QCOMPARE(queue.dequeued(), size_t(24));
+}
+
+void TestLogging::queueFull()
+{
+    LogQueue<LogRecord> queue(4);
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(queue.push({QtInfoMsg, "queueFull", i, QString()}));
+    QVERIFY(!queue.push({QtInfoMsg, "queueFull", 4, QString()}));
+
+    LogRecord record;
+    QVERIFY(queue.pop(&record));
+    QVERIFY(queue.push({QtInfoMsg, "queueFull", 5, QString()}));
+}
+
+void TestLogging::queueProducers_data()
+{
+    QTest::addColumn<int>("producers");
+    QTest::newRow("1 producer") << 1;
+    QTest::newRow("4 producers") << 4;
+    QTest::newRow("8 producers") << 8;
+}
+
+// 吞吐：多个生产者同时写入，单个消费者读出，与日志写线程的用法一致。
+// 队列满时生产者让出时间片重试，因此结果是整条链路的持续吞吐，而不是只计入队速度
+void TestLogging::queueProducers()
+{
+    QFETCH(int, producers);
+    const int perProducer = 1 << 18;
+    const QString msg("Audio device switched to {0.0.0.00000000}.{a1b2c3d4-0000-0000-0000-000000000000}");
+
+    LogQueue<LogRecord> queue(4096);
+    std::atomic<bool> go(false);
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back(QThread::create([&queue, &go, &msg, p, perProducer]() {
+            while (!go.load(std::memory_order_acquire))
+                QThread::yieldCurrentThread();
+            for (int i = 0; i < perProducer; ++i)
+            {
+                // 时间字段携带生产者与序号，用于校验每个生产者内部的顺序
+                // push 失败时不会移走记录，可以直接重试
+                LogRecord record{QtDebugMsg, "queueProducers", (qint64(p) << 32) | i, msg};
+                while (!queue.push(std::move(record)))
+                    QThread::yieldCurrentThread();
+            }
+        }));
+        threads.back()->start();
+    }
+
+    std::vector<qint64> next(producers, 0);
+    const qint64 total = qint64(producers) * perProducer;
+    bool ordered = true;
+
+    QElapsedTimer timer;
+    timer.start();
+    go.store(true, std::memory_order_release);
+
+    LogRecord record;
+    for (qint64 received = 0; received < total;)
+    {
+        if (!queue.pop(&record))
+            continue;
+        int p = int(record.time >> 32);
+        qint64 index = record.time & 0xFFFFFFFF;
+        ordered = ordered && index == next[p];
+        next[p] = index + 1;
+        ++received;
+    }
+    qint64 nsecs = timer.nsecsElapsed();
+
+    for (auto &thread : threads)
+        thread->wait();
+
+    QVERIFY(ordered);
+    QCOMPARE(queue.enqueued(), size_t(total));
+    qInfo("%d producer(s): %.0f messages/sec", producers, total * 1e9 / qMax<qint64>(nsecs, 1));
+}
+
+void TestLogging::functionName_data()
+{
+    QTest::addColumn<QString>("signature");
+    QTest::addColumn<QString>("name");
+
+    // MSVC __FUNCSIG__
+    QTest::newRow("msvc") << "void __cdecl AudioHelperServer::server(void)" << "AudioHelperServer::server";
+    QTest::newRow("msvc template class") << "void __cdecl Foo<int>::bar(void)" << "Foo::bar";
+    QTest::newRow("msvc template args") << "bool __cdecl WinAudioBackend::enumerateDevices(class QMap<class QString,class QString> *)"
+                                        << "WinAudioBackend::enumerateDevices";
+    QTest::newRow("msvc lambda") << "auto __cdecl TaskMonitor::collectProcesses::<lambda_1>::operator ()(void) const"
+                                 << "TaskMonitor::collectProcesses";
+
+    // GCC/Clang __PRETTY_FUNCTION__
+    QTest::newRow("gcc") << "void AudioHelperServer::server()" << "AudioHelperServer::server";
+    QTest::newRow("gcc reference return") << "static LogHandler& LogHandler::instance()" << "LogHandler::instance";
+    QTest::newRow("gcc virtual") << "virtual bool WinAudioBackend::enumerateDevices(AudioDeviceList*)" << "WinAudioBackend::enumerateDevices";
+    QTest::newRow("gcc template") << "QList<int> Foo::bar<QString>(int)" << "Foo::bar";
+    QTest::newRow("gcc lambda") << "TaskMonitor::collectProcesses()::<lambda()>" << "TaskMonitor::collectProcesses";
+    QTest::newRow("gcc nested") << "void ns::Outer::Inner::method()" << "Inner::method";
+
+    QTest::newRow("free function") << "int main(int, char**)" << "main";
+    QTest::newRow("empty") << "" << "LogHandler::Default";
+}
+
+void TestLogging::functionName()
+{
+    QFETCH(QString, signature);
+    QFETCH(QString, name);
+
+    QByteArray function = signature.toLatin1();
+    QCOMPARE(parseFunctionName(function.constData()), name);
+}
+
+void TestLogging::functionNameCache()
+{
+    static const char *function = "void __cdecl AudioHelperServer::server(void)";
+    QCOMPARE(extractFunctionName(function), QString("AudioHelperServer::server"));
+    // 命中缓存时返回同一份共享的字符串
+    QVERIFY(extractFunctionName(function).isSharedWith(extractFunctionName(function)));
+    QCOMPARE(extractFunctionName(nullptr), QString("LogHandler::Default"));
+}
+
+void TestLogging::benchmarkFunctionName_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::newRow("regex") << 0;
+    QTest::newRow("parse") << 1;
+    QTest::newRow("cached") << 2;
+}
+
+// 对比原先每条日志都跑一次的正则、直接解析与按调用点缓存三种方式
+void TestLogging::benchmarkFunctionName()
+{
+    QFETCH(int, mode);
+    static const char *function = "void __cdecl AudioHelperServer::server(void)";
+    static const QRegularExpression FuncNameRegex(R"(\b(?:__cdecl|__stdcall|__fastcall|__thiscall|__vectorcall)\s*(\w+::\w+))");
+
+    QString name;
+    QBENCHMARK {
+        switch (mode) {
+        case 0: {
+            QRegularExpressionMatch match = FuncNameRegex.match(QString(function));
+            name = match.hasMatch() ? match.captured(1) : QString("LogHandler::Default");
+            break;
+        }
+        case 1:
+            name = parseFunctionName(function);
+            break;
+        default:
+            name = extractFunctionName(function);
+            break;
+        }
+    }
+    QCOMPARE(name, QString("AudioHelperServer::server"));
+}
+
+static QList<BinaryLogDecoder::Entry> decodeAll(const QByteArray &data, bool *truncated = nullptr)
+{
+    QList<BinaryLogDecoder::Entry> entries;
+    BinaryLogDecoder decoder(reinterpret_cast<const uchar *>(data.constData()), data.size());
+    BinaryLogDecoder::Entry entry;
+    while (decoder.next(&entry))
+        entries.append(entry);
+    if (truncated != nullptr)
+        *truncated = decoder.truncated();
+    return entries;
+}
+
+void TestLogging::binaryLogRoundTrip()
+{
+    QByteArray data;
+    BinaryLogEncoder encoder;
+    BinaryLogEncoder::writeHeader(&data);
+    encoder.beginSession(1000, &data);
+    encoder.encode(QtInfoMsg, 1000, "LogHandler::rotateLogs", "started", &data);
+    encoder.encode(QtWarningMsg, 990, "AudioHelperServer::server", "clock went back", &data);
+    encoder.encode(QtDebugMsg, 5000, "LogHandler::rotateLogs", QString::fromUtf8("中文消息"), &data);
+
+    QCOMPARE(BinaryLogDecoder::validSize(reinterpret_cast<const uchar *>(data.constData()), data.size()), qint64(data.size()));
+
+    bool truncated = true;
+    const QList<BinaryLogDecoder::Entry> entries = decodeAll(data, &truncated);
+    QVERIFY(!truncated);
+    QCOMPARE(int(entries.size()), 3);
+    QCOMPARE(entries.at(1).type, QtWarningMsg);
+    QCOMPARE(entries.at(1).time, qint64(990));
+    QCOMPARE(entries.at(1).tag, QString("AudioHelperServer::server"));
+    QCOMPARE(entries.at(2).tag, QString("LogHandler::rotateLogs"));
+    QCOMPARE(entries.at(2).msg, QString::fromUtf8("中文消息"));
+}
+
+// 模拟写入中途崩溃：截断到最后一条完整记录后再追加新会话，新会话必须能完整解码
+void TestLogging::binaryLogTruncatedTail()
+{
+    QByteArray data;
+    BinaryLogEncoder encoder;
+    BinaryLogEncoder::writeHeader(&data);
+    encoder.beginSession(1000, &data);
+    encoder.encode(QtInfoMsg, 1000, "Session::first", "complete", &data);
+    const qint64 complete = data.size();
+    encoder.encode(QtInfoMsg, 1100, "Session::first", "cut off by a crash", &data);
+
+    for (qint64 cut = complete + 1; cut < data.size(); ++cut)
+    {
+        QByteArray crashed = data.left(cut);
+        qint64 validSize = BinaryLogDecoder::validSize(reinterpret_cast<const uchar *>(crashed.constData()), crashed.size());
+        QCOMPARE(validSize, complete);
+
+        BinaryLogEncoder next;
+        QByteArray session;
+        next.beginSession(2000, &session);
+        next.encode(QtWarningMsg, 2000, "Session::second", "after restart", &session);
+
+        // 不截断直接追加时，半条记录会吞掉或挡住新会话
+        for (const BinaryLogDecoder::Entry &entry : decodeAll(crashed + session))
+            QVERIFY(entry.tag != "Session::second");
+
+        bool truncated = true;
+        const QList<BinaryLogDecoder::Entry> entries = decodeAll(crashed.left(validSize) + session, &truncated);
+        QVERIFY(!truncated);
+        QCOMPARE(int(entries.size()), 2);
+        QCOMPARE(entries.at(1).tag, QString("Session::second"));
+        QCOMPARE(entries.at(1).time, qint64(2000));
+    }
+
+    // 文件头不完整时整个文件无效
+    QCOMPARE(BinaryLogDecoder::validSize(reinterpret_cast<const uchar *>(data.constData()), 3), qint64(0));
+}
+
+QTEST_APPLESS_MAIN(TestLogging)
+
+#include "main.moc"
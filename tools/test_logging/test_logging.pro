@@ -0,0 +1,16 @@
+QT = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 日志中只依赖QtCore的部分：队列、函数名提取与二进制格式
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../LogFunctionName.cpp
+
+HEADERS += \
+    ../../BinaryLog.h \
+    ../../LogFunctionName.h \
+    ../../LogQueue.h
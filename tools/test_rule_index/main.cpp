@@ -0,0 +1,183 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 09:12:40
+ * @brief RuleIndex 的测试：前缀匹配与线性 startsWith 扫描结果一致，并测量 1k 规则 × 500 进程的匹配耗时
+ */
+
+#include <QtTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "RuleIndex.h"
+
+// 生成带公共目录层级的路径，使前缀之间大量嵌套，接近真实的安装目录
+static QString randomPath(QRandomGenerator *random, int depth)
+{
+    static const QStringList parts = {"C:/Program Files", "Steam", "steamapps", "common", "Game",
+                                      "bin", "x64", "Tools", "D:/Games", "Launcher", "app", "Epic"};
+    QString path = parts.at(random->bounded(2) == 0 ? 0 : 8);
+    for (int i = 0; i < depth; ++i)
+        path += "/" + parts.at(random->bounded(int(parts.size())));
+    return path;
+}
+
+static RelatedList makeRules(QRandomGenerator *random, int count)
+{
+    RelatedList rules;
+    rules.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        RelatedItem item;
+        item.id = uint(i + 1);
+        item.taskInfo.path = randomPath(random, 1 + random->bounded(4));
+        // 一部分规则是可执行文件，一部分是目录
+        if (random->bounded(2) == 0)
+            item.taskInfo.path += QString("/game%1.exe").arg(random->bounded(50));
+        rules.append(item);
+    }
+    return rules;
+}
+
+static QStringList makePaths(QRandomGenerator *random, int count)
+{
+    QStringList paths;
+    paths.reserve(count);
+    for (int i = 0; i < count; ++i)
+        paths.append(randomPath(random, 1 + random->bounded(5)) + QString("/game%1.exe").arg(random->bounded(50)));
+    return paths;
+}
+
+class TestRuleIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emptyTable();
+    void nestedPrefixes();
+    void duplicatePrefixes();
+    void matchesLinearScan();
+    void lookupById();
+    void benchmarkMatch();
+};
+
+void TestRuleIndex::emptyTable()
+{
+    PrefixTable table;
+    table.build();
+    QVERIFY(table.isEmpty());
+    QVERIFY(!table.matches("C:/Program Files/app.exe"));
+}
+
+void TestRuleIndex::nestedPrefixes()
+{
+    PrefixTable table;
+    table.insert("C:/Games", 0);
+    table.insert("C:/Games/Steam", 1);
+    table.insert("C:/Games/Steam/game.exe", 2);
+    table.insert("C:/Games/Epic", 3);
+    table.insert("C:/Gamesx", 4);
+    table.build();
+
+    QList<int> matched;
+    table.match("C:/Games/Steam/game.exe", [&matched](int value) { matched.append(value); });
+    // 由长到短
+    QCOMPARE(matched, QList<int>({2, 1, 0}));
+
+    matched.clear();
+    table.match("C:/Games/Epic/launcher.exe", [&matched](int value) { matched.append(value); });
+    QCOMPARE(matched, QList<int>({3, 0}));
+
+    // 字典序上落在两个兄弟前缀之间的路径，仍要沿父链找到公共前缀
+    matched.clear();
+    table.match("C:/Games/Origin/app.exe", [&matched](int value) { matched.append(value); });
+    QCOMPARE(matched, QList<int>({0}));
+
+    QVERIFY(!table.matches("C:/Game"));
+    QVERIFY(!table.matches("D:/Games/Steam"));
+}
+
+void TestRuleIndex::duplicatePrefixes()
+{
+    PrefixTable table;
+    table.insert("C:/Games/game.exe", 5);
+    table.insert("C:/Games", 1);
+    table.insert("C:/Games/game.exe", 3);
+    table.build();
+
+    QList<int> matched;
+    table.match("C:/Games/game.exe", [&matched](int value) { matched.append(value); });
+    // 相同前缀的值保持插入顺序
+    QCOMPARE(matched, QList<int>({5, 3, 1}));
+}
+
+void TestRuleIndex::matchesLinearScan()
+{
+    QRandomGenerator random(20261017);
+    const RelatedList rules = makeRules(&random, 1000);
+    const QStringList paths = makePaths(&random, 500);
+
+    RuleIndex index;
+    index.rebuild(rules);
+    QCOMPARE(index.size(), int(rules.size()));
+
+    int total = 0;
+    for (const QString &path : paths)
+    {
+        QList<int> expected;
+        for (int slot = 0; slot < rules.size(); ++slot)
+        {
+            if (path.startsWith(rules.at(slot).taskInfo.path))
+                expected.append(slot);
+        }
+
+        QList<int> matched;
+        index.match(path, [&matched](int slot) { matched.append(slot); });
+        std::sort(matched.begin(), matched.end());
+
+        QCOMPARE(matched, expected);
+        total += int(matched.size());
+    }
+
+    // 确认样本确实覆盖了命中的情况
+    QVERIFY(total > 0);
+}
+
+void TestRuleIndex::lookupById()
+{
+    QRandomGenerator random(7);
+    const RelatedList rules = makeRules(&random, 100);
+
+    RuleIndex index;
+    index.rebuild(rules);
+    for (int slot = 0; slot < rules.size(); ++slot)
+    {
+        QCOMPARE(index.slot(rules.at(slot).id), slot);
+        QCOMPARE(index.related(rules.at(slot).id)->taskInfo.path, rules.at(slot).taskInfo.path);
+        QCOMPARE(index.at(slot).id, rules.at(slot).id);
+    }
+
+    QCOMPARE(index.slot(0), -1);
+    QVERIFY(index.related(uint(rules.size() + 1)) == nullptr);
+}
+
+void TestRuleIndex::benchmarkMatch()
+{
+    QRandomGenerator random(20261017);
+    const RelatedList rules = makeRules(&random, 1000);
+    const QStringList paths = makePaths(&random, 500);
+
+    RuleIndex index;
+    index.rebuild(rules);
+
+    // 一次迭代即一轮评分中 500 个进程的全部前缀匹配
+    int hits = 0;
+    QBENCHMARK {
+        for (const QString &path : paths)
+            index.match(path, [&hits](int) { ++hits; });
+    }
+    QVERIFY(hits > 0);
+}
+
+QTEST_APPLESS_MAIN(TestRuleIndex)
+
+#include "main.moc"
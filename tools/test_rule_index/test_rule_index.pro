@@ -0,0 +1,15 @@
+QT = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 直接编译主程序的规则索引，它只依赖QtCore
+INCLUDEPATH += ../.. ../../AudioHelper
+
+SOURCES += \
+    main.cpp \
+    ../../AudioHelper/RuleIndex.cpp
+
+HEADERS += \
+    ../../AudioHelper/AudioTypes.h \
+    ../../AudioHelper/RuleIndex.h
@@ -0,0 +1,163 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 14:21:07
+ * @brief 事件模式的测试：假事件源回放脚本化的进程与窗口事件，检查任务状态、合并评分与补偿到期后的重新评分
+ */
+
+#include <QtTest>
+#include <QDateTime>
+#include "TaskEventSource.h"
+#include "TaskEventTracker.h"
+
+static TaskEvent makeEvent(TaskEvent::Type type, quintptr id, const QString &path = QString(), qint64 startTime = 0)
+{
+    return {type, id, {path.section('/', -1), path, 0}, startTime};
+}
+
+static RelatedItem makeRule(uint id, const QString &path, const QString &device)
+{
+    RelatedItem item;
+    item.id = id;
+    item.taskInfo = {path.section('/', -1), path, 0};
+    item.typeInfo = {"应用程序", "游戏"};
+    item.audioDeviceInfo = {device, device};
+    return item;
+}
+
+static QStringList windowPaths(TaskEventTracker &tracker)
+{
+    QStringList paths;
+    for (const TaskRecord &record : std::as_const(tracker.windowTasks()))
+        paths.append(record.taskInfo.path);
+    return paths;
+}
+
+class TestTaskEvents : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void trackState();
+    void coalescedRescore();
+    void expiryRescore();
+    void clearStops();
+};
+
+void TestTaskEvents::trackState()
+{
+    FakeTaskEventSource source({
+        makeEvent(TaskEvent::ProcessStarted, 1, "C:/Games/game.exe", 1000),
+        makeEvent(TaskEvent::ProcessStarted, 2, "C:/Music/player.exe", 2000),
+        makeEvent(TaskEvent::WindowOpened, 100, "C:/Games/game.exe"),
+        makeEvent(TaskEvent::WindowOpened, 200, "C:/Music/player.exe"),
+        makeEvent(TaskEvent::ForegroundChanged, 100, "C:/Games/game.exe"),
+        makeEvent(TaskEvent::ProcessExited, 2),
+        makeEvent(TaskEvent::WindowClosed, 200),
+    });
+    TaskEventTracker tracker;
+    connect(&source, &TaskEventSource::taskEvent, &tracker, &TaskEventTracker::handleEvent);
+
+    // 间隔为0时同步回放全部事件
+    QVERIFY(source.start());
+    QVERIFY(source.atEnd());
+
+    QCOMPARE(tracker.processTasks().keys(), QList<quintptr>({1}));
+    QCOMPARE(tracker.processTasks().value(1).startTime, qint64(1000));
+    QCOMPARE(windowPaths(tracker), QStringList({"C:/Games/game.exe"}));
+
+    // 激活已有窗口会把它移到末尾，而不是重复记录
+    tracker.handleEvent(makeEvent(TaskEvent::WindowOpened, 300, "C:/Video/video.exe"));
+    tracker.handleEvent(makeEvent(TaskEvent::ForegroundChanged, 100, "C:/Games/game.exe"));
+    QCOMPARE(windowPaths(tracker), QStringList({"C:/Video/video.exe", "C:/Games/game.exe"}));
+}
+
+void TestTaskEvents::coalescedRescore()
+{
+    FakeTaskEventSource source;
+    for (quintptr id = 1; id <= 50; ++id)
+        source.push(makeEvent(TaskEvent::ProcessStarted, id, QString("C:/Apps/app%1.exe").arg(id), 0));
+
+    TaskEventTracker tracker;
+    QSignalSpy spy(&tracker, &TaskEventTracker::rescore);
+    connect(&source, &TaskEventSource::taskEvent, &tracker, &TaskEventTracker::handleEvent);
+
+    // 同步的一批事件只评分一次
+    source.start();
+    QCOMPARE(spy.count(), 0);
+    QVERIFY(spy.wait(1000));
+    QTest::qWait(TaskEventTracker::COALESCE_MSEC * 2);
+    QCOMPARE(spy.count(), 1);
+
+    // 间隔小于合并窗口的事件同样合并为一次
+    for (quintptr id = 1; id <= 5; ++id)
+        source.push(makeEvent(TaskEvent::ProcessExited, id));
+    source.setInterval(10);
+    source.start();
+    QTRY_VERIFY_WITH_TIMEOUT(source.atEnd(), 1000);
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 2, 1000);
+    QTest::qWait(TaskEventTracker::COALESCE_MSEC * 2);
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(tracker.processTasks().size(), 45);
+
+    // 未知进程退出、未知窗口关闭不改变状态，也不触发评分
+    tracker.handleEvent(makeEvent(TaskEvent::ProcessExited, 1));
+    tracker.handleEvent(makeEvent(TaskEvent::WindowClosed, 999));
+    QTest::qWait(TaskEventTracker::COALESCE_MSEC * 2);
+    QCOMPARE(spy.count(), 2);
+}
+
+void TestTaskEvents::expiryRescore()
+{
+    // 补偿剩余约400ms的新进程：之后没有任何事件，到期后需要自行重新评分一次
+    const qint64 remaining = 400;
+    FakeTaskEventSource source({makeEvent(TaskEvent::ProcessStarted, 1, "C:/Games/game.exe",
+                                          QDateTime::currentMSecsSinceEpoch() - (PROCESS_COMPENSATE_MSEC - remaining))});
+
+    WeightEngine engine;
+    engine.setRules({makeRule(1, "C:/Games/game.exe", "headset")});
+    TaskEventTracker tracker;
+    QList<ScoreResult> results;
+    connect(&source, &TaskEventSource::taskEvent, &tracker, &TaskEventTracker::handleEvent);
+    connect(&tracker, &TaskEventTracker::rescore, this, [&]() {
+        // 与服务相同：用真实时钟评分，并按结果安排补偿到期
+        ScoreOptions options{true, true, QString(), QDateTime::currentMSecsSinceEpoch(), nullptr};
+        ScoreResult result = scoreTasks(engine, options, tracker.windowTasks(), tracker.processTasks());
+        tracker.scheduleExpire(result.nextExpire);
+        results.append(result);
+    });
+
+    source.start();
+    QTRY_COMPARE_WITH_TIMEOUT(results.size(), 1, 1000);
+    QCOMPARE(int(results.at(0).weight), 3);
+    QVERIFY(results.at(0).nextExpire > 0);
+    QVERIFY(results.at(0).nextExpire <= remaining + 1);
+
+    // 到期评分不能早于补偿结束，否则会再算一次补偿并继续安排
+    QTRY_COMPARE_WITH_TIMEOUT(results.size(), 2, int(remaining) + 1000);
+    QCOMPARE(results.at(1).slot, results.at(0).slot);
+    QCOMPARE(int(results.at(1).weight), 1);
+    QCOMPARE(results.at(1).nextExpire, qint64(0));
+
+    QTest::qWait(int(remaining));
+    QCOMPARE(results.size(), 2);
+}
+
+void TestTaskEvents::clearStops()
+{
+    TaskEventTracker tracker;
+    QSignalSpy spy(&tracker, &TaskEventTracker::rescore);
+
+    tracker.handleEvent(makeEvent(TaskEvent::ProcessStarted, 1, "C:/Games/game.exe", 0));
+    tracker.handleEvent(makeEvent(TaskEvent::WindowOpened, 100, "C:/Games/game.exe"));
+    tracker.scheduleExpire(50);
+    tracker.clear();
+
+    QVERIFY(tracker.processTasks().isEmpty());
+    QVERIFY(tracker.windowTasks().isEmpty());
+    QTest::qWait(TaskEventTracker::COALESCE_MSEC * 2);
+    QCOMPARE(spy.count(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestTaskEvents)
+#include "main.moc"
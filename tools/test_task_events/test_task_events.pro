@@ -0,0 +1,25 @@
+QT = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 事件接口、假事件源与任务跟踪只依赖QtCore；追踪在测试中编译为空，避免引入 Trace.cpp 的 Windows 依赖
+DEFINES += LAZYDOG_NO_TRACE
+
+INCLUDEPATH += ../.. ../../AudioHelper
+
+SOURCES += \
+    main.cpp \
+    ../../AudioHelper/TaskEventSource.cpp \
+    ../../AudioHelper/TaskEventTracker.cpp \
+    ../../AudioHelper/RuleIndex.cpp \
+    ../../AudioHelper/WeightEngine.cpp \
+    ../../Metrics.cpp
+
+HEADERS += \
+    ../../AudioHelper/AudioTypes.h \
+    ../../AudioHelper/TaskEventSource.h \
+    ../../AudioHelper/TaskEventTracker.h \
+    ../../AudioHelper/RuleIndex.h \
+    ../../AudioHelper/WeightEngine.h \
+    ../../Metrics.h
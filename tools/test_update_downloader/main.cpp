@@ -0,0 +1,220 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 17:41:09
+ * @brief 更新包下载的测试：本机 QTcpServer 模拟下载服务器，覆盖断点续传、续传被拒绝、文件变化、SHA-256 校验与进度
+ */
+
+#include <QtTest>
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+#include <QRandomGenerator>
+#include <memory>
+#include "FixtureServer.h"
+#include "TestHelpers.h"
+#include "UpdateDownloader.h"
+
+class TestUpdateDownloader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void download();
+    void resumeAfterInterruption();
+    void resumeIgnored();
+    void resumeFileChanged();
+    void resumeRejected();
+    void shaMismatch();
+    void checksumFile();
+    void notFound();
+
+private:
+    struct Result : TestHelpers::AsyncResult {
+        QList<QPair<qint64, qint64>> progress;
+    };
+
+    Result run(const QString &sha256 = QString(), const QUrl &checksumUrl = QUrl(), const QString &path = "/update.zip");
+    QString targetFile() const { return mDir.filePath("update.zip"); }
+    QByteArray readTarget() const { return mDir.read("update.zip"); }
+
+    TestHelpers::TestDir mDir;
+    std::unique_ptr<FixtureServer> mServer;
+    std::unique_ptr<QNetworkAccessManager> mManager;
+    QByteArray mContent;
+};
+
+static QByteArray randomContent(int size, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QByteArray content(size, Qt::Uninitialized);
+    for (char &byte : content)
+        byte = char(random.bounded(256));
+    return content;
+}
+
+static QString sha256Hex(const QByteArray &data)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex());
+}
+
+void TestUpdateDownloader::init()
+{
+    QVERIFY(mDir.reset());
+
+    // 比套接字缓冲区大得多，保证分多次到达
+    mContent = randomContent(512 * 1024, 1);
+    mServer.reset(new FixtureServer);
+    mServer->files.insert("/update.zip", mContent);
+    QVERIFY(mServer->listen());
+
+    mManager.reset(new QNetworkAccessManager);
+    mManager->setProxy(QNetworkProxy::NoProxy);
+}
+
+void TestUpdateDownloader::cleanup()
+{
+    mManager.reset();
+    mServer.reset();
+    mDir.clear();
+}
+
+TestUpdateDownloader::Result TestUpdateDownloader::run(const QString &sha256, const QUrl &checksumUrl, const QString &path)
+{
+    Result result;
+    UpdateDownloader downloader(mManager.get());
+    connect(&downloader, &UpdateDownloader::progress, this, [&result](qint64 received, qint64 total) {
+        result.progress.append(qMakePair(received, total));
+    });
+    TestHelpers::SignalWaiter waiter(&result);
+    waiter.succeedOn(&downloader, &UpdateDownloader::finished);
+    waiter.failOn(&downloader, &UpdateDownloader::failed);
+
+    downloader.start(mServer->url(path), targetFile(), sha256, checksumUrl);
+    waiter.wait();
+    return result;
+}
+
+void TestUpdateDownloader::download()
+{
+    Result result = run(sha256Hex(mContent));
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(readTarget(), mContent);
+    QVERIFY(!QFileInfo::exists(targetFile() + ".part"));
+    QVERIFY(!QFileInfo::exists(targetFile() + ".part.meta"));
+
+    // 进度单调不减，最后一次为 (总大小, 总大小)
+    QVERIFY(!result.progress.isEmpty());
+    for (int i = 1; i < result.progress.size(); ++i)
+        QVERIFY(result.progress.at(i).first >= result.progress.at(i - 1).first);
+    QCOMPARE(result.progress.last().first, qint64(mContent.size()));
+    QCOMPARE(result.progress.last().second, qint64(mContent.size()));
+}
+
+void TestUpdateDownloader::resumeAfterInterruption()
+{
+    const qint64 cut = 100000;
+    mServer->cutAfter = cut;
+    Result first = run(sha256Hex(mContent));
+    QVERIFY(!first.ok);
+    QCOMPARE(QFileInfo(targetFile() + ".part").size(), cut);
+
+    Result second = run(sha256Hex(mContent));
+    QVERIFY2(second.ok, qPrintable(second.error));
+    QCOMPARE(readTarget(), mContent);
+
+    // 第二次只请求缺少的部分，并带上第一次记录的 ETag
+    QCOMPARE(mServer->requests.size(), 2);
+    QCOMPARE(mServer->requests.last().range, QByteArray("bytes=" + QByteArray::number(cut) + "-"));
+    QCOMPARE(mServer->requests.last().ifRange, mServer->etag);
+
+    // 续传的进度从已有的字节数算起，总大小仍是整个文件
+    QVERIFY(!second.progress.isEmpty());
+    QVERIFY(second.progress.first().first >= cut);
+    QCOMPARE(second.progress.last().second, qint64(mContent.size()));
+}
+
+void TestUpdateDownloader::resumeIgnored()
+{
+    mServer->cutAfter = 100000;
+    QVERIFY(!run(sha256Hex(mContent)).ok);
+
+    // 服务器不支持 Range 时返回 200 和完整内容，已有的片段需丢弃
+    mServer->ignoreRange = true;
+    Result result = run(sha256Hex(mContent));
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(readTarget(), mContent);
+    QVERIFY(!mServer->requests.last().range.isEmpty());
+}
+
+void TestUpdateDownloader::resumeFileChanged()
+{
+    mServer->cutAfter = 100000;
+    QVERIFY(!run(sha256Hex(mContent)).ok);
+
+    // 两次请求之间发布了新版本，If-Range 不符，服务器返回新的完整文件
+    QByteArray updated = randomContent(300 * 1024, 2);
+    mServer->files.insert("/update.zip", updated);
+    mServer->etag = "\"v2\"";
+
+    Result result = run(sha256Hex(updated));
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(readTarget(), updated);
+    QCOMPARE(mServer->requests.last().ifRange, QByteArray("\"v1\""));
+}
+
+void TestUpdateDownloader::resumeRejected()
+{
+    mServer->cutAfter = 100000;
+    QVERIFY(!run(sha256Hex(mContent)).ok);
+
+    // 416 时丢弃片段，不带 Range 从头再请求一次
+    mServer->rejectRange = true;
+    Result result = run(sha256Hex(mContent));
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(readTarget(), mContent);
+    QCOMPARE(mServer->requests.size(), 3);
+    QVERIFY(!mServer->requests.at(1).range.isEmpty());
+    QVERIFY(mServer->requests.at(2).range.isEmpty());
+}
+
+void TestUpdateDownloader::shaMismatch()
+{
+    const QString expected = sha256Hex("something else");
+    Result result = run(expected);
+    QVERIFY(!result.ok);
+    QVERIFY2(result.error.contains(expected), qPrintable(result.error));
+
+    // 校验失败的内容不能留下，也不能作为下次续传的起点
+    QVERIFY(!QFileInfo::exists(targetFile()));
+    QVERIFY(!QFileInfo::exists(targetFile() + ".part"));
+    QVERIFY(!QFileInfo::exists(targetFile() + ".part.meta"));
+}
+
+void TestUpdateDownloader::checksumFile()
+{
+    mServer->files.insert("/update.zip.sha256", sha256Hex(mContent).toLatin1() + "  update.zip\n");
+    Result result = run(QString(), mServer->url("/update.zip.sha256"));
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(readTarget(), mContent);
+
+    QFile::remove(targetFile());
+    mServer->files.insert("/update.zip.sha256", sha256Hex("other").toLatin1() + "  update.zip\n");
+    result = run(QString(), mServer->url("/update.zip.sha256"));
+    QVERIFY(!result.ok);
+    QVERIFY(!QFileInfo::exists(targetFile()));
+}
+
+void TestUpdateDownloader::notFound()
+{
+    Result result = run(sha256Hex(mContent), QUrl(), "/missing.zip");
+    QVERIFY(!result.ok);
+    QVERIFY(result.error != "timeout");
+    QVERIFY(!QFileInfo::exists(targetFile()));
+}
+
+QTEST_GUILESS_MAIN(TestUpdateDownloader)
+
+#include "main.moc"
@@ -0,0 +1,16 @@
+QT = core network testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 下载器只依赖 QtNetwork；服务端由测试在本机端口上模拟
+INCLUDEPATH += ../.. ../common
+
+SOURCES += \
+    main.cpp \
+    ../../UpdateDownloader.cpp
+
+HEADERS += \
+    ../common/FixtureServer.h \
+    ../common/TestHelpers.h \
+    ../../UpdateDownloader.h
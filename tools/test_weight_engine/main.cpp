@@ -0,0 +1,166 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 09:58:31
+ * @brief WeightEngine 的测试：评分结果，以及预热之后每轮评分不做堆分配
+ */
+
+#include "AllocationCounter.h"
+#include <QtTest>
+#include <QMap>
+#include "WeightEngine.h"
+
+static RelatedItem makeRule(uint id, const QString &path, const QString &type, const QString &tag, const QString &device)
+{
+    RelatedItem item;
+    item.id = id;
+    item.taskInfo = {path.section('/', -1), path, 0};
+    item.typeInfo = {type, tag};
+    item.audioDeviceInfo = {device, device};
+    return item;
+}
+
+static TaskRecord makeTask(quintptr id, const QString &path, qint64 startTime)
+{
+    return {id, {path.section('/', -1), path, 0}, startTime, PathHandle()};
+}
+
+class TestWeightEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void windowOutweighsProcess();
+    void directoryLosesTies();
+    void newProcessCompensation();
+    void ignoredDevice();
+    void zeroAllocationsAfterWarmup();
+};
+
+void TestWeightEngine::windowOutweighsProcess()
+{
+    WeightEngine engine;
+    engine.setRules({makeRule(1, "C:/Games/game.exe", "应用程序", "游戏", "headset"),
+                     makeRule(2, "C:/Music/player.exe", "应用程序", "音乐", "speaker")});
+
+    QList<TaskRecord> windows = {makeTask(100, "C:/Music/player.exe", 0)};
+    QMap<quintptr, TaskRecord> processes;
+    processes.insert(1, makeTask(1, "C:/Games/game.exe", 0));
+    processes.insert(2, makeTask(2, "C:/Music/player.exe", 0));
+
+    ScoreOptions options{true, true, QString(), PROCESS_COMPENSATE_MSEC * 10, nullptr};
+    ScoreResult result = scoreTasks(engine, options, windows, processes);
+    QCOMPARE(engine.rules().at(result.slot).id, 2u);
+    QCOMPARE(int(result.weight), 3);
+    QCOMPARE(result.nextExpire, qint64(0));
+
+    // 场景加权让同分的规则胜出
+    windows.clear();
+    options.sceneTag = "游戏";
+    result = scoreTasks(engine, options, windows, processes);
+    QCOMPARE(engine.rules().at(result.slot).id, 1u);
+    QCOMPARE(int(result.weight), 2);
+}
+
+void TestWeightEngine::directoryLosesTies()
+{
+    WeightEngine engine;
+    engine.setRules({makeRule(1, "C:/Games", "文件夹", "游戏", "headset"),
+                     makeRule(2, "C:/Games/game.exe", "应用程序", "游戏", "speaker")});
+
+    QList<TaskRecord> windows = {makeTask(100, "C:/Games/game.exe", 0)};
+    QMap<quintptr, TaskRecord> processes;
+
+    ScoreOptions options{true, false, QString(), 0, nullptr};
+    ScoreResult result = scoreTasks(engine, options, windows, processes);
+    QCOMPARE(engine.rules().at(result.slot).id, 2u);
+}
+
+void TestWeightEngine::newProcessCompensation()
+{
+    WeightEngine engine;
+    engine.setRules({makeRule(1, "C:/Games/game.exe", "应用程序", "游戏", "headset")});
+
+    QList<TaskRecord> windows;
+    QMap<quintptr, TaskRecord> processes;
+    processes.insert(1, makeTask(1, "C:/Games/game.exe", 1000));
+
+    // 刚启动的进程额外加权，并报告补偿到期的时间
+    ScoreOptions options{false, true, QString(), 3000, nullptr};
+    ScoreResult result = scoreTasks(engine, options, windows, processes);
+    QCOMPARE(int(result.weight), 3);
+    QCOMPARE(result.nextExpire, PROCESS_COMPENSATE_MSEC - 2000 + 1);
+
+    options.now = 1000 + PROCESS_COMPENSATE_MSEC + 1;
+    result = scoreTasks(engine, options, windows, processes);
+    QCOMPARE(int(result.weight), 1);
+    QCOMPARE(result.nextExpire, qint64(0));
+}
+
+void TestWeightEngine::ignoredDevice()
+{
+    WeightEngine engine;
+    engine.setRules({makeRule(1, "C:/Games/game.exe", "应用程序", "游戏", "headset")});
+
+    QList<TaskRecord> windows = {makeTask(100, "C:/Games/game.exe", 0)};
+    QMap<quintptr, TaskRecord> processes;
+
+    IgnoreMap ignoreMap;
+    ignoreMap.insert("headset", 3);
+    ScoreOptions options{true, false, QString(), 0, &ignoreMap};
+    ScoreResult result = scoreTasks(engine, options, windows, processes);
+    QCOMPARE(result.slot, -1);
+}
+
+void TestWeightEngine::zeroAllocationsAfterWarmup()
+{
+    // 只统计 operator new 时看不到 Qt 容器的分配，零分配的结论不可信
+    if (!AllocationCounter::available())
+        QSKIP("Allocation counting needs a malloc hook (glibc or the MSVC debug CRT)");
+
+    RelatedList rules;
+    for (uint i = 0; i < 200; ++i)
+    {
+        QString dir = QString("C:/Games/Game%1").arg(i % 50);
+        rules.append(makeRule(i + 1, i % 4 == 0 ? dir : dir + QString("/bin/game%1.exe").arg(i),
+                              i % 4 == 0 ? "文件夹" : "应用程序", i % 3 == 0 ? "游戏" : "其它", QString("device%1").arg(i % 5)));
+    }
+
+    WeightEngine engine;
+    engine.setRules(rules);
+
+    QList<TaskRecord> windows;
+    for (int i = 0; i < 20; ++i)
+        windows.append(makeTask(quintptr(1000 + i), QString("C:/Games/Game%1/bin/game%2.exe").arg(i).arg(i * 4 + 1), 0));
+
+    QMap<quintptr, TaskRecord> processes;
+    for (int i = 0; i < 300; ++i)
+        processes.insert(quintptr(i), makeTask(quintptr(i), QString("C:/Games/Game%1/bin/game%2.exe").arg(i % 50).arg(i), i * 100));
+
+    IgnoreMap ignoreMap;
+    ignoreMap.insert("device4", 3);
+    ScoreOptions options{true, true, "游戏", 0, &ignoreMap};
+
+    // 预热：驻留全部路径，注册指标
+    for (int tick = 0; tick < 3; ++tick)
+        scoreTasks(engine, options, windows, processes);
+
+    const int ticks = 1000;
+    int picked = 0;
+    quint64 before = AllocationCounter::count();
+    for (int tick = 0; tick < ticks; ++tick)
+    {
+        // 时间推进，新进程补偿逐渐到期，每轮加权的槽位都不同
+        options.now = tick * 50;
+        ScoreResult result = scoreTasks(engine, options, windows, processes);
+        picked += result.slot >= 0 ? 1 : 0;
+    }
+    quint64 allocations = AllocationCounter::count() - before;
+
+    QCOMPARE(picked, ticks);
+    QCOMPARE(allocations, quint64(0));
+}
+
+QTEST_APPLESS_MAIN(TestWeightEngine)
+
+#include "main.moc"
@@ -0,0 +1,22 @@
+QT = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 评分代码只依赖QtCore；追踪在测试中编译为空，避免引入 Trace.cpp 的 Windows 依赖
+DEFINES += LAZYDOG_NO_TRACE
+
+INCLUDEPATH += ../.. ../../AudioHelper ../common
+
+SOURCES += \
+    main.cpp \
+    ../../AudioHelper/RuleIndex.cpp \
+    ../../AudioHelper/WeightEngine.cpp \
+    ../../Metrics.cpp
+
+HEADERS += \
+    ../common/AllocationCounter.h \
+    ../../AudioHelper/AudioTypes.h \
+    ../../AudioHelper/RuleIndex.h \
+    ../../AudioHelper/WeightEngine.h \
+    ../../Metrics.h
@@ -0,0 +1,417 @@
+/**
+ * @file main.cpp
+ * @author Asteri5m
+ * @date 2026-10-17 17:02:41
+ * @brief 更新包解压的测试：存储/压缩条目、数据描述符、非法路径与损坏数据，以及多文件并行解压的耗时
+ *
+ * 压缩包在用例中按 ZIP 格式直接拼出，不依赖外部文件或压缩工具。
+ * 解压基准默认使用约 100 MB 的低压缩率内容，可用环境变量 ZIP_BENCH_MB 调整大小。
+ */
+
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <zlib.h>
+#include "TestHelpers.h"
+#include "ZipExtractor.h"
+
+static const quint16 FLAG_DATA_DESCRIPTOR = 0x0008;
+static const quint16 FLAG_UTF8 = 0x0800;
+
+// 只写出解压器需要的字段：本地文件头 + 数据 [+ 数据描述符]，中央目录，目录结束记录
+class ZipBuilder
+{
+public:
+    struct Options {
+        quint16 method = 8;
+        quint16 flags = FLAG_UTF8;
+        bool badCrc = false;
+        int truncate = 0;       // 从压缩数据末尾去掉的字节数，中央目录中的大小随之减小
+    };
+
+    void addFile(const QString &name, const QByteArray &content, const Options &options)
+    {
+        QByteArray stored = options.method == 8 ? deflateRaw(content) : content;
+        stored.chop(options.truncate);
+
+        quint32 crc = quint32(crc32(0L, reinterpret_cast<const Bytef *>(content.constData()), uInt(content.size())));
+        if (options.badCrc)
+            crc ^= 0xFFFFFFFF;
+
+        addEntry(name.toUtf8(), stored, quint32(content.size()), crc, options.method, options.flags);
+    }
+
+    void addFile(const QString &name, const QByteArray &content)
+    {
+        addFile(name, content, Options());
+    }
+
+    void addDirectory(const QString &name)
+    {
+        addEntry(name.toUtf8(), QByteArray(), 0, 0, 0, FLAG_UTF8);
+    }
+
+    QByteArray finish(const QByteArray &comment = QByteArray()) const
+    {
+        QByteArray archive = mData + mCentral;
+        appendU32(&archive, 0x06054b50);
+        appendU16(&archive, 0);
+        appendU16(&archive, 0);
+        appendU16(&archive, quint16(mCount));
+        appendU16(&archive, quint16(mCount));
+        appendU32(&archive, quint32(mCentral.size()));
+        appendU32(&archive, quint32(mData.size()));
+        appendU16(&archive, quint16(comment.size()));
+        archive.append(comment);
+        return archive;
+    }
+
+private:
+    static void appendU16(QByteArray *out, quint16 value)
+    {
+        value = qToLittleEndian(value);
+        out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    static void appendU32(QByteArray *out, quint32 value)
+    {
+        value = qToLittleEndian(value);
+        out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    static QByteArray deflateRaw(const QByteArray &content)
+    {
+        z_stream strm = {};
+        deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        QByteArray out(int(deflateBound(&strm, uLong(content.size()))), Qt::Uninitialized);
+        strm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(content.constData()));
+        strm.avail_in = uInt(content.size());
+        strm.next_out = reinterpret_cast<Bytef *>(out.data());
+        strm.avail_out = uInt(out.size());
+        deflate(&strm, Z_FINISH);
+        out.resize(qsizetype(strm.total_out));
+        deflateEnd(&strm);
+        return out;
+    }
+
+    void addEntry(const QByteArray &name, const QByteArray &stored, quint32 size, quint32 crc, quint16 method, quint16 flags)
+    {
+        const quint32 offset = quint32(mData.size());
+        const bool descriptor = flags & FLAG_DATA_DESCRIPTOR;
+
+        // 使用数据描述符时本地文件头中的 CRC 与大小为0
+        appendU32(&mData, 0x04034b50);
+        appendU16(&mData, 20);
+        appendU16(&mData, flags);
+        appendU16(&mData, method);
+        appendU32(&mData, 0);                   // 修改时间与日期
+        appendU32(&mData, descriptor ? 0 : crc);
+        appendU32(&mData, descriptor ? 0 : quint32(stored.size()));
+        appendU32(&mData, descriptor ? 0 : size);
+        appendU16(&mData, quint16(name.size()));
+        appendU16(&mData, 0);
+        mData.append(name);
+        mData.append(stored);
+        if (descriptor) {
+            appendU32(&mData, 0x08074b50);
+            appendU32(&mData, crc);
+            appendU32(&mData, quint32(stored.size()));
+            appendU32(&mData, size);
+        }
+
+        appendU32(&mCentral, 0x02014b50);
+        appendU16(&mCentral, 20);
+        appendU16(&mCentral, 20);
+        appendU16(&mCentral, flags);
+        appendU16(&mCentral, method);
+        appendU32(&mCentral, 0);
+        appendU32(&mCentral, crc);
+        appendU32(&mCentral, quint32(stored.size()));
+        appendU32(&mCentral, size);
+        appendU16(&mCentral, quint16(name.size()));
+        appendU16(&mCentral, 0);                // 扩展字段
+        appendU16(&mCentral, 0);                // 注释
+        appendU16(&mCentral, 0);                // 磁盘号
+        appendU16(&mCentral, 0);                // 内部属性
+        appendU32(&mCentral, 0);                // 外部属性
+        appendU32(&mCentral, offset);
+        mCentral.append(name);
+        ++mCount;
+    }
+
+    QByteArray mData;
+    QByteArray mCentral;
+    int mCount = 0;
+};
+
+// 可压缩但不完全重复的内容，大小超过解压器的输出缓冲区时覆盖分段写出
+static QByteArray sampleContent(int size, int seed)
+{
+    QByteArray content;
+    content.reserve(size);
+    for (int line = 0; content.size() < size; ++line)
+        content += "line " + QByteArray::number(line) + " of entry " + QByteArray::number(seed) + "\n";
+    content.truncate(size);
+    return content;
+}
+
+// 与真实更新包中的可执行文件相近：以随机数据块为主，间杂可压缩的文本，整体几乎压不动
+static QByteArray binaryContent(qint64 size, quint32 seed)
+{
+    static const int BLOCK_SIZE = 16 * 1024;
+    QRandomGenerator random(seed);
+    QByteArray content;
+    content.reserve(size);
+    for (int block = 0; content.size() < size; ++block)
+    {
+        if (block % 4 == 3) {
+            content += sampleContent(BLOCK_SIZE / 4, int(seed) * 1000 + block);
+            continue;
+        }
+        QByteArray data(BLOCK_SIZE, Qt::Uninitialized);
+        random.fillRange(reinterpret_cast<quint32 *>(data.data()), BLOCK_SIZE / int(sizeof(quint32)));
+        content += data;
+    }
+    content.truncate(size);
+    return content;
+}
+
+class TestZipExtractor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void extractEntries();
+    void dataDescriptor();
+    void archiveComment();
+    void rejectsUnsafeNames_data();
+    void rejectsUnsafeNames();
+    void crcMismatch();
+    void truncatedEntry();
+    void truncatedArchive();
+    void unsupportedMethod();
+    void benchmarkExtract();
+
+private:
+    bool writeArchive(const QByteArray &archive, QString *zipFile) const;
+    bool extract(const QByteArray &archive, QString *error = nullptr);
+    QByteArray readOutput(const QString &name) const;
+    QString outputDir() const;
+
+    TestHelpers::TestDir mDir;
+};
+
+void TestZipExtractor::init()
+{
+    QVERIFY(mDir.reset());
+}
+
+void TestZipExtractor::cleanup()
+{
+    mDir.clear();
+}
+
+QString TestZipExtractor::outputDir() const
+{
+    return mDir.filePath("out");
+}
+
+bool TestZipExtractor::writeArchive(const QByteArray &archive, QString *zipFile) const
+{
+    *zipFile = mDir.filePath("update.zip");
+    QFile file(*zipFile);
+    return file.open(QIODevice::WriteOnly) && file.write(archive) == archive.size();
+}
+
+bool TestZipExtractor::extract(const QByteArray &archive, QString *error)
+{
+    QString zipFile;
+    if (!writeArchive(archive, &zipFile))
+        return false;
+
+    ZipExtractor extractor(zipFile);
+    bool ok = extractor.extractAll(outputDir());
+    if (error != nullptr)
+        *error = extractor.errorString();
+    return ok;
+}
+
+QByteArray TestZipExtractor::readOutput(const QString &name) const
+{
+    return TestHelpers::readFile(QDir(outputDir()).filePath(name));
+}
+
+void TestZipExtractor::extractEntries()
+{
+    const QByteArray readme = "LazyDogTools update\n";
+    const QByteArray library = sampleContent(3 * 1024 * 1024 + 17, 1);
+    const QByteArray notes = sampleContent(4096, 2);
+
+    ZipBuilder builder;
+    ZipBuilder::Options stored;
+    stored.method = 0;
+    builder.addFile("readme.txt", readme, stored);
+    builder.addDirectory("plugins/");
+    builder.addFile("bin/LazyDogTools.dll", library);
+    builder.addFile("文档/说明.txt", notes);
+    builder.addFile("empty.txt", QByteArray());
+
+    QString error;
+    QVERIFY2(extract(builder.finish(), &error), qPrintable(error));
+    QCOMPARE(readOutput("readme.txt"), readme);
+    QCOMPARE(readOutput("bin/LazyDogTools.dll"), library);
+    QCOMPARE(readOutput("文档/说明.txt"), notes);
+    QCOMPARE(readOutput("empty.txt"), QByteArray());
+    QVERIFY(QFileInfo(QDir(outputDir()).filePath("plugins")).isDir());
+}
+
+void TestZipExtractor::dataDescriptor()
+{
+    const QByteArray content = sampleContent(100000, 3);
+
+    ZipBuilder builder;
+    ZipBuilder::Options options;
+    options.flags |= FLAG_DATA_DESCRIPTOR;
+    builder.addFile("streamed.bin", content, options);
+    builder.addFile("after.txt", "next entry");
+
+    QString error;
+    QVERIFY2(extract(builder.finish(), &error), qPrintable(error));
+    QCOMPARE(readOutput("streamed.bin"), content);
+    QCOMPARE(readOutput("after.txt"), QByteArray("next entry"));
+}
+
+void TestZipExtractor::archiveComment()
+{
+    ZipBuilder builder;
+    builder.addFile("a.txt", "a");
+    // 注释跟在目录结束记录之后，定位时需从文件末尾向前搜索
+    QByteArray comment = "release notes ";
+    comment.append(QByteArray(1000, 'x'));
+
+    QString error;
+    QVERIFY2(extract(builder.finish(comment), &error), qPrintable(error));
+    QCOMPARE(readOutput("a.txt"), QByteArray("a"));
+}
+
+void TestZipExtractor::rejectsUnsafeNames_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::newRow("parent") << "../evil.txt";
+    QTest::newRow("nested parent") << "bin/../../evil.txt";
+    QTest::newRow("backslash parent") << "bin\\..\\..\\evil.txt";
+    QTest::newRow("absolute") << "/evil.txt";
+    QTest::newRow("drive") << "C:/evil.txt";
+}
+
+void TestZipExtractor::rejectsUnsafeNames()
+{
+    QFETCH(QString, name);
+
+    ZipBuilder builder;
+    builder.addFile("ok.txt", "ok");
+    builder.addFile(name, "evil");
+
+    QString error;
+    QVERIFY(!extract(builder.finish(), &error));
+    QVERIFY2(error.contains(name), qPrintable(error));
+    // 路径在读取中央目录时就被拒绝，任何条目都不会写出
+    QVERIFY(!QFileInfo::exists(QDir(outputDir()).filePath("ok.txt")));
+    QVERIFY(!QFileInfo::exists(mDir.filePath("evil.txt")));
+}
+
+void TestZipExtractor::crcMismatch()
+{
+    ZipBuilder builder;
+    ZipBuilder::Options options;
+    options.badCrc = true;
+    builder.addFile("corrupt.bin", sampleContent(50000, 4), options);
+
+    QString error;
+    QVERIFY(!extract(builder.finish(), &error));
+    QVERIFY2(error.contains("corrupt.bin"), qPrintable(error));
+}
+
+void TestZipExtractor::truncatedEntry()
+{
+    ZipBuilder builder;
+    ZipBuilder::Options options;
+    options.truncate = 16;
+    builder.addFile("short.bin", sampleContent(50000, 5), options);
+
+    QString error;
+    QVERIFY(!extract(builder.finish(), &error));
+    QVERIFY2(error.contains("short.bin"), qPrintable(error));
+}
+
+void TestZipExtractor::truncatedArchive()
+{
+    ZipBuilder builder;
+    builder.addFile("a.txt", sampleContent(50000, 6));
+    QByteArray archive = builder.finish();
+    archive.truncate(archive.size() / 2);
+
+    QString error;
+    QVERIFY(!extract(archive, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestZipExtractor::unsupportedMethod()
+{
+    ZipBuilder builder;
+    ZipBuilder::Options options;
+    options.method = 12;        // bzip2
+    builder.addFile("a.bz2", "BZh9", options);
+
+    QString error;
+    QVERIFY(!extract(builder.finish(), &error));
+    QVERIFY2(error.contains("a.bz2"), qPrintable(error));
+}
+
+// 与更新包相近的形态：几十个大小不一、几乎压不动的文件，按线程池并行解压
+void TestZipExtractor::benchmarkExtract()
+{
+    static const int FILE_COUNT = 64;
+    bool ok = false;
+    int megabytes = qEnvironmentVariableIntValue("ZIP_BENCH_MB", &ok);
+    if (!ok || megabytes <= 0)
+        megabytes = 100;
+
+    // 文件大小按 1~8 份轮换，合计约为指定大小
+    const qint64 unit = qint64(megabytes) * 1024 * 1024 / (FILE_COUNT / 8 * 36);
+    ZipBuilder builder;
+    qint64 total = 0;
+    for (int i = 0; i < FILE_COUNT; ++i)
+    {
+        QByteArray content = binaryContent((i % 8 + 1) * unit, quint32(i));
+        total += content.size();
+        builder.addFile(QString("bin/module%1.dll").arg(i), content);
+    }
+
+    QString zipFile;
+    {
+        const QByteArray archive = builder.finish();
+        qInfo() << "archive:" << archive.size() << "bytes, uncompressed:" << total << "bytes";
+        QVERIFY(writeArchive(archive, &zipFile));
+    }
+
+    // 只计解压本身，压缩包已写入磁盘
+    QElapsedTimer timer;
+    qint64 fastest = 0;
+    QBENCHMARK {
+        timer.start();
+        ZipExtractor extractor(zipFile);
+        QVERIFY2(extractor.extractAll(outputDir()), qPrintable(extractor.errorString()));
+        qint64 nsecs = timer.nsecsElapsed();
+        fastest = fastest == 0 ? nsecs : qMin(fastest, nsecs);
+    }
+    qInfo() << "extract:" << qPrintable(QString::number(total / 1048576.0 / (fastest / 1e9), 'f', 1)) << "MB/s";
+    QCOMPARE(readOutput("bin/module7.dll"), binaryContent(8 * unit, 7));
+}
+
+QTEST_APPLESS_MAIN(TestZipExtractor)
+
+#include "main.moc"
@@ -0,0 +1,17 @@
+QT = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 解压只依赖QtCore与zlib；测试用的压缩包在用例中合成
+INCLUDEPATH += ../.. ../common
+
+include(../../zlib.pri)
+
+SOURCES += \
+    main.cpp \
+    ../../ZipExtractor.cpp
+
+HEADERS += \
+    ../common/TestHelpers.h \
+    ../../ZipExtractor.h
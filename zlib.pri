@@ -0,0 +1,17 @@
+# zlib：日志归档、更新包解压和 logdump 直接调用 zlib 接口。
+# 链接系统提供的 zlib，不使用 Qt 内部的私有头文件 <QtZlib/zlib.h>，Qt 自带的 zlib 不是可供链接的公开目标。
+# Windows 下可通过 ZLIB_DIR（qmake 变量或环境变量）指定 include/lib 所在目录，例如 vcpkg 的 installed/x64-windows。
+unix {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += zlib
+}
+
+win32 {
+    isEmpty(ZLIB_DIR): ZLIB_DIR = $$(ZLIB_DIR)
+    !isEmpty(ZLIB_DIR) {
+        INCLUDEPATH += $$ZLIB_DIR/include
+        LIBS += -L$$ZLIB_DIR/lib
+    }
+    msvc: LIBS += -lzlib
+    else: LIBS += -lz
+}